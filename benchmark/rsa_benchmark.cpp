@@ -0,0 +1,132 @@
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "montgomery.hpp"
+#include "rsa.hpp"
+
+// 2048-bit test key, not used anywhere else
+const auto modulus = BigNumber{ std::vector<unsigned char>{
+        0xB6, 0x15, 0x05, 0x54, 0x2C, 0x1D, 0x76, 0x95, 0x70, 0x30, 0x1B, 0x57,
+        0x8F, 0xF1, 0xE8, 0x7C, 0x28, 0x92, 0x75, 0x9A, 0x98, 0x06, 0x32, 0x54,
+        0xD9, 0xC5, 0xB6, 0x99, 0xBF, 0x86, 0x73, 0x84, 0x96, 0x87, 0x51, 0x57,
+        0x78, 0x4A, 0x75, 0x8C, 0x31, 0x8B, 0x72, 0xFD, 0x2A, 0x06, 0x65, 0x9A,
+        0x41, 0x71, 0xAD, 0xB0, 0x21, 0x4C, 0x7C, 0x5E, 0xBF, 0x36, 0x65, 0x9C,
+        0xE8, 0xE9, 0xB6, 0x0B, 0xCC, 0x8D, 0xEE, 0x34, 0x12, 0x47, 0x36, 0x17,
+        0xC5, 0x5E, 0x88, 0x5E, 0x65, 0xEE, 0xC2, 0x3C, 0xEF, 0x5B, 0x56, 0x7E,
+        0x4C, 0x7B, 0x20, 0xD4, 0xA3, 0x6B, 0x33, 0x2C, 0xF2, 0x72, 0x45, 0x2D,
+        0x30, 0x42, 0x0B, 0x5A, 0x78, 0x89, 0x98, 0xF8, 0x85, 0x07, 0xD9, 0x78,
+        0xA4, 0x8F, 0x6B, 0x20, 0x34, 0xDF, 0xEC, 0x89, 0x99, 0x1A, 0x30, 0x04,
+        0x5F, 0x1F, 0xAC, 0xC4, 0x5A, 0xDA, 0xE7, 0x1F, 0x9F, 0x6C, 0x7E, 0xBE,
+        0x6D, 0xDF, 0x83, 0xAD, 0x9F, 0x76, 0x50, 0x2B, 0x9E, 0x94, 0x50, 0x8B,
+        0x22, 0x4F, 0x9F, 0x8D, 0x01, 0xE6, 0x9C, 0x3B, 0x63, 0x53, 0x07, 0xA4,
+        0x97, 0xD1, 0x52, 0x3C, 0xF1, 0x0F, 0x40, 0xC4, 0x85, 0xDD, 0xDD, 0x30,
+        0x09, 0x2F, 0xB5, 0xAB, 0x11, 0x66, 0x0C, 0x6D, 0xEB, 0xEE, 0x45, 0x40,
+        0x52, 0xA7, 0xC0, 0x1D, 0xFC, 0x18, 0x71, 0x87, 0xC1, 0xF3, 0x98, 0xC6,
+        0x13, 0xB1, 0x31, 0x93, 0xD3, 0x59, 0x3F, 0xAE, 0x27, 0x59, 0x7C, 0x6F,
+        0xF5, 0xE9, 0xD2, 0x12, 0x41, 0x3D, 0xE0, 0xCB, 0x88, 0x6B, 0x99, 0x19,
+        0x8C, 0xD1, 0x35, 0x2C, 0xE6, 0x10, 0x0F, 0x42, 0x30, 0x74, 0x70, 0xAA,
+        0xD6, 0x96, 0x65, 0x53, 0x44, 0x68, 0xC5, 0x90, 0x42, 0x0B, 0x64, 0xC3,
+        0x6E, 0xBB, 0x78, 0x92, 0xFB, 0x98, 0x70, 0x88, 0x1F, 0x7D, 0xBA, 0x61,
+        0x54, 0x01, 0x91, 0x33
+}};
+
+const auto private_exponent = BigNumber{ std::vector<unsigned char>{
+        0x2C, 0xD3, 0x9F, 0x04, 0xBA, 0x79, 0xA4, 0x74, 0xA4, 0xF2, 0x8B, 0x00,
+        0xB3, 0x24, 0xFC, 0xB5, 0xF8, 0x6D, 0x1A, 0x3B, 0xED, 0x9A, 0x74, 0xF0,
+        0xB3, 0xCE, 0x7B, 0xA6, 0x7D, 0x62, 0xF5, 0xF4, 0x99, 0xF4, 0x85, 0x7F,
+        0x91, 0xD3, 0x4E, 0xFE, 0x2D, 0x42, 0x66, 0x14, 0x52, 0xB0, 0xD1, 0x79,
+        0xB9, 0x0B, 0xEA, 0x15, 0x57, 0x15, 0x53, 0xF7, 0x25, 0x7F, 0x18, 0x64,
+        0x19, 0x69, 0x54, 0x52, 0xB2, 0x50, 0xEC, 0xE8, 0x6F, 0xE9, 0x8D, 0x35,
+        0x2B, 0xF7, 0x9A, 0x7E, 0x16, 0xFD, 0x41, 0x5F, 0xAC, 0x13, 0xE2, 0x06,
+        0xE5, 0x00, 0x59, 0x34, 0x50, 0x69, 0x37, 0x67, 0xA4, 0xE6, 0xA2, 0x06,
+        0x3E, 0x7F, 0xBB, 0xF8, 0xD1, 0x7D, 0x1A, 0xA6, 0x70, 0x65, 0xDE, 0xD1,
+        0xD7, 0x3D, 0xA1, 0xC3, 0x83, 0x90, 0xEF, 0x54, 0x6E, 0xD7, 0x66, 0x23,
+        0xE5, 0x61, 0x50, 0x70, 0xE4, 0xE7, 0x48, 0x87, 0xF2, 0xE6, 0x1F, 0xEB,
+        0x5C, 0xAC, 0xDA, 0x85, 0x75, 0x11, 0x7E, 0xC6, 0xCF, 0xE8, 0x73, 0x37,
+        0xC5, 0x9C, 0x93, 0x44, 0xDE, 0xE6, 0x85, 0xEF, 0xE3, 0xDC, 0x20, 0xA8,
+        0xCB, 0x66, 0xEA, 0x74, 0x4D, 0x1C, 0x46, 0xB6, 0xE5, 0x5A, 0xEE, 0x34,
+        0xAA, 0xCA, 0xAD, 0xC1, 0x5E, 0xE7, 0x64, 0x70, 0xE5, 0x02, 0x1B, 0x9F,
+        0x86, 0x94, 0x73, 0x3A, 0xE3, 0x23, 0xDF, 0x77, 0xB0, 0xF8, 0x85, 0x31,
+        0x85, 0x17, 0xE9, 0xDE, 0x07, 0x93, 0x7C, 0x5A, 0xDE, 0xFF, 0x83, 0xA6,
+        0x23, 0xDC, 0x6F, 0x5F, 0x19, 0xC1, 0xCA, 0x17, 0x04, 0x41, 0xA4, 0x5E,
+        0x81, 0x3A, 0xCD, 0x26, 0xED, 0xC6, 0xA5, 0x95, 0xC8, 0xAD, 0x82, 0x08,
+        0x9A, 0xE3, 0x48, 0x19, 0xCA, 0x73, 0xB8, 0xE4, 0x7A, 0xC2, 0x1C, 0x11,
+        0x00, 0xBA, 0xC5, 0x4B, 0xFB, 0x87, 0xC9, 0x8B, 0x6D, 0xF0, 0xA6, 0x18,
+        0xF1, 0xEB, 0x10, 0x15
+}};
+
+const auto public_exponent = BigNumber{ std::vector<unsigned char>{ 0x01, 0x00, 0x01 }};
+
+/**
+ * @return seconds per operation, averaged over at least one second of runtime
+ */
+double measure(const std::function<void()> &operation)
+{
+    using clock = std::chrono::steady_clock;
+    operation();
+    size_t iterations = 0;
+    const auto start = clock::now();
+    auto elapsed = clock::duration::zero();
+    while (elapsed < std::chrono::seconds(1))
+    {
+        operation();
+        ++iterations;
+        elapsed = clock::now() - start;
+    }
+    return std::chrono::duration<double>(elapsed).count() / iterations;
+}
+
+void report(const std::string &name, double seconds, double baseline)
+{
+    std::cout << std::left << std::setw(36) << name
+              << std::right << std::setw(12) << std::fixed << std::setprecision(3) << seconds * 1000
+              << std::setw(12) << std::setprecision(1) << 1 / seconds
+              << std::setw(12) << std::setprecision(3) << seconds / baseline << "x" << std::endl;
+}
+
+int main()
+{
+    const auto message = BigNumber{ std::vector<unsigned char>(255, 0x5A) };
+    const RsaPublicKey public_key{ modulus, public_exponent };
+    const auto cypher = public_key.compute(message);
+    const MontgomeryContext montgomery{ modulus };
+    const auto exponent_limbs = to_limbs(private_exponent, montgomery.size());
+
+    const auto setup_start = std::chrono::steady_clock::now();
+    const RsaPrivateKey private_key{ modulus, private_exponent, public_exponent };
+    const auto setup = std::chrono::duration<double>(std::chrono::steady_clock::now() - setup_start).count();
+
+    const auto variable_time = measure([&]()
+    {
+        (void) montgomery.power_modulus(cypher, private_exponent);
+    });
+    const auto fixed_window = measure([&]()
+    {
+        Limbs result{};
+        montgomery.power_modulus_fixed_window(montgomery.to_montgomery(cypher), exponent_limbs, result);
+        (void) montgomery.from_montgomery(result);
+    });
+    const auto blinded = measure([&]()
+    {
+        (void) private_key.compute(cypher);
+    });
+    const auto public_operation = measure([&]()
+    {
+        (void) public_key.compute(message);
+    });
+
+    std::cout << "RSA-2048, private key setup (blinding pair): " << std::fixed << std::setprecision(3)
+              << setup * 1000 << " ms" << std::endl;
+    std::cout << std::left << std::setw(36) << "operation"
+              << std::right << std::setw(12) << "ms/op" << std::setw(12) << "ops/s" << std::setw(13) << "relative"
+              << std::endl;
+    report("public, e=65537", public_operation, variable_time);
+    report("private, variable time", variable_time, variable_time);
+    report("private, fixed window", fixed_window, variable_time);
+    report("private, blinded fixed window", blinded, variable_time);
+    return 0;
+}
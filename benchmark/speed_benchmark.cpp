@@ -0,0 +1,454 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <latch>
+#include <memory>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "aes.hpp"
+#include "cipher_suite.hpp"
+#include "cpu_features.hpp"
+#include "des.hpp"
+#include "gcm.hpp"
+#include "hmac.hpp"
+#include "md5.hpp"
+#include "sha.hpp"
+#include "tls_record_mac.hpp"
+
+#if TLS_PLAYGROUND_X86
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#endif
+
+/**
+ * Buffer sizes of openssl speed, so numbers can be put next to it.
+ */
+const std::array<size_t, 6> buffer_sizes{ 16, 64, 256, 1024, 8192, 16384 };
+
+/**
+ * Runs one iteration over its own buffer, every thread gets a separate operation.
+ */
+using Operation = std::function<void()>;
+
+struct Primitive
+{
+    std::string name;
+    std::function<Operation(size_t size)> make_operation;
+    /**
+     * Buffers of the measured size processed by one operation.
+     */
+    size_t batch = 1;
+};
+
+struct Measurement
+{
+    double megabytes_per_second;
+    double cycles_per_byte;
+};
+
+struct Options
+{
+    double seconds = 0.2;
+    size_t threads = std::max(1u, std::thread::hardware_concurrency());
+    bool csv = false;
+    std::vector<std::string> algorithms;
+};
+
+/**
+ * Time stamp counter ticks at the nominal frequency, not the boosted one, but it is the same clock
+ * for every build and backend, which is what comparisons need.
+ */
+uint64_t read_cycle_counter()
+{
+#if TLS_PLAYGROUND_X86
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+const std::array<unsigned char, 24> triple_des_key{ 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18,
+                                                    19, 20, 21, 22, 23, 24 };
+
+const size_t hash_batch = 64;
+
+std::vector<unsigned char> make_buffer(size_t size)
+{
+    std::vector<unsigned char> result(size);
+    for (size_t i = 0; i < size; ++i)
+    {
+        result[i] = (i * 7 + 1) & 0xFF;
+    }
+    return result;
+}
+
+template<size_t bits>
+Primitive aes_cbc_primitive(const std::string &name)
+{
+    return { name, [](size_t size) -> Operation
+    {
+        const auto key = std::make_shared<AesKey<bits>>(std::array<unsigned char, bits / 8>{ 1, 2, 3, 4 });
+        return [key, buffer = make_buffer(size)]() mutable
+        {
+            aes_cbc_encrypt(std::span(buffer), std::span(buffer), std::array<unsigned char, 16>{}, *key);
+        };
+    }};
+}
+
+std::vector<Primitive> primitives()
+{
+    const std::vector<unsigned char> mac_key(32, 0x0b);
+    return {
+            aes_cbc_primitive<128>("aes-128-cbc"),
+            aes_cbc_primitive<192>("aes-192-cbc"),
+            aes_cbc_primitive<256>("aes-256-cbc"),
+            // decrypt, CTR and GCM process independent blocks, the only paths the bitsliced backend speeds up
+            { "aes-128-cbc-decrypt", [](size_t size) -> Operation
+            {
+                const auto key = std::make_shared<AesKey<128>>(std::array<unsigned char, 16>{ 1, 2, 3, 4 });
+                return [key, buffer = make_buffer(size)]() mutable
+                {
+                    aes_cbc_decrypt(std::span(buffer), std::span(buffer), std::array<unsigned char, 16>{}, *key);
+                };
+            }},
+            { "aes-128-ctr", [](size_t size) -> Operation
+            {
+                const auto key = std::make_shared<AesKey<128>>(std::array<unsigned char, 16>{ 1, 2, 3, 4 });
+                return [key, buffer = make_buffer(size)]() mutable
+                {
+                    aes_ctr_crypt(std::span(buffer), std::span(buffer), std::array<unsigned char, 16>{}, *key);
+                };
+            }},
+            { "aes-128-gcm", [](size_t size) -> Operation
+            {
+                const auto gcm = std::make_shared<AesGcm<128>>(std::array<unsigned char, 16>{ 1, 2, 3, 4 });
+                return [gcm, buffer = make_buffer(size)]()
+                {
+                    (void) gcm->encrypt(buffer, std::array<unsigned char, 12>{}, {});
+                };
+            }},
+            { "des-cbc", [](size_t size) -> Operation
+            {
+                const auto key = std::make_shared<DesKey>(std::array<unsigned char, 8>{ 1, 2, 3, 4, 5, 6, 7, 8 });
+                return [key, buffer = make_buffer(size)]() mutable
+                {
+                    des_cbc_encrypt(std::span(buffer), std::span(buffer), *key, {});
+                };
+            }},
+            { "des-ede3-cbc", [](size_t size) -> Operation
+            {
+                const auto key = std::make_shared<TripleDesKey>(triple_des_key);
+                return [key, buffer = make_buffer(size)]() mutable
+                {
+                    des3_cbc_encrypt(std::span(buffer), std::span(buffer), *key, {});
+                };
+            }},
+            { "des-ede3-ecb-bitsliced", [](size_t size) -> Operation
+            {
+                const auto key = std::make_shared<TripleDesKey>(triple_des_key);
+                return [key, buffer = make_buffer(size)]() mutable
+                {
+                    des3_ecb_encrypt_bitsliced(std::span(buffer), std::span(buffer), *key);
+                };
+            }},
+            { "md5", [](size_t size) -> Operation
+            {
+                return [buffer = make_buffer(size)]()
+                {
+                    (void) md5_hash(buffer);
+                };
+            }},
+            { "sha1", [](size_t size) -> Operation
+            {
+                return [buffer = make_buffer(size)]()
+                {
+                    Sha1Hashing hashing;
+                    hashing.append(buffer);
+                    (void) hashing.close();
+                };
+            }},
+            { "sha256", [](size_t size) -> Operation
+            {
+                return [buffer = make_buffer(size)]()
+                {
+                    (void) sha256_hash(buffer);
+                };
+            }},
+            { "sha512", [](size_t size) -> Operation
+            {
+                return [buffer = make_buffer(size)]()
+                {
+                    (void) sha512_hash(buffer);
+                };
+            }},
+            // independent messages of the measured size in SIMD lanes
+            { "md5-many", [](size_t size) -> Operation
+            {
+                return [buffers = std::vector<std::vector<unsigned char>>(hash_batch, make_buffer(size))]()
+                {
+                    const std::vector<std::span<const unsigned char>> messages(buffers.begin(), buffers.end());
+                    (void) md5_hash_many(messages);
+                };
+            }, hash_batch },
+            { "sha256-many", [](size_t size) -> Operation
+            {
+                return [buffers = std::vector<std::vector<unsigned char>>(hash_batch, make_buffer(size))]()
+                {
+                    const std::vector<std::span<const unsigned char>> messages(buffers.begin(), buffers.end());
+                    (void) sha256_hash_many(messages);
+                };
+            }, hash_batch },
+            // keyed once, like the record layer
+            { "hmac-md5", [mac_key](size_t size) -> Operation
+            {
+                return [hmac = std::make_shared<HmacMd5>(mac_key), buffer = make_buffer(size)]()
+                {
+                    hmac->update(buffer);
+                    (void) hmac->final();
+                };
+            }},
+            { "hmac-sha1", [mac_key](size_t size) -> Operation
+            {
+                return [hmac = std::make_shared<HmacSha1>(mac_key), buffer = make_buffer(size)]()
+                {
+                    hmac->update(buffer);
+                    (void) hmac->final();
+                };
+            }},
+            { "hmac-sha256", [mac_key](size_t size) -> Operation
+            {
+                return [hmac = std::make_shared<HmacSha256>(mac_key), buffer = make_buffer(size)]()
+                {
+                    hmac->update(buffer);
+                    (void) hmac->final();
+                };
+            }},
+            // record layer as the client sends application data: MAC, pad, encrypt
+            { "tls-aes-128-cbc-sha", [mac_key](size_t size) -> Operation
+            {
+                auto suite = std::make_shared<Aes128CipherSuite>(std::array<unsigned char, 16>{},
+                        std::array<unsigned char, 16>{ 1, 2, 3, 4 });
+                auto mac = std::make_shared<TlsRecordMac>(std::vector<unsigned char>(20, 0x0b));
+                return [suite, mac, buffer = make_buffer(size)]()
+                {
+                    TlsRecord record{ TlsRecordType::ApplicationData, tls1_0_version, buffer };
+                    mac->append_mac(record);
+                    suite->encrypt(record);
+                };
+            }},
+    };
+}
+
+/**
+ * Every thread runs its own operation until stopped, so multi-threaded numbers are aggregate throughput
+ * and cycles are summed over threads.
+ */
+Measurement measure(const Primitive &primitive, size_t size, size_t threads, double seconds)
+{
+    std::vector<size_t> iterations(threads);
+    std::vector<double> elapsed(threads);
+    std::vector<uint64_t> cycles(threads);
+    std::latch ready(static_cast<std::ptrdiff_t>(threads + 1));
+    {
+        std::vector<std::jthread> workers;
+        for (size_t thread = 0; thread < threads; ++thread)
+        {
+            workers.emplace_back([&, thread](std::stop_token stop)
+            {
+                auto operation = primitive.make_operation(size);
+                operation();
+                ready.arrive_and_wait();
+                const auto start = std::chrono::steady_clock::now();
+                const auto start_cycles = read_cycle_counter();
+                size_t count = 0;
+                while (!stop.stop_requested())
+                {
+                    operation();
+                    ++count;
+                }
+                cycles[thread] = read_cycle_counter() - start_cycles;
+                elapsed[thread] = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                iterations[thread] = count;
+            });
+        }
+        ready.arrive_and_wait();
+        std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+        for (auto &worker: workers)
+        {
+            worker.request_stop();
+        }
+    }
+    Measurement result{};
+    double total_bytes = 0;
+    uint64_t total_cycles = 0;
+    for (size_t thread = 0; thread < threads; ++thread)
+    {
+        const auto bytes = static_cast<double>(iterations[thread]) * size * primitive.batch;
+        result.megabytes_per_second += bytes / elapsed[thread] / 1e6;
+        total_bytes += bytes;
+        total_cycles += cycles[thread];
+    }
+    result.cycles_per_byte = total_bytes > 0 ? total_cycles / total_bytes : 0;
+    return result;
+}
+
+std::string backend_name()
+{
+    if (cpu_features().aes)
+    {
+        return "aes-ni";
+    }
+    return aes_fallback() == AesFallback::Bitsliced ? "bitsliced" : "table";
+}
+
+std::string sha_backend_name()
+{
+    return cpu_features().sha ? "sha-ni" : "portable";
+}
+
+void print_table(const std::string &title, const std::vector<std::string> &names,
+        const std::vector<std::vector<Measurement>> &results, double Measurement::*field)
+{
+    std::cout << title << std::endl;
+    std::cout << std::left << std::setw(22) << "type" << std::right;
+    for (const auto size: buffer_sizes)
+    {
+        std::cout << std::setw(13) << std::to_string(size) + " bytes";
+    }
+    std::cout << std::endl;
+    for (size_t i = 0; i < names.size(); ++i)
+    {
+        std::cout << std::left << std::setw(22) << names[i] << std::right;
+        for (const auto &measurement: results[i])
+        {
+            std::cout << std::setw(13) << std::fixed << std::setprecision(2) << measurement.*field;
+        }
+        std::cout << std::endl;
+    }
+}
+
+void print_usage()
+{
+    std::cerr << "usage: tls-speed [--seconds S] [--threads N] [--portable] [--bitsliced] [--csv] [algorithm...]"
+              << std::endl;
+}
+
+bool parse_options(int argc, char *argv[], Options &options)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string argument = argv[i];
+        if (argument == "--seconds" && i + 1 < argc)
+        {
+            options.seconds = std::atof(argv[++i]);
+        }
+        else if (argument == "--threads" && i + 1 < argc)
+        {
+            options.threads = std::max(1, std::atoi(argv[++i]));
+        }
+        else if (argument == "--portable")
+        {
+            cpu_features().aes = false;
+            cpu_features().pclmul = false;
+            cpu_features().sha = false;
+        }
+        else if (argument == "--bitsliced")
+        {
+            aes_fallback() = AesFallback::Bitsliced;
+        }
+        else if (argument == "--csv")
+        {
+            options.csv = true;
+        }
+        else if (argument.starts_with("-"))
+        {
+            return false;
+        }
+        else
+        {
+            options.algorithms.push_back(argument);
+        }
+    }
+    return options.seconds > 0;
+}
+
+int main(int argc, char *argv[])
+{
+    Options options;
+    if (!parse_options(argc, argv, options))
+    {
+        print_usage();
+        return 1;
+    }
+    std::vector<Primitive> selected;
+    for (auto &primitive: primitives())
+    {
+        if (options.algorithms.empty() || std::ranges::find(options.algorithms, primitive.name)
+                                          != options.algorithms.end())
+        {
+            selected.push_back(std::move(primitive));
+        }
+    }
+    if (selected.empty())
+    {
+        print_usage();
+        return 1;
+    }
+    std::vector<size_t> thread_counts{ 1 };
+    if (options.threads > 1)
+    {
+        thread_counts.push_back(options.threads);
+    }
+
+    const auto backend = backend_name();
+    if (options.csv)
+    {
+        std::cout << "backend,algorithm,threads,bytes,megabytes_per_second,cycles_per_byte" << std::endl;
+    }
+    else
+    {
+        std::cout << "tls-speed, aes backend: " << backend << ", sha backend: " << sha_backend_name() << ", "
+                  << options.seconds << " s per measurement" << std::endl;
+    }
+    for (const auto threads: thread_counts)
+    {
+        std::vector<std::string> names;
+        std::vector<std::vector<Measurement>> results;
+        for (const auto &primitive: selected)
+        {
+            names.push_back(primitive.name);
+            auto &row = results.emplace_back();
+            for (const auto size: buffer_sizes)
+            {
+                row.push_back(measure(primitive, size, threads, options.seconds));
+                if (options.csv)
+                {
+                    std::cout << backend << "," << primitive.name << "," << threads << "," << size << ","
+                              << std::fixed << std::setprecision(2) << row.back().megabytes_per_second << ","
+                              << row.back().cycles_per_byte << std::endl;
+                }
+            }
+        }
+        if (!options.csv)
+        {
+            const auto suffix = ", " + std::to_string(threads) + (threads == 1 ? " thread" : " threads");
+            std::cout << std::endl;
+            print_table("MB/s (10^6 bytes per second)" + suffix, names, results, &Measurement::megabytes_per_second);
+            std::cout << std::endl;
+            print_table("cycles/byte (time stamp counter, summed over threads)" + suffix, names, results,
+                    &Measurement::cycles_per_byte);
+        }
+    }
+    return 0;
+}
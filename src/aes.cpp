@@ -1,425 +1,720 @@
 #include <algorithm>
 #include <array>
 #include <cstddef>
+#include <cstdint>
 #include <stdexcept>
+#include <thread>
 #include <vector>
 
+#include "aes_bitsliced.hpp"
+#include "aes_ni.hpp"
+#include "cpu_features.hpp"
+
 #include "aes.hpp"
 
-using State = std::array<std::array<unsigned char, 4>, 4>;
-
-const std::array<std::array<unsigned char, 16>, 16> sbox
-        {{
-                 { 0x63, 0x7c, 0x77, 0x7b, 0xf2, 0x6b, 0x6f, 0xc5,
-                   0x30, 0x01, 0x67, 0x2b, 0xfe, 0xd7, 0xab, 0x76 },
-                 { 0xca, 0x82, 0xc9, 0x7d, 0xfa, 0x59, 0x47, 0xf0,
-                   0xad, 0xd4, 0xa2, 0xaf, 0x9c, 0xa4, 0x72, 0xc0 },
-                 { 0xb7, 0xfd, 0x93, 0x26, 0x36, 0x3f, 0xf7, 0xcc,
-                   0x34, 0xa5, 0xe5, 0xf1, 0x71, 0xd8, 0x31, 0x15 },
-                 { 0x04, 0xc7, 0x23, 0xc3, 0x18, 0x96, 0x05, 0x9a,
-                   0x07, 0x12, 0x80, 0xe2, 0xeb, 0x27, 0xb2, 0x75 },
-                 { 0x09, 0x83, 0x2c, 0x1a, 0x1b, 0x6e, 0x5a, 0xa0,
-                   0x52, 0x3b, 0xd6, 0xb3, 0x29, 0xe3, 0x2f, 0x84 },
-                 { 0x53, 0xd1, 0x00, 0xed, 0x20, 0xfc, 0xb1, 0x5b,
-                   0x6a, 0xcb, 0xbe, 0x39, 0x4a, 0x4c, 0x58, 0xcf },
-                 { 0xd0, 0xef, 0xaa, 0xfb, 0x43, 0x4d, 0x33, 0x85,
-                   0x45, 0xf9, 0x02, 0x7f, 0x50, 0x3c, 0x9f, 0xa8 },
-                 { 0x51, 0xa3, 0x40, 0x8f, 0x92, 0x9d, 0x38, 0xf5,
-                   0xbc, 0xb6, 0xda, 0x21, 0x10, 0xff, 0xf3, 0xd2 },
-                 { 0xcd, 0x0c, 0x13, 0xec, 0x5f, 0x97, 0x44, 0x17,
-                   0xc4, 0xa7, 0x7e, 0x3d, 0x64, 0x5d, 0x19, 0x73 },
-                 { 0x60, 0x81, 0x4f, 0xdc, 0x22, 0x2a, 0x90, 0x88,
-                   0x46, 0xee, 0xb8, 0x14, 0xde, 0x5e, 0x0b, 0xdb },
-                 { 0xe0, 0x32, 0x3a, 0x0a, 0x49, 0x06, 0x24, 0x5c,
-                   0xc2, 0xd3, 0xac, 0x62, 0x91, 0x95, 0xe4, 0x79 },
-                 { 0xe7, 0xc8, 0x37, 0x6d, 0x8d, 0xd5, 0x4e, 0xa9,
-                   0x6c, 0x56, 0xf4, 0xea, 0x65, 0x7a, 0xae, 0x08 },
-                 { 0xba, 0x78, 0x25, 0x2e, 0x1c, 0xa6, 0xb4, 0xc6,
-                   0xe8, 0xdd, 0x74, 0x1f, 0x4b, 0xbd, 0x8b, 0x8a },
-                 { 0x70, 0x3e, 0xb5, 0x66, 0x48, 0x03, 0xf6, 0x0e,
-                   0x61, 0x35, 0x57, 0xb9, 0x86, 0xc1, 0x1d, 0x9e },
-                 { 0xe1, 0xf8, 0x98, 0x11, 0x69, 0xd9, 0x8e, 0x94,
-                   0x9b, 0x1e, 0x87, 0xe9, 0xce, 0x55, 0x28, 0xdf },
-                 { 0x8c, 0xa1, 0x89, 0x0d, 0xbf, 0xe6, 0x42, 0x68,
-                   0x41, 0x99, 0x2d, 0x0f, 0xb0, 0x54, 0xbb, 0x16 },
-         }};
-
-const std::array<std::array<unsigned char, 16>, 16> decrypt_sbox
-        {{
-                 { 0x52, 0x09, 0x6a, 0xd5, 0x30, 0x36, 0xa5, 0x38,
-                   0xbf, 0x40, 0xa3, 0x9e, 0x81, 0xf3, 0xd7, 0xfb },
-                 { 0x7c, 0xe3, 0x39, 0x82, 0x9b, 0x2f, 0xff, 0x87,
-                   0x34, 0x8e, 0x43, 0x44, 0xc4, 0xde, 0xe9, 0xcb },
-                 { 0x54, 0x7b, 0x94, 0x32, 0xa6, 0xc2, 0x23, 0x3d,
-                   0xee, 0x4c, 0x95, 0x0b, 0x42, 0xfa, 0xc3, 0x4e },
-                 { 0x08, 0x2e, 0xa1, 0x66, 0x28, 0xd9, 0x24, 0xb2,
-                   0x76, 0x5b, 0xa2, 0x49, 0x6d, 0x8b, 0xd1, 0x25 },
-                 { 0x72, 0xf8, 0xf6, 0x64, 0x86, 0x68, 0x98, 0x16,
-                   0xd4, 0xa4, 0x5c, 0xcc, 0x5d, 0x65, 0xb6, 0x92 },
-                 { 0x6c, 0x70, 0x48, 0x50, 0xfd, 0xed, 0xb9, 0xda,
-                   0x5e, 0x15, 0x46, 0x57, 0xa7, 0x8d, 0x9d, 0x84 },
-                 { 0x90, 0xd8, 0xab, 0x00, 0x8c, 0xbc, 0xd3, 0x0a,
-                   0xf7, 0xe4, 0x58, 0x05, 0xb8, 0xb3, 0x45, 0x06 },
-                 { 0xd0, 0x2c, 0x1e, 0x8f, 0xca, 0x3f, 0x0f, 0x02,
-                   0xc1, 0xaf, 0xbd, 0x03, 0x01, 0x13, 0x8a, 0x6b },
-                 { 0x3a, 0x91, 0x11, 0x41, 0x4f, 0x67, 0xdc, 0xea,
-                   0x97, 0xf2, 0xcf, 0xce, 0xf0, 0xb4, 0xe6, 0x73 },
-                 { 0x96, 0xac, 0x74, 0x22, 0xe7, 0xad, 0x35, 0x85,
-                   0xe2, 0xf9, 0x37, 0xe8, 0x1c, 0x75, 0xdf, 0x6e },
-                 { 0x47, 0xf1, 0x1a, 0x71, 0x1d, 0x29, 0xc5, 0x89,
-                   0x6f, 0xb7, 0x62, 0x0e, 0xaa, 0x18, 0xbe, 0x1b },
-                 { 0xfc, 0x56, 0x3e, 0x4b, 0xc6, 0xd2, 0x79, 0x20,
-                   0x9a, 0xdb, 0xc0, 0xfe, 0x78, 0xcd, 0x5a, 0xf4 },
-                 { 0x1f, 0xdd, 0xa8, 0x33, 0x88, 0x07, 0xc7, 0x31,
-                   0xb1, 0x12, 0x10, 0x59, 0x27, 0x80, 0xec, 0x5f },
-                 { 0x60, 0x51, 0x7f, 0xa9, 0x19, 0xb5, 0x4a, 0x0d,
-                   0x2d, 0xe5, 0x7a, 0x9f, 0x93, 0xc9, 0x9c, 0xef },
-                 { 0xa0, 0xe0, 0x3b, 0x4d, 0xae, 0x2a, 0xf5, 0xb0,
-                   0xc8, 0xeb, 0xbb, 0x3c, 0x83, 0x53, 0x99, 0x61 },
-                 { 0x17, 0x2b, 0x04, 0x7e, 0xba, 0x77, 0xd6, 0x26,
-                   0xe1, 0x69, 0x14, 0x63, 0x55, 0x21, 0x0c, 0x7d }
-         }};
-
-
-void substitute_state(State &state)
-{
-    for (size_t i = 0; i < state.size(); ++i)
-    {
-        for (size_t j = 0; j < state.at(i).size(); ++j)
-        {
-            state.at(i).at(j) = sbox.at((state.at(i).at(j) & 0xF0) >> 4).at(state.at(i).at(j) & 0x0F);
-        }
+constexpr std::array<unsigned char, 256> sbox{
+        0x63, 0x7c, 0x77, 0x7b, 0xf2, 0x6b, 0x6f, 0xc5, 0x30, 0x01, 0x67, 0x2b, 0xfe, 0xd7, 0xab, 0x76,
+        0xca, 0x82, 0xc9, 0x7d, 0xfa, 0x59, 0x47, 0xf0, 0xad, 0xd4, 0xa2, 0xaf, 0x9c, 0xa4, 0x72, 0xc0,
+        0xb7, 0xfd, 0x93, 0x26, 0x36, 0x3f, 0xf7, 0xcc, 0x34, 0xa5, 0xe5, 0xf1, 0x71, 0xd8, 0x31, 0x15,
+        0x04, 0xc7, 0x23, 0xc3, 0x18, 0x96, 0x05, 0x9a, 0x07, 0x12, 0x80, 0xe2, 0xeb, 0x27, 0xb2, 0x75,
+        0x09, 0x83, 0x2c, 0x1a, 0x1b, 0x6e, 0x5a, 0xa0, 0x52, 0x3b, 0xd6, 0xb3, 0x29, 0xe3, 0x2f, 0x84,
+        0x53, 0xd1, 0x00, 0xed, 0x20, 0xfc, 0xb1, 0x5b, 0x6a, 0xcb, 0xbe, 0x39, 0x4a, 0x4c, 0x58, 0xcf,
+        0xd0, 0xef, 0xaa, 0xfb, 0x43, 0x4d, 0x33, 0x85, 0x45, 0xf9, 0x02, 0x7f, 0x50, 0x3c, 0x9f, 0xa8,
+        0x51, 0xa3, 0x40, 0x8f, 0x92, 0x9d, 0x38, 0xf5, 0xbc, 0xb6, 0xda, 0x21, 0x10, 0xff, 0xf3, 0xd2,
+        0xcd, 0x0c, 0x13, 0xec, 0x5f, 0x97, 0x44, 0x17, 0xc4, 0xa7, 0x7e, 0x3d, 0x64, 0x5d, 0x19, 0x73,
+        0x60, 0x81, 0x4f, 0xdc, 0x22, 0x2a, 0x90, 0x88, 0x46, 0xee, 0xb8, 0x14, 0xde, 0x5e, 0x0b, 0xdb,
+        0xe0, 0x32, 0x3a, 0x0a, 0x49, 0x06, 0x24, 0x5c, 0xc2, 0xd3, 0xac, 0x62, 0x91, 0x95, 0xe4, 0x79,
+        0xe7, 0xc8, 0x37, 0x6d, 0x8d, 0xd5, 0x4e, 0xa9, 0x6c, 0x56, 0xf4, 0xea, 0x65, 0x7a, 0xae, 0x08,
+        0xba, 0x78, 0x25, 0x2e, 0x1c, 0xa6, 0xb4, 0xc6, 0xe8, 0xdd, 0x74, 0x1f, 0x4b, 0xbd, 0x8b, 0x8a,
+        0x70, 0x3e, 0xb5, 0x66, 0x48, 0x03, 0xf6, 0x0e, 0x61, 0x35, 0x57, 0xb9, 0x86, 0xc1, 0x1d, 0x9e,
+        0xe1, 0xf8, 0x98, 0x11, 0x69, 0xd9, 0x8e, 0x94, 0x9b, 0x1e, 0x87, 0xe9, 0xce, 0x55, 0x28, 0xdf,
+        0x8c, 0xa1, 0x89, 0x0d, 0xbf, 0xe6, 0x42, 0x68, 0x41, 0x99, 0x2d, 0x0f, 0xb0, 0x54, 0xbb, 0x16
+};
+
+consteval std::array<unsigned char, 256> compute_inverse_sbox()
+{
+    std::array<unsigned char, 256> result{};
+    for (size_t i = 0; i < sbox.size(); ++i)
+    {
+        result[sbox[i]] = static_cast<unsigned char>(i);
     }
+    return result;
 }
 
-void unsubstitute_state(State &state)
+constexpr std::array<unsigned char, 256> inverse_sbox = compute_inverse_sbox();
+
+/**
+ * Multiplication in GF(2^8) modulo x^8 + x^4 + x^3 + x + 1.
+ */
+constexpr unsigned char multiply(unsigned char left, unsigned char right)
 {
-    for (size_t i = 0; i < state.size(); ++i)
+    unsigned char result{};
+    for (; right != 0; right >>= 1)
     {
-        for (size_t j = 0; j < state.at(i).size(); ++j)
+        if ((right & 1) != 0)
         {
-            state.at(i).at(j) = decrypt_sbox.at((state.at(i).at(j) & 0xF0) >> 4).at(state.at(i).at(j) & 0x0F);
+            result ^= left;
         }
+        left = static_cast<unsigned char>((left << 1) ^ ((left & 0x80) != 0 ? 0x1b : 0));
+    }
+    return result;
+}
+
+constexpr uint32_t rotate_left(uint32_t value, int shift)
+{
+    return value << shift | value >> (32 - shift);
+}
+
+using RoundTables = std::array<std::array<uint32_t, 256>, 4>;
+
+/**
+ * State columns are little endian words, row 0 in the lowest byte.
+ * Table 0 maps a row 0 byte to its substituted and mixed column, tables 1-3 are the same column rotated to rows 1-3,
+ * so a full round is 16 lookups and 16 xors.
+ */
+consteval RoundTables compute_round_tables(const std::array<unsigned char, 256> &box,
+        const std::array<unsigned char, 4> &mix_column)
+{
+    RoundTables result{};
+    for (size_t i = 0; i < 256; ++i)
+    {
+        const auto value = box[i];
+        const uint32_t word = multiply(mix_column[0], value)
+                              | static_cast<uint32_t>(multiply(mix_column[1], value)) << 8
+                              | static_cast<uint32_t>(multiply(mix_column[2], value)) << 16
+                              | static_cast<uint32_t>(multiply(mix_column[3], value)) << 24;
+        result[0][i] = word;
+        result[1][i] = rotate_left(word, 8);
+        result[2][i] = rotate_left(word, 16);
+        result[3][i] = rotate_left(word, 24);
     }
+    return result;
+}
+
+alignas(64) constexpr RoundTables encrypt_tables = compute_round_tables(sbox, { 0x02, 0x01, 0x01, 0x03 });
+alignas(64) constexpr RoundTables decrypt_tables = compute_round_tables(inverse_sbox, { 0x0e, 0x09, 0x0d, 0x0b });
+
+template<size_t rounds>
+using ScheduleKey = std::array<uint32_t, 4 * (rounds + 1)>;
+
+inline uint32_t load_column(const unsigned char *bytes)
+{
+    return bytes[0]
+           | static_cast<uint32_t>(bytes[1]) << 8
+           | static_cast<uint32_t>(bytes[2]) << 16
+           | static_cast<uint32_t>(bytes[3]) << 24;
+}
+
+inline void store_column(uint32_t word, unsigned char *bytes)
+{
+    bytes[0] = word & 0xFF;
+    bytes[1] = (word >> 8) & 0xFF;
+    bytes[2] = (word >> 16) & 0xFF;
+    bytes[3] = word >> 24;
+}
+
+/**
+ * Substitute every byte of the word: row 0 from first, row 1 from second, etc.
+ */
+inline uint32_t substitute_column(const std::array<unsigned char, 256> &box,
+        uint32_t first, uint32_t second, uint32_t third, uint32_t fourth)
+{
+    return box[first & 0xFF]
+           | static_cast<uint32_t>(box[(second >> 8) & 0xFF]) << 8
+           | static_cast<uint32_t>(box[(third >> 16) & 0xFF]) << 16
+           | static_cast<uint32_t>(box[fourth >> 24]) << 24;
 }
 
 template<size_t key_length, size_t rounds = key_length / 4 + 6>
-std::array<State, rounds + 1> build_schedule_key(const std::array<unsigned char, key_length> &key)
+ScheduleKey<rounds> build_schedule_key(const std::array<unsigned char, key_length> &key)
 {
-    std::array<std::array<unsigned char, 4>, (rounds + 1) * 4> buffer{};
-    for (size_t i = 0; i < key_length; i += 4)
+    constexpr size_t key_words = key_length / 4;
+    ScheduleKey<rounds> result{};
+    for (size_t i = 0; i < key_words; ++i)
     {
-        buffer.at(i / 4) = { key[i], key[i + 1], key[i + 2], key[i + 3] };
+        result[i] = load_column(key.data() + 4 * i);
     }
-    unsigned char xor_constant = 0x01;
-    for (size_t i = key_length / 4; i < buffer.size(); ++i)
+    unsigned char round_constant = 0x01;
+    for (size_t i = key_words; i < result.size(); ++i)
     {
-        buffer[i] = buffer[i - 1];
-        if (i % (key_length / 4) == 0)
+        auto word = result[i - 1];
+        if (i % key_words == 0)
         {
-            std::swap(buffer[i][0], buffer[i][1]);
-            std::swap(buffer[i][1], buffer[i][2]);
-            std::swap(buffer[i][2], buffer[i][3]);
-            for (auto &item: buffer[i])
-            {
-                item = sbox.at((item & 0xF0) >> 4).at(item & 0x0F);
-            }
-            buffer[i][0] ^= xor_constant;
-            xor_constant <<= 1;
-            if (xor_constant == 0)
-            {
-                xor_constant = 0x1b;
-            }
+            // RotWord moves row 1 to row 0, which is right rotation for little endian column
+            word = word >> 8 | word << 24;
+            word = substitute_column(sbox, word, word, word, word) ^ round_constant;
+            round_constant = multiply(round_constant, 0x02);
         }
-        else if (key_length == 32 && i % 4 == 0)
+        else if (key_words > 6 && i % key_words == 4)
         {
-            for (auto &item: buffer[i])
-            {
-                item = sbox.at((item & 0xF0) >> 4).at(item & 0x0F);
-            }
+            word = substitute_column(sbox, word, word, word, word);
         }
-        buffer[i][0] ^= buffer[i - key_length / 4][0];
-        buffer[i][1] ^= buffer[i - key_length / 4][1];
-        buffer[i][2] ^= buffer[i - key_length / 4][2];
-        buffer[i][3] ^= buffer[i - key_length / 4][3];
-    }
-    std::array<State, rounds + 1> result{};
-    for (size_t i = 0; i < result.size(); ++i)
-    {
-        result.at(i).at(0) = buffer.at(i * 4);
-        result.at(i).at(1) = buffer.at(i * 4 + 1);
-        result.at(i).at(2) = buffer.at(i * 4 + 2);
-        result.at(i).at(3) = buffer.at(i * 4 + 3);
+        result[i] = result[i - key_words] ^ word;
     }
     return result;
 }
 
-void xor_state(State &state, const State &other)
+/**
+ * Schedule for the equivalent inverse cipher: round keys in reverse order, inner ones passed through InvMixColumns,
+ * so decryption rounds have the same shape as encryption rounds.
+ */
+template<size_t rounds>
+ScheduleKey<rounds> build_decrypt_schedule_key(const ScheduleKey<rounds> &encrypt_key)
 {
-    for (size_t i = 0; i < state.size(); ++i)
+    ScheduleKey<rounds> result{};
+    for (size_t round = 0; round <= rounds; ++round)
     {
-        for (size_t j = 0; j < state.at(i).size(); ++j)
+        for (size_t i = 0; i < 4; ++i)
         {
-            state.at(i).at(j) ^= other.at(i).at(j);
+            const auto word = encrypt_key[4 * (rounds - round) + i];
+            if (round == 0 || round == rounds)
+            {
+                result[4 * round + i] = word;
+                continue;
+            }
+            // decrypt tables apply inverse sbox first, so feed them sbox values to get plain InvMixColumns
+            result[4 * round + i] = decrypt_tables[0][sbox[word & 0xFF]]
+                                    ^ decrypt_tables[1][sbox[(word >> 8) & 0xFF]]
+                                    ^ decrypt_tables[2][sbox[(word >> 16) & 0xFF]]
+                                    ^ decrypt_tables[3][sbox[word >> 24]];
         }
     }
+    return result;
 }
 
-unsigned char mul(unsigned char left, unsigned char right)
+template<size_t rounds>
+void aes_block_encrypt(const unsigned char *input_block, unsigned char *output_block,
+        const ScheduleKey<rounds> &schedule_key)
 {
-    unsigned char result{};
-    for (unsigned char mask = 0x01; mask <= right && mask != 0; mask <<= 1)
+    const auto &t = encrypt_tables;
+    const auto *key = schedule_key.data();
+    uint32_t s0 = load_column(input_block) ^ key[0];
+    uint32_t s1 = load_column(input_block + 4) ^ key[1];
+    uint32_t s2 = load_column(input_block + 8) ^ key[2];
+    uint32_t s3 = load_column(input_block + 12) ^ key[3];
+    for (size_t round = 1; round < rounds; ++round)
     {
-        if ((right & mask) != 0)
-        {
-            result ^= left;
-        }
-        left = (left << 1) ^ (left & 0x80 ? 0x1b : 0);
+        key += 4;
+        const auto t0 = t[0][s0 & 0xFF] ^ t[1][(s1 >> 8) & 0xFF] ^ t[2][(s2 >> 16) & 0xFF] ^ t[3][s3 >> 24] ^ key[0];
+        const auto t1 = t[0][s1 & 0xFF] ^ t[1][(s2 >> 8) & 0xFF] ^ t[2][(s3 >> 16) & 0xFF] ^ t[3][s0 >> 24] ^ key[1];
+        const auto t2 = t[0][s2 & 0xFF] ^ t[1][(s3 >> 8) & 0xFF] ^ t[2][(s0 >> 16) & 0xFF] ^ t[3][s1 >> 24] ^ key[2];
+        const auto t3 = t[0][s3 & 0xFF] ^ t[1][(s0 >> 8) & 0xFF] ^ t[2][(s1 >> 16) & 0xFF] ^ t[3][s2 >> 24] ^ key[3];
+        s0 = t0;
+        s1 = t1;
+        s2 = t2;
+        s3 = t3;
     }
-    return result;
+    // last round has no MixColumns
+    key += 4;
+    store_column(substitute_column(sbox, s0, s1, s2, s3) ^ key[0], output_block);
+    store_column(substitute_column(sbox, s1, s2, s3, s0) ^ key[1], output_block + 4);
+    store_column(substitute_column(sbox, s2, s3, s0, s1) ^ key[2], output_block + 8);
+    store_column(substitute_column(sbox, s3, s0, s1, s2) ^ key[3], output_block + 12);
 }
 
-const auto multiplication_matrix = State{{
-                                                 { 2, 3, 1, 1 },
-                                                 { 1, 2, 3, 1 },
-                                                 { 1, 1, 2, 3 },
-                                                 { 3, 1, 1, 2 }
-                                         }};
-const auto unmultiplication_matrix = State{{
-                                                   { 0x0e, 0x0b, 0x0d, 0x09 },
-                                                   { 0x09, 0x0e, 0x0b, 0x0d },
-                                                   { 0x0d, 0x09, 0x0e, 0x0b },
-                                                   { 0x0b, 0x0d, 0x09, 0x0e }
-                                           }};
-
-void mix_columns(State &state, const State &matrix)
+template<size_t rounds>
+void aes_block_decrypt(const unsigned char *input_block, unsigned char *output_block,
+        const ScheduleKey<rounds> &schedule_key)
 {
-    for (size_t i = 0; i < state.size(); ++i)
+    const auto &t = decrypt_tables;
+    const auto *key = schedule_key.data();
+    uint32_t s0 = load_column(input_block) ^ key[0];
+    uint32_t s1 = load_column(input_block + 4) ^ key[1];
+    uint32_t s2 = load_column(input_block + 8) ^ key[2];
+    uint32_t s3 = load_column(input_block + 12) ^ key[3];
+    for (size_t round = 1; round < rounds; ++round)
     {
-        const auto c0 = mul(matrix.at(0).at(0), state.at(i).at(0))
-                        ^ mul(matrix.at(0).at(1), state.at(i).at(1))
-                        ^ mul(matrix.at(0).at(2), state.at(i).at(2))
-                        ^ mul(matrix.at(0).at(3), state.at(i).at(3));
-        const auto c1 = mul(matrix.at(1).at(0), state.at(i).at(0))
-                        ^ mul(matrix.at(1).at(1), state.at(i).at(1))
-                        ^ mul(matrix.at(1).at(2), state.at(i).at(2))
-                        ^ mul(matrix.at(1).at(3), state.at(i).at(3));
-        const auto c2 = mul(matrix.at(2).at(0), state.at(i).at(0))
-                        ^ mul(matrix.at(2).at(1), state.at(i).at(1))
-                        ^ mul(matrix.at(2).at(2), state.at(i).at(2))
-                        ^ mul(matrix.at(2).at(3), state.at(i).at(3));
-        const auto c3 = mul(matrix.at(3).at(0), state.at(i).at(0))
-                        ^ mul(matrix.at(3).at(1), state.at(i).at(1))
-                        ^ mul(matrix.at(3).at(2), state.at(i).at(2))
-                        ^ mul(matrix.at(3).at(3), state.at(i).at(3));
-        state.at(i).at(0) = c0;
-        state.at(i).at(1) = c1;
-        state.at(i).at(2) = c2;
-        state.at(i).at(3) = c3;
+        key += 4;
+        const auto t0 = t[0][s0 & 0xFF] ^ t[1][(s3 >> 8) & 0xFF] ^ t[2][(s2 >> 16) & 0xFF] ^ t[3][s1 >> 24] ^ key[0];
+        const auto t1 = t[0][s1 & 0xFF] ^ t[1][(s0 >> 8) & 0xFF] ^ t[2][(s3 >> 16) & 0xFF] ^ t[3][s2 >> 24] ^ key[1];
+        const auto t2 = t[0][s2 & 0xFF] ^ t[1][(s1 >> 8) & 0xFF] ^ t[2][(s0 >> 16) & 0xFF] ^ t[3][s3 >> 24] ^ key[2];
+        const auto t3 = t[0][s3 & 0xFF] ^ t[1][(s2 >> 8) & 0xFF] ^ t[2][(s1 >> 16) & 0xFF] ^ t[3][s0 >> 24] ^ key[3];
+        s0 = t0;
+        s1 = t1;
+        s2 = t2;
+        s3 = t3;
     }
+    // last round has no InvMixColumns
+    key += 4;
+    store_column(substitute_column(inverse_sbox, s0, s3, s2, s1) ^ key[0], output_block);
+    store_column(substitute_column(inverse_sbox, s1, s0, s3, s2) ^ key[1], output_block + 4);
+    store_column(substitute_column(inverse_sbox, s2, s1, s0, s3) ^ key[2], output_block + 8);
+    store_column(substitute_column(inverse_sbox, s3, s2, s1, s0) ^ key[3], output_block + 12);
 }
 
-void mix_rows(State &state)
+AesFallback &aes_fallback()
 {
-    // row 0 no-op
-
-    // row 1
-    std::swap(state.at(0).at(1), state.at(1).at(1));
-    std::swap(state.at(1).at(1), state.at(2).at(1));
-    std::swap(state.at(2).at(1), state.at(3).at(1));
+    static AesFallback fallback = AesFallback::Table;
+    return fallback;
+}
 
-    // row 2
-    std::swap(state.at(0).at(2), state.at(2).at(2));
-    std::swap(state.at(1).at(2), state.at(3).at(2));
+template<size_t bits>
+AesKey<bits>::AesKey(const std::array<unsigned char, bits / 8> &key)
+{
+    if (cpu_features().aes)
+    {
+        aes_ni_build_schedule_key(key.data(), key.size(), encrypt_key.data(), decrypt_key.data());
+    }
+    else if (aes_fallback() == AesFallback::Bitsliced)
+    {
+        aes_bitsliced_build_schedule_key(key.data(), key.size(), encrypt_key.data(), decrypt_key.data());
+    }
+    else
+    {
+        encrypt_key = build_schedule_key(key);
+        decrypt_key = build_decrypt_schedule_key<rounds>(encrypt_key);
+    }
+}
 
-    // row 3
-    std::swap(state.at(0).at(3), state.at(1).at(3));
-    std::swap(state.at(0).at(3), state.at(2).at(3));
-    std::swap(state.at(0).at(3), state.at(3).at(3));
+template<size_t bits>
+const typename AesKey<bits>::ScheduleKey &AesKey<bits>::get_encrypt_key() const
+{
+    return encrypt_key;
 }
 
-void unmix_rows(State &state)
+template<size_t bits>
+const typename AesKey<bits>::ScheduleKey &AesKey<bits>::get_decrypt_key() const
 {
-    // row 0 no-op
+    return decrypt_key;
+}
 
-    // row 1
-    std::swap(state.at(0).at(1), state.at(1).at(1));
-    std::swap(state.at(0).at(1), state.at(2).at(1));
-    std::swap(state.at(0).at(1), state.at(3).at(1));
+template
+class AesKey<128>;
 
+template
+class AesKey<192>;
 
-    // row 2
-    std::swap(state.at(0).at(2), state.at(2).at(2));
-    std::swap(state.at(1).at(2), state.at(3).at(2));
+template
+class AesKey<256>;
 
-    // row 3
-    std::swap(state.at(0).at(3), state.at(1).at(3));
-    std::swap(state.at(1).at(3), state.at(2).at(3));
-    std::swap(state.at(2).at(3), state.at(3).at(3));
+template<size_t rounds>
+void aes_cbc_encrypt_blocks(const unsigned char *input, unsigned char *output, size_t size, const unsigned char *iv,
+        const ScheduleKey<rounds> &schedule_key)
+{
+    if (cpu_features().aes)
+    {
+        aes_ni_cbc_encrypt(input, output, size, iv, schedule_key.data(), rounds);
+        return;
+    }
+    if (aes_fallback() == AesFallback::Bitsliced)
+    {
+        aes_bitsliced_cbc_encrypt(input, output, size, iv, schedule_key.data(), rounds);
+        return;
+    }
+    std::array<unsigned char, 16> block{};
+    const unsigned char *previous = iv;
+    for (size_t i = 0; i < size; i += 16)
+    {
+        for (size_t j = 0; j < 16; ++j)
+        {
+            block[j] = input[i + j] ^ previous[j];
+        }
+        aes_block_encrypt<rounds>(block.data(), output + i, schedule_key);
+        previous = output + i;
+    }
 }
 
-template<int rounds>
-void aes_block_encrypt(const std::array<unsigned char, 16> &input_block, std::array<unsigned char, 16> &output_block,
-        const std::array<State, rounds + 1> &schedule_keys)
+void check_output_size(size_t input_size, size_t output_size)
 {
-    State state{};
+    if (input_size != output_size)
+    {
+        throw std::runtime_error("output size should match input size");
+    }
+}
 
-    for (size_t i = 0; i < 4; ++i)
+template<size_t bits>
+void aes_cbc_encrypt(std::span<const unsigned char> input,
+        std::span<unsigned char> output,
+        const std::array<unsigned char, 16> &iv,
+        const AesKey<bits> &key)
+{
+    if (input.size() % 16 != 0)
     {
-        for (size_t j = 0; j < 4; ++j)
+        throw std::runtime_error("input should be padded");
+    }
+    check_output_size(input.size(), output.size());
+    aes_cbc_encrypt_blocks<AesKey<bits>::rounds>(input.data(), output.data(), input.size(), iv.data(),
+            key.get_encrypt_key());
+}
+
+template<size_t bits>
+std::vector<unsigned char> aes_cbc_encrypt(const std::vector<unsigned char> &input,
+        const std::array<unsigned char, 16> &iv,
+        const AesKey<bits> &key)
+{
+    std::vector<unsigned char> result(input.size());
+    aes_cbc_encrypt(std::span(input), std::span(result), iv, key);
+    return result;
+}
+
+template<size_t bits>
+void aes_cbc_encrypt_many(std::vector<AesCbcJob<bits>> &jobs)
+{
+    constexpr size_t rounds = AesKey<bits>::rounds;
+    for (const auto &job: jobs)
+    {
+        if (job.data.size() % 16 != 0)
         {
-            state.at(i).at(j) = input_block.at(4 * i + j);
+            throw std::runtime_error("input should be padded");
         }
     }
-    xor_state(state, schedule_keys.at(0));
-    for (int round = 0; round < rounds; ++round)
+    if (cpu_features().aes)
     {
-        substitute_state(state);
-        mix_rows(state);
-        if (round < rounds - 1)
+        std::vector<AesNiCbcStream> streams;
+        streams.reserve(jobs.size());
+        for (auto &job: jobs)
         {
-            mix_columns(state, multiplication_matrix);
+            streams.push_back({ job.key->get_encrypt_key().data(), job.iv.data(), job.data.data(), job.data.size() });
         }
-        xor_state(state, schedule_keys.at(round + 1));
+        aes_ni_cbc_encrypt_many(streams.data(), streams.size(), rounds);
+        return;
     }
-    for (size_t i = 0; i < 4; ++i)
+    for (auto &job: jobs)
     {
-        for (size_t j = 0; j < 4; ++j)
+        if (job.data.empty())
         {
-            output_block.at(i * 4 + j) = state.at(i).at(j);
+            continue;
         }
+        aes_cbc_encrypt_blocks<rounds>(job.data.data(), job.data.data(), job.data.size(), job.iv.data(),
+                job.key->get_encrypt_key());
+        std::copy_n(job.data.end() - 16, job.iv.size(), job.iv.begin());
     }
 }
 
-template<int rounds>
-void aes_block_decrypt(const std::array<unsigned char, 16> &input_block, std::array<unsigned char, 16> &output_block,
-        const std::array<State, rounds + 1> &schedule_keys)
+/**
+ * CBC decryption of whole blocks. Output may alias input: every batch is decrypted to a local buffer first,
+ * then chained from the last block backwards, so cypher blocks are read before they are overwritten.
+ */
+template<size_t rounds>
+void aes_cbc_decrypt_blocks(const unsigned char *input, unsigned char *output, size_t size, const unsigned char *iv,
+        const ScheduleKey<rounds> &schedule_key)
 {
-    State state{};
-
-    for (size_t i = 0; i < 4; ++i)
+    if (cpu_features().aes)
     {
-        for (size_t j = 0; j < 4; ++j)
-        {
-            state.at(i).at(j) = input_block.at(i * 4 + j);
-        }
+        aes_ni_cbc_decrypt(input, output, size, iv, schedule_key.data(), rounds);
+        return;
     }
-    xor_state(state, schedule_keys.at(rounds));
-    for (int round = rounds - 1; round >= 0; --round)
+    if (aes_fallback() == AesFallback::Bitsliced)
     {
-        unmix_rows(state);
-        unsubstitute_state(state);
-        xor_state(state, schedule_keys.at(round));
-        if (round > 0)
-        {
-            mix_columns(state, unmultiplication_matrix);
-        }
+        aes_bitsliced_cbc_decrypt(input, output, size, iv, schedule_key.data(), rounds);
+        return;
     }
-    for (size_t i = 0; i < 4; ++i)
+    std::array<unsigned char, 16> previous{};
+    std::copy_n(iv, previous.size(), previous.begin());
+    std::array<unsigned char, 16> next_previous{};
+    // independent blocks back to back keep the table lookups of several blocks in flight
+    std::array<unsigned char, 64> blocks{};
+    for (size_t i = 0; i < size; i += blocks.size())
     {
-        for (size_t j = 0; j < 4; ++j)
+        const auto batch = std::min(blocks.size(), size - i);
+        for (size_t j = 0; j < batch; j += 16)
         {
-            output_block.at(i * 4 + j) = state.at(i).at(j);
+            aes_block_decrypt<rounds>(input + i + j, blocks.data() + j, schedule_key);
         }
+        std::copy_n(input + i + batch - 16, next_previous.size(), next_previous.begin());
+        for (size_t j = batch; j-- > 0;)
+        {
+            output[i + j] = blocks[j] ^ (j < 16 ? previous[j] : input[i + j - 16]);
+        }
+        previous = next_previous;
     }
 }
 
-template<size_t keysize>
-std::vector<unsigned char> aes_cbc_encrypt(const std::vector<unsigned char> &input,
+/**
+ * Smallest part of a buffer worth a separate thread.
+ */
+constexpr size_t parallel_chunk_size = 256 * 1024;
+
+template<size_t bits>
+void aes_cbc_decrypt(std::span<const unsigned char> cypher_data,
+        std::span<unsigned char> output,
         const std::array<unsigned char, 16> &iv,
-        const std::array<unsigned char, keysize> &key)
+        const AesKey<bits> &key,
+        size_t threads)
 {
-    if (input.size() % 16 != 0)
+    if (cypher_data.size() % 16 != 0)
     {
-        throw std::runtime_error("input should be padded");
+        throw std::runtime_error("Malformed cypher data");
     }
-    std::vector<unsigned char> result{};
-    std::array<unsigned char, 16> input_block;
-    std::array<unsigned char, 16> cypher_block = iv;
-    const auto schedule_keys = build_schedule_key(key);
-    for (size_t i = 0; i < input.size(); i += 16)
-    {
-        std::copy_n(input.cbegin() + i, 16, input_block.begin());
-        std::transform(input_block.begin(), input_block.end(), cypher_block.cbegin(),
-                input_block.begin(),
-                [](const auto &left, const auto &right)
-                {
-                    return left ^ right;
-                });
-        aes_block_encrypt<keysize / 4 + 6>(input_block, cypher_block, schedule_keys);
-        std::copy_n(cypher_block.cbegin(), 16, std::back_inserter(result));
+    check_output_size(cypher_data.size(), output.size());
+    constexpr size_t rounds = AesKey<bits>::rounds;
+    const auto &schedule_key = key.get_decrypt_key();
+    threads = std::min(threads, cypher_data.size() / parallel_chunk_size);
+    if (threads <= 1)
+    {
+        aes_cbc_decrypt_blocks<rounds>(cypher_data.data(), output.data(), cypher_data.size(), iv.data(),
+                schedule_key);
+        return;
     }
-    return result;
+    // every chunk starts its chain from the last cypher block of the previous chunk,
+    // copied up front because in place decryption of the previous chunk overwrites it
+    const auto chunk_size = (cypher_data.size() / 16 + threads - 1) / threads * 16;
+    std::vector<std::array<unsigned char, 16>> chunk_ivs;
+    for (size_t start = chunk_size; start < cypher_data.size(); start += chunk_size)
+    {
+        chunk_ivs.emplace_back();
+        std::copy_n(cypher_data.begin() + start - 16, 16, chunk_ivs.back().begin());
+    }
+    std::vector<std::jthread> workers;
+    for (size_t i = 0; i < chunk_ivs.size(); ++i)
+    {
+        const auto start = (i + 1) * chunk_size;
+        workers.emplace_back(aes_cbc_decrypt_blocks<rounds>, cypher_data.data() + start, output.data() + start,
+                std::min(chunk_size, cypher_data.size() - start), chunk_ivs[i].data(), std::cref(schedule_key));
+    }
+    aes_cbc_decrypt_blocks<rounds>(cypher_data.data(), output.data(), chunk_size, iv.data(), schedule_key);
 }
 
-template<size_t keysize>
+template<size_t bits>
 std::vector<unsigned char> aes_cbc_decrypt(const std::vector<unsigned char> &cypher_data,
         const std::array<unsigned char, 16> &iv,
-        const std::array<unsigned char, keysize> &key)
+        const AesKey<bits> &key,
+        size_t threads)
 {
-    if (cypher_data.size() % 16 != 0)
+    std::vector<unsigned char> result(cypher_data.size());
+    aes_cbc_decrypt(std::span(cypher_data), std::span(result), iv, key, threads);
+    return result;
+}
+
+/**
+ * Counter of the block number blocks after the given one, 128-bit big endian addition.
+ */
+std::array<unsigned char, 16> advance_counter(const std::array<unsigned char, 16> &counter, uint64_t blocks)
+{
+    auto result = counter;
+    unsigned int carry = 0;
+    for (size_t i = result.size(); i-- > 0;)
     {
-        throw std::runtime_error("Malformed cypher data");
+        const unsigned int sum = result[i] + (blocks & 0xFF) + carry;
+        result[i] = sum & 0xFF;
+        carry = sum >> 8;
+        blocks >>= 8;
     }
-    std::vector<unsigned char> result{};
-    std::array<unsigned char, 16> input_block;
-    std::array<unsigned char, 16> output_block;
-    auto next_iv = iv;
-    const auto schedule_keys = build_schedule_key(key);
-    for (size_t i = 0; i < cypher_data.size(); i += 16)
-    {
-        std::copy_n(cypher_data.cbegin() + i, 16, input_block.begin());
-        aes_block_decrypt<keysize / 4 + 6>(input_block, output_block, schedule_keys);
-        std::transform(output_block.begin(), output_block.end(), next_iv.cbegin(),
-                output_block.begin(),
-                [](const auto &left, const auto &right)
-                {
-                    return left ^ right;
-                });
-        next_iv = input_block;
-        std::copy_n(output_block.cbegin(), 16, std::back_inserter(result));
+    return result;
+}
+
+template<size_t rounds>
+void aes_ctr_blocks(const unsigned char *input, unsigned char *output, size_t size,
+        std::array<unsigned char, 16> counter, const ScheduleKey<rounds> &schedule_key)
+{
+    if (cpu_features().aes)
+    {
+        aes_ni_ctr_crypt(input, output, size, counter.data(), schedule_key.data(), rounds);
+        return;
+    }
+    if (aes_fallback() == AesFallback::Bitsliced)
+    {
+        aes_bitsliced_ctr_crypt(input, output, size, counter.data(), schedule_key.data(), rounds);
+        return;
     }
+    // 8 independent blocks per batch keep table lookups of several blocks in flight
+    std::array<unsigned char, 16 * 8> counters{};
+    std::array<unsigned char, 16 * 8> key_stream{};
+    for (size_t i = 0; i < size; i += key_stream.size())
+    {
+        for (size_t j = 0; j < counters.size(); j += 16)
+        {
+            std::copy(counter.begin(), counter.end(), counters.begin() + j);
+            counter = advance_counter(counter, 1);
+        }
+        for (size_t j = 0; j < counters.size(); j += 16)
+        {
+            aes_block_encrypt<rounds>(counters.data() + j, key_stream.data() + j, schedule_key);
+        }
+        const auto batch = std::min(key_stream.size(), size - i);
+        for (size_t j = 0; j < batch; ++j)
+        {
+            output[i + j] = input[i + j] ^ key_stream[j];
+        }
+    }
+}
+
+/**
+ * Output may alias input.
+ */
+template<size_t rounds>
+void aes_ctr_process(const unsigned char *input, unsigned char *output, size_t size,
+        const std::array<unsigned char, 16> &counter, const ScheduleKey<rounds> &schedule_key, uint64_t offset,
+        size_t threads)
+{
+    size_t start = 0;
+    if (offset % 16 != 0 && size != 0)
+    {
+        // offset inside a block: run the block on a copy positioned at the same offset
+        std::array<unsigned char, 16> block{};
+        start = std::min<size_t>(16 - offset % 16, size);
+        std::copy_n(input, start, block.begin() + offset % 16);
+        aes_ctr_blocks<rounds>(block.data(), block.data(), block.size(), advance_counter(counter, offset / 16),
+                schedule_key);
+        std::copy_n(block.begin() + offset % 16, start, output);
+    }
+    const auto first_block = (offset + start) / 16;
+    input += start;
+    output += start;
+    size -= start;
+    threads = std::min(threads, size / parallel_chunk_size);
+    if (threads <= 1)
+    {
+        aes_ctr_blocks<rounds>(input, output, size, advance_counter(counter, first_block), schedule_key);
+        return;
+    }
+    // key stream blocks are independent, every chunk seeks its counter
+    const auto chunk_size = (size / 16 + threads - 1) / threads * 16;
+    std::vector<std::jthread> workers;
+    for (size_t chunk = chunk_size; chunk < size; chunk += chunk_size)
+    {
+        workers.emplace_back(aes_ctr_blocks<rounds>, input + chunk, output + chunk, std::min(chunk_size, size - chunk),
+                advance_counter(counter, first_block + chunk / 16), std::cref(schedule_key));
+    }
+    aes_ctr_blocks<rounds>(input, output, chunk_size, advance_counter(counter, first_block), schedule_key);
+}
+
+template<size_t bits>
+std::vector<unsigned char> aes_ctr_crypt(const std::vector<unsigned char> &input,
+        const std::array<unsigned char, 16> &counter,
+        const AesKey<bits> &key,
+        uint64_t offset,
+        size_t threads)
+{
+    std::vector<unsigned char> result(input.size());
+    aes_ctr_process<AesKey<bits>::rounds>(input.data(), result.data(), input.size(), counter, key.get_encrypt_key(),
+            offset, threads);
     return result;
 }
 
+template<size_t bits>
+void aes_ctr_crypt(std::span<const unsigned char> input,
+        std::span<unsigned char> output,
+        const std::array<unsigned char, 16> &counter,
+        const AesKey<bits> &key,
+        uint64_t offset,
+        size_t threads)
+{
+    check_output_size(input.size(), output.size());
+    aes_ctr_process<AesKey<bits>::rounds>(input.data(), output.data(), input.size(), counter, key.get_encrypt_key(),
+            offset, threads);
+}
+
+template
+std::vector<unsigned char> aes_cbc_encrypt(const std::vector<unsigned char> &input,
+        const std::array<unsigned char, 16> &iv, const AesKey<128> &key);
+
+template
+std::vector<unsigned char> aes_cbc_encrypt(const std::vector<unsigned char> &input,
+        const std::array<unsigned char, 16> &iv, const AesKey<192> &key);
+
+template
+std::vector<unsigned char> aes_cbc_encrypt(const std::vector<unsigned char> &input,
+        const std::array<unsigned char, 16> &iv, const AesKey<256> &key);
+
+template
+void aes_cbc_encrypt_many(std::vector<AesCbcJob<128>> &jobs);
+
+template
+void aes_cbc_encrypt_many(std::vector<AesCbcJob<192>> &jobs);
+
+template
+void aes_cbc_encrypt_many(std::vector<AesCbcJob<256>> &jobs);
+
+template
+std::vector<unsigned char> aes_cbc_decrypt(const std::vector<unsigned char> &cypher_data,
+        const std::array<unsigned char, 16> &iv, const AesKey<128> &key, size_t threads);
+
+template
+std::vector<unsigned char> aes_cbc_decrypt(const std::vector<unsigned char> &cypher_data,
+        const std::array<unsigned char, 16> &iv, const AesKey<192> &key, size_t threads);
+
+template
+std::vector<unsigned char> aes_cbc_decrypt(const std::vector<unsigned char> &cypher_data,
+        const std::array<unsigned char, 16> &iv, const AesKey<256> &key, size_t threads);
+
+template
+std::vector<unsigned char> aes_ctr_crypt(const std::vector<unsigned char> &input,
+        const std::array<unsigned char, 16> &counter, const AesKey<128> &key, uint64_t offset, size_t threads);
+
+template
+std::vector<unsigned char> aes_ctr_crypt(const std::vector<unsigned char> &input,
+        const std::array<unsigned char, 16> &counter, const AesKey<192> &key, uint64_t offset, size_t threads);
+
+template
+std::vector<unsigned char> aes_ctr_crypt(const std::vector<unsigned char> &input,
+        const std::array<unsigned char, 16> &counter, const AesKey<256> &key, uint64_t offset, size_t threads);
+
 std::vector<unsigned char> aes128_cbc_encrypt(const std::vector<unsigned char> &input,
         const std::array<unsigned char, 16> &iv,
         const std::array<unsigned char, 16> &key)
 {
-    return aes_cbc_encrypt(input, iv, key);
+    return aes_cbc_encrypt(input, iv, AesKey<128>(key));
 }
 
 std::vector<unsigned char> aes128_cbc_decrypt(const std::vector<unsigned char> &cypher_data,
         const std::array<unsigned char, 16> &iv,
         const std::array<unsigned char, 16> &key)
 {
-    return aes_cbc_decrypt(cypher_data, iv, key);
+    return aes_cbc_decrypt(cypher_data, iv, AesKey<128>(key));
 }
 
 std::vector<unsigned char> aes192_cbc_encrypt(const std::vector<unsigned char> &input,
         const std::array<unsigned char, 16> &iv,
         const std::array<unsigned char, 24> &key)
 {
-    return aes_cbc_encrypt(input, iv, key);
+    return aes_cbc_encrypt(input, iv, AesKey<192>(key));
 }
 
 std::vector<unsigned char> aes192_cbc_decrypt(const std::vector<unsigned char> &cypher_data,
         const std::array<unsigned char, 16> &iv,
         const std::array<unsigned char, 24> &key)
 {
-    return aes_cbc_decrypt(cypher_data, iv, key);
+    return aes_cbc_decrypt(cypher_data, iv, AesKey<192>(key));
 }
 
 std::vector<unsigned char> aes256_cbc_encrypt(const std::vector<unsigned char> &input,
         const std::array<unsigned char, 16> &iv,
         const std::array<unsigned char, 32> &key)
 {
-    return aes_cbc_encrypt(input, iv, key);
+    return aes_cbc_encrypt(input, iv, AesKey<256>(key));
 }
 
 std::vector<unsigned char> aes256_cbc_decrypt(const std::vector<unsigned char> &cypher_data,
         const std::array<unsigned char, 16> &iv,
         const std::array<unsigned char, 32> &key)
 {
-    return aes_cbc_decrypt(cypher_data, iv, key);
-}
\ No newline at end of file
+    return aes_cbc_decrypt(cypher_data, iv, AesKey<256>(key));
+}
+
+
+template
+void aes_cbc_encrypt(std::span<const unsigned char> input, std::span<unsigned char> output,
+        const std::array<unsigned char, 16> &iv, const AesKey<128> &key);
+
+template
+void aes_cbc_decrypt(std::span<const unsigned char> cypher_data, std::span<unsigned char> output,
+        const std::array<unsigned char, 16> &iv, const AesKey<128> &key, size_t threads);
+
+template
+void aes_ctr_crypt(std::span<const unsigned char> input, std::span<unsigned char> output,
+        const std::array<unsigned char, 16> &counter, const AesKey<128> &key, uint64_t offset, size_t threads);
+
+template
+void aes_cbc_encrypt(std::span<const unsigned char> input, std::span<unsigned char> output,
+        const std::array<unsigned char, 16> &iv, const AesKey<192> &key);
+
+template
+void aes_cbc_decrypt(std::span<const unsigned char> cypher_data, std::span<unsigned char> output,
+        const std::array<unsigned char, 16> &iv, const AesKey<192> &key, size_t threads);
+
+template
+void aes_ctr_crypt(std::span<const unsigned char> input, std::span<unsigned char> output,
+        const std::array<unsigned char, 16> &counter, const AesKey<192> &key, uint64_t offset, size_t threads);
+
+template
+void aes_cbc_encrypt(std::span<const unsigned char> input, std::span<unsigned char> output,
+        const std::array<unsigned char, 16> &iv, const AesKey<256> &key);
+
+template
+void aes_cbc_decrypt(std::span<const unsigned char> cypher_data, std::span<unsigned char> output,
+        const std::array<unsigned char, 16> &iv, const AesKey<256> &key, size_t threads);
+
+template
+void aes_ctr_crypt(std::span<const unsigned char> input, std::span<unsigned char> output,
+        const std::array<unsigned char, 16> &counter, const AesKey<256> &key, uint64_t offset, size_t threads);
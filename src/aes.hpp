@@ -2,8 +2,100 @@
 #define TLS_PLAYGROUND_AES_HPP
 
 #include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
 #include <vector>
 
+/**
+ * Implementation used when AES-NI is not available. Table is the fastest portable one,
+ * bitsliced processes 8 blocks at once without secret dependent memory access, so it's immune to cache timing.
+ */
+enum class AesFallback
+{
+    Table,
+    Bitsliced
+};
+
+/**
+ * Process wide fallback selection, table by default.
+ */
+AesFallback &aes_fallback();
+
+/**
+ * Expanded AES key: encryption and decryption schedules are computed once in constructor,
+ * so a key can be reused for any number of blocks or records.
+ */
+template<size_t bits>
+class AesKey
+{
+public:
+    static constexpr size_t rounds = bits / 32 + 6;
+    using ScheduleKey = std::array<uint32_t, 4 * (rounds + 1)>;
+
+private:
+    ScheduleKey encrypt_key;
+    ScheduleKey decrypt_key;
+
+public:
+    explicit AesKey(const std::array<unsigned char, bits / 8> &key);
+
+    [[nodiscard]]
+    const ScheduleKey &get_encrypt_key() const;
+
+    [[nodiscard]]
+    const ScheduleKey &get_decrypt_key() const;
+};
+
+template<size_t bits>
+std::vector<unsigned char> aes_cbc_encrypt(const std::vector<unsigned char> &input,
+        const std::array<unsigned char, 16> &iv,
+        const AesKey<bits> &key);
+
+/**
+ * One independent CBC stream for aes_cbc_encrypt_many. Data is encrypted in place and iv is replaced with the last
+ * cypher block, so the next record of the same connection continues the chain.
+ */
+template<size_t bits>
+struct AesCbcJob
+{
+    const AesKey<bits> *key;
+    std::array<unsigned char, 16> iv;
+    std::span<unsigned char> data;
+};
+
+/**
+ * CBC encryption is serial within a stream, so independent streams (e.g. records of different connections)
+ * are encrypted in lockstep to keep several blocks in flight.
+ */
+template<size_t bits>
+void aes_cbc_encrypt_many(std::vector<AesCbcJob<bits>> &jobs);
+
+/**
+ * @param threads upper bound of threads used, buffers are split into chunks of at least 256 KiB
+ */
+template<size_t bits>
+std::vector<unsigned char> aes_cbc_decrypt(const std::vector<unsigned char> &cypher_data,
+        const std::array<unsigned char, 16> &iv,
+        const AesKey<bits> &key,
+        size_t threads = 1);
+
+/**
+ * Span variants write into caller's buffer, output must have the input size and may be the same memory.
+ */
+template<size_t bits>
+void aes_cbc_encrypt(std::span<const unsigned char> input,
+        std::span<unsigned char> output,
+        const std::array<unsigned char, 16> &iv,
+        const AesKey<bits> &key);
+
+template<size_t bits>
+void aes_cbc_decrypt(std::span<const unsigned char> cypher_data,
+        std::span<unsigned char> output,
+        const std::array<unsigned char, 16> &iv,
+        const AesKey<bits> &key,
+        size_t threads = 1);
+
 std::vector<unsigned char> aes128_cbc_encrypt(const std::vector<unsigned char> &input,
         const std::array<unsigned char, 16> &iv,
         const std::array<unsigned char, 16> &key);
@@ -28,4 +120,24 @@ std::vector<unsigned char> aes256_cbc_decrypt(const std::vector<unsigned char> &
         const std::array<unsigned char, 16> &iv,
         const std::array<unsigned char, 32> &key);
 
+/**
+ * AES-CTR with 128-bit big endian counter, encryption and decryption are the same operation.
+ * @param offset position in the key stream in bytes, gives random access into the middle of a stream
+ * @param threads upper bound of threads used, buffers are split into chunks of at least 256 KiB
+ */
+template<size_t bits>
+std::vector<unsigned char> aes_ctr_crypt(const std::vector<unsigned char> &input,
+        const std::array<unsigned char, 16> &counter,
+        const AesKey<bits> &key,
+        uint64_t offset = 0,
+        size_t threads = 1);
+
+template<size_t bits>
+void aes_ctr_crypt(std::span<const unsigned char> input,
+        std::span<unsigned char> output,
+        const std::array<unsigned char, 16> &counter,
+        const AesKey<bits> &key,
+        uint64_t offset = 0,
+        size_t threads = 1);
+
 #endif //TLS_PLAYGROUND_AES_HPP
@@ -0,0 +1,590 @@
+#include <algorithm>
+#include <array>
+
+#include "aes_bitsliced.hpp"
+
+/**
+ * One bit of every byte of 8 blocks. Lane h holds blocks 4h..4h+3, bit 4p+k of a lane is byte p of block k,
+ * so a state row is every fourth nibble and row rotations are nibble shifts. Lanes are independent,
+ * which lets the compiler keep both in one SIMD register.
+ */
+struct Slice
+{
+    std::array<uint64_t, 2> lanes;
+};
+
+inline Slice operator^(const Slice &left, const Slice &right)
+{
+    return { left.lanes[0] ^ right.lanes[0], left.lanes[1] ^ right.lanes[1] };
+}
+
+inline Slice operator&(const Slice &left, const Slice &right)
+{
+    return { left.lanes[0] & right.lanes[0], left.lanes[1] & right.lanes[1] };
+}
+
+inline Slice operator~(const Slice &value)
+{
+    return { ~value.lanes[0], ~value.lanes[1] };
+}
+
+template<typename Operation>
+inline Slice apply(const Slice &value, Operation operation)
+{
+    return { operation(value.lanes[0]), operation(value.lanes[1]) };
+}
+
+/**
+ * Plane 0 is the least significant bit.
+ */
+using BitslicedState = std::array<Slice, 8>;
+
+constexpr size_t parallel_blocks = 8;
+
+inline uint64_t rotate_right(uint64_t value, int shift)
+{
+    return value >> shift | value << (64 - shift);
+}
+
+/**
+ * Transposes 8x8 bit matrix, byte i is row i.
+ */
+inline uint64_t transpose(uint64_t value)
+{
+    uint64_t swap = (value ^ (value >> 7)) & 0x00AA00AA00AA00AA;
+    value ^= swap ^ (swap << 7);
+    swap = (value ^ (value >> 14)) & 0x0000CCCC0000CCCC;
+    value ^= swap ^ (swap << 14);
+    swap = (value ^ (value >> 28)) & 0x00000000F0F0F0F0;
+    value ^= swap ^ (swap << 28);
+    return value;
+}
+
+/**
+ * Two byte positions of 4 blocks form 8x8 bit matrix, its transposition is one byte of every plane.
+ */
+BitslicedState pack(const unsigned char *blocks)
+{
+    BitslicedState result{};
+    for (size_t lane = 0; lane < 2; ++lane)
+    {
+        const auto *lane_blocks = blocks + 64 * lane;
+        for (size_t position = 0; position < 16; position += 2)
+        {
+            uint64_t matrix = 0;
+            for (size_t row = 0; row < 8; ++row)
+            {
+                matrix |= static_cast<uint64_t>(lane_blocks[16 * (row % 4) + position + row / 4]) << (8 * row);
+            }
+            matrix = transpose(matrix);
+            for (size_t plane = 0; plane < 8; ++plane)
+            {
+                result[plane].lanes[lane] |= ((matrix >> (8 * plane)) & 0xFF) << (4 * position);
+            }
+        }
+    }
+    return result;
+}
+
+void unpack(const BitslicedState &state, unsigned char *blocks)
+{
+    for (size_t lane = 0; lane < 2; ++lane)
+    {
+        auto *lane_blocks = blocks + 64 * lane;
+        for (size_t position = 0; position < 16; position += 2)
+        {
+            uint64_t matrix = 0;
+            for (size_t plane = 0; plane < 8; ++plane)
+            {
+                matrix |= ((state[plane].lanes[lane] >> (4 * position)) & 0xFF) << (8 * plane);
+            }
+            matrix = transpose(matrix);
+            for (size_t row = 0; row < 8; ++row)
+            {
+                lane_blocks[16 * (row % 4) + position + row / 4] = (matrix >> (8 * row)) & 0xFF;
+            }
+        }
+    }
+}
+
+/**
+ * Boyar-Peralta circuit: GF(2^8) inversion and affine transformation in 113 boolean gates.
+ */
+void sub_bytes(BitslicedState &q)
+{
+    const auto x0 = q[7];
+    const auto x1 = q[6];
+    const auto x2 = q[5];
+    const auto x3 = q[4];
+    const auto x4 = q[3];
+    const auto x5 = q[2];
+    const auto x6 = q[1];
+    const auto x7 = q[0];
+
+    // top linear transformation
+    const auto y14 = x3 ^ x5;
+    const auto y13 = x0 ^ x6;
+    const auto y9 = x0 ^ x3;
+    const auto y8 = x0 ^ x5;
+    const auto t0 = x1 ^ x2;
+    const auto y1 = t0 ^ x7;
+    const auto y4 = y1 ^ x3;
+    const auto y12 = y13 ^ y14;
+    const auto y2 = y1 ^ x0;
+    const auto y5 = y1 ^ x6;
+    const auto y3 = y5 ^ y8;
+    const auto t1 = x4 ^ y12;
+    const auto y15 = t1 ^ x5;
+    const auto y20 = t1 ^ x1;
+    const auto y6 = y15 ^ x7;
+    const auto y10 = y15 ^ t0;
+    const auto y11 = y20 ^ y9;
+    const auto y7 = x7 ^ y11;
+    const auto y17 = y10 ^ y11;
+    const auto y19 = y10 ^ y8;
+    const auto y16 = t0 ^ y11;
+    const auto y21 = y13 ^ y16;
+    const auto y18 = x0 ^ y16;
+
+    // non-linear section
+    const auto t2 = y12 & y15;
+    const auto t3 = y3 & y6;
+    const auto t4 = t3 ^ t2;
+    const auto t5 = y4 & x7;
+    const auto t6 = t5 ^ t2;
+    const auto t7 = y13 & y16;
+    const auto t8 = y5 & y1;
+    const auto t9 = t8 ^ t7;
+    const auto t10 = y2 & y7;
+    const auto t11 = t10 ^ t7;
+    const auto t12 = y9 & y11;
+    const auto t13 = y14 & y17;
+    const auto t14 = t13 ^ t12;
+    const auto t15 = y8 & y10;
+    const auto t16 = t15 ^ t12;
+    const auto t17 = t4 ^ t14;
+    const auto t18 = t6 ^ t16;
+    const auto t19 = t9 ^ t14;
+    const auto t20 = t11 ^ t16;
+    const auto t21 = t17 ^ y20;
+    const auto t22 = t18 ^ y19;
+    const auto t23 = t19 ^ y21;
+    const auto t24 = t20 ^ y18;
+
+    const auto t25 = t21 ^ t22;
+    const auto t26 = t21 & t23;
+    const auto t27 = t24 ^ t26;
+    const auto t28 = t25 & t27;
+    const auto t29 = t28 ^ t22;
+    const auto t30 = t23 ^ t24;
+    const auto t31 = t22 ^ t26;
+    const auto t32 = t31 & t30;
+    const auto t33 = t32 ^ t24;
+    const auto t34 = t23 ^ t33;
+    const auto t35 = t27 ^ t33;
+    const auto t36 = t24 & t35;
+    const auto t37 = t36 ^ t34;
+    const auto t38 = t27 ^ t36;
+    const auto t39 = t29 & t38;
+    const auto t40 = t25 ^ t39;
+
+    const auto t41 = t40 ^ t37;
+    const auto t42 = t29 ^ t33;
+    const auto t43 = t29 ^ t40;
+    const auto t44 = t33 ^ t37;
+    const auto t45 = t42 ^ t41;
+    const auto z0 = t44 & y15;
+    const auto z1 = t37 & y6;
+    const auto z2 = t33 & x7;
+    const auto z3 = t43 & y16;
+    const auto z4 = t40 & y1;
+    const auto z5 = t29 & y7;
+    const auto z6 = t42 & y11;
+    const auto z7 = t45 & y17;
+    const auto z8 = t41 & y10;
+    const auto z9 = t44 & y12;
+    const auto z10 = t37 & y3;
+    const auto z11 = t33 & y4;
+    const auto z12 = t43 & y13;
+    const auto z13 = t40 & y5;
+    const auto z14 = t29 & y2;
+    const auto z15 = t42 & y9;
+    const auto z16 = t45 & y14;
+    const auto z17 = t41 & y8;
+
+    // bottom linear transformation
+    const auto t46 = z15 ^ z16;
+    const auto t47 = z10 ^ z11;
+    const auto t48 = z5 ^ z13;
+    const auto t49 = z9 ^ z10;
+    const auto t50 = z2 ^ z12;
+    const auto t51 = z2 ^ z5;
+    const auto t52 = z7 ^ z8;
+    const auto t53 = z0 ^ z3;
+    const auto t54 = z6 ^ z7;
+    const auto t55 = z16 ^ z17;
+    const auto t56 = z12 ^ t48;
+    const auto t57 = t50 ^ t53;
+    const auto t58 = z4 ^ t46;
+    const auto t59 = z3 ^ t54;
+    const auto t60 = t46 ^ t57;
+    const auto t61 = z14 ^ t57;
+    const auto t62 = t52 ^ t58;
+    const auto t63 = t49 ^ t58;
+    const auto t64 = z4 ^ t59;
+    const auto t65 = t61 ^ t62;
+    const auto t66 = z1 ^ t63;
+    const auto s0 = t59 ^ t63;
+    const auto s6 = t56 ^ ~t62;
+    const auto s7 = t48 ^ ~t60;
+    const auto t67 = t64 ^ t65;
+    const auto s3 = t53 ^ t66;
+    const auto s4 = t51 ^ t66;
+    const auto s5 = t47 ^ t65;
+    const auto s1 = t64 ^ ~s3;
+    const auto s2 = t55 ^ ~t67;
+
+    q[7] = s0;
+    q[6] = s1;
+    q[5] = s2;
+    q[4] = s3;
+    q[3] = s4;
+    q[2] = s5;
+    q[1] = s6;
+    q[0] = s7;
+}
+
+/**
+ * Inverse of the affine transformation including its 0x63 constant.
+ */
+void inverse_affine(BitslicedState &q)
+{
+    const std::array<Slice, 8> x{ ~q[0], ~q[1], q[2], q[3], q[4], ~q[5], ~q[6], q[7] };
+    for (size_t i = 0; i < 8; ++i)
+    {
+        q[i] = x[(i + 2) % 8] ^ x[(i + 5) % 8] ^ x[(i + 7) % 8];
+    }
+}
+
+/**
+ * Inverse S-box is inv(A^-1(y)) = A^-1(S(A^-1(y))), reusing the forward circuit.
+ */
+void inverse_sub_bytes(BitslicedState &q)
+{
+    inverse_affine(q);
+    sub_bytes(q);
+    inverse_affine(q);
+}
+
+void shift_rows(BitslicedState &q)
+{
+    for (auto &plane: q)
+    {
+        plane = apply(plane, [](uint64_t x)
+        {
+            return (x & 0x000F000F000F000F)
+                   | rotate_right(x & 0x00F000F000F000F0, 16)
+                   | rotate_right(x & 0x0F000F000F000F00, 32)
+                   | rotate_right(x & 0xF000F000F000F000, 48);
+        });
+    }
+}
+
+void inverse_shift_rows(BitslicedState &q)
+{
+    for (auto &plane: q)
+    {
+        plane = apply(plane, [](uint64_t x)
+        {
+            return (x & 0x000F000F000F000F)
+                   | rotate_right(x & 0x00F000F000F000F0, 48)
+                   | rotate_right(x & 0x0F000F000F000F00, 32)
+                   | rotate_right(x & 0xF000F000F000F000, 16);
+        });
+    }
+}
+
+/**
+ * Row r of every column takes the byte of row r + 1.
+ */
+inline Slice rotate_rows_1(const Slice &plane)
+{
+    return apply(plane, [](uint64_t x)
+    {
+        return ((x >> 4) & 0x0FFF0FFF0FFF0FFF) | ((x << 12) & 0xF000F000F000F000);
+    });
+}
+
+inline Slice rotate_rows_2(const Slice &plane)
+{
+    return apply(plane, [](uint64_t x)
+    {
+        return ((x >> 8) & 0x00FF00FF00FF00FF) | ((x << 8) & 0xFF00FF00FF00FF00);
+    });
+}
+
+/**
+ * Multiplication by x modulo x^8 + x^4 + x^3 + x + 1.
+ */
+BitslicedState multiply_by_x(const BitslicedState &q)
+{
+    return { q[7], q[0] ^ q[7], q[1], q[2] ^ q[7], q[3] ^ q[7], q[4], q[5], q[6] };
+}
+
+/**
+ * 2a[r] + 3a[r+1] + a[r+2] + a[r+3] = 2s[r] + a[r+1] + s[r+2], where s[r] = a[r] + a[r+1].
+ */
+void mix_columns(BitslicedState &q)
+{
+    BitslicedState rotated{};
+    BitslicedState sum{};
+    for (size_t i = 0; i < 8; ++i)
+    {
+        rotated[i] = rotate_rows_1(q[i]);
+        sum[i] = q[i] ^ rotated[i];
+    }
+    const auto doubled = multiply_by_x(sum);
+    for (size_t i = 0; i < 8; ++i)
+    {
+        q[i] = doubled[i] ^ rotated[i] ^ rotate_rows_2(sum[i]);
+    }
+}
+
+/**
+ * InvMixColumns polynomial factors into MixColumns one and 4x^2 + 5: b[r] = a[r] + 4(a[r] + a[r+2]).
+ */
+void inverse_mix_columns(BitslicedState &q)
+{
+    BitslicedState sum{};
+    for (size_t i = 0; i < 8; ++i)
+    {
+        sum[i] = q[i] ^ rotate_rows_2(q[i]);
+    }
+    const auto quadrupled = multiply_by_x(multiply_by_x(sum));
+    for (size_t i = 0; i < 8; ++i)
+    {
+        q[i] = q[i] ^ quadrupled[i];
+    }
+    mix_columns(q);
+}
+
+void add_round_key(BitslicedState &q, const BitslicedState &round_key)
+{
+    for (size_t i = 0; i < 8; ++i)
+    {
+        q[i] = q[i] ^ round_key[i];
+    }
+}
+
+void store_column(uint32_t word, unsigned char *bytes)
+{
+    for (size_t i = 0; i < 4; ++i)
+    {
+        bytes[i] = (word >> (8 * i)) & 0xFF;
+    }
+}
+
+uint32_t load_column(const unsigned char *bytes)
+{
+    uint32_t result = 0;
+    for (size_t i = 4; i-- > 0;)
+    {
+        result = result << 8 | bytes[i];
+    }
+    return result;
+}
+
+/**
+ * Round keys copied into every block slot.
+ */
+using BitslicedRoundKeys = std::array<BitslicedState, 15>;
+
+BitslicedRoundKeys pack_round_keys(const uint32_t *schedule_key, size_t rounds)
+{
+    BitslicedRoundKeys result{};
+    std::array<unsigned char, 16 * parallel_blocks> blocks{};
+    for (size_t round = 0; round <= rounds; ++round)
+    {
+        for (size_t block = 0; block < parallel_blocks; ++block)
+        {
+            for (size_t i = 0; i < 4; ++i)
+            {
+                store_column(schedule_key[4 * round + i], blocks.data() + 16 * block + 4 * i);
+            }
+        }
+        result[round] = pack(blocks.data());
+    }
+    return result;
+}
+
+void encrypt_blocks(unsigned char *blocks, const BitslicedRoundKeys &round_keys, size_t rounds)
+{
+    auto q = pack(blocks);
+    add_round_key(q, round_keys[0]);
+    for (size_t round = 1; round < rounds; ++round)
+    {
+        sub_bytes(q);
+        shift_rows(q);
+        mix_columns(q);
+        add_round_key(q, round_keys[round]);
+    }
+    sub_bytes(q);
+    shift_rows(q);
+    add_round_key(q, round_keys[rounds]);
+    unpack(q, blocks);
+}
+
+/**
+ * Equivalent inverse cipher, same schedule as the other backends.
+ */
+void decrypt_blocks(unsigned char *blocks, const BitslicedRoundKeys &round_keys, size_t rounds)
+{
+    auto q = pack(blocks);
+    add_round_key(q, round_keys[0]);
+    for (size_t round = 1; round < rounds; ++round)
+    {
+        inverse_sub_bytes(q);
+        inverse_shift_rows(q);
+        inverse_mix_columns(q);
+        add_round_key(q, round_keys[round]);
+    }
+    inverse_sub_bytes(q);
+    inverse_shift_rows(q);
+    add_round_key(q, round_keys[rounds]);
+    unpack(q, blocks);
+}
+
+uint32_t substitute_word(uint32_t word)
+{
+    std::array<unsigned char, 16 * parallel_blocks> blocks{};
+    store_column(word, blocks.data());
+    auto q = pack(blocks.data());
+    sub_bytes(q);
+    unpack(q, blocks.data());
+    return load_column(blocks.data());
+}
+
+void aes_bitsliced_build_schedule_key(const unsigned char *key, size_t key_length, uint32_t *encrypt_key,
+        uint32_t *decrypt_key)
+{
+    const size_t key_words = key_length / 4;
+    const size_t rounds = key_words + 6;
+    for (size_t i = 0; i < key_words; ++i)
+    {
+        encrypt_key[i] = load_column(key + 4 * i);
+    }
+    uint32_t round_constant = 0x01;
+    for (size_t i = key_words; i < 4 * (rounds + 1); ++i)
+    {
+        auto word = encrypt_key[i - 1];
+        if (i % key_words == 0)
+        {
+            word = substitute_word(word >> 8 | word << 24) ^ round_constant;
+            round_constant = (round_constant << 1) ^ (0x11b & (0u - (round_constant >> 7)));
+        }
+        else if (key_words > 6 && i % key_words == 4)
+        {
+            word = substitute_word(word);
+        }
+        encrypt_key[i] = encrypt_key[i - key_words] ^ word;
+    }
+    if (decrypt_key == nullptr)
+    {
+        return;
+    }
+    // inner round keys go through InvMixColumns, up to 8 of them at once
+    std::copy_n(encrypt_key + 4 * rounds, 4, decrypt_key);
+    std::copy_n(encrypt_key, 4, decrypt_key + 4 * rounds);
+    for (size_t first = 1; first < rounds; first += parallel_blocks)
+    {
+        const auto count = std::min(parallel_blocks, rounds - first);
+        std::array<unsigned char, 16 * parallel_blocks> blocks{};
+        for (size_t j = 0; j < count; ++j)
+        {
+            for (size_t i = 0; i < 4; ++i)
+            {
+                store_column(encrypt_key[4 * (rounds - first - j) + i], blocks.data() + 16 * j + 4 * i);
+            }
+        }
+        auto q = pack(blocks.data());
+        inverse_mix_columns(q);
+        unpack(q, blocks.data());
+        for (size_t j = 0; j < count; ++j)
+        {
+            for (size_t i = 0; i < 4; ++i)
+            {
+                decrypt_key[4 * (first + j) + i] = load_column(blocks.data() + 16 * j + 4 * i);
+            }
+        }
+    }
+}
+
+void aes_bitsliced_cbc_encrypt(const unsigned char *input, unsigned char *output, size_t size,
+        const unsigned char *iv, const uint32_t *schedule_key, size_t rounds)
+{
+    // chaining allows only one block at a time, other slots are idle
+    const auto round_keys = pack_round_keys(schedule_key, rounds);
+    std::array<unsigned char, 16 * parallel_blocks> blocks{};
+    std::copy_n(iv, 16, blocks.begin());
+    for (size_t i = 0; i < size; i += 16)
+    {
+        for (size_t j = 0; j < 16; ++j)
+        {
+            blocks[j] ^= input[i + j];
+        }
+        encrypt_blocks(blocks.data(), round_keys, rounds);
+        std::copy_n(blocks.begin(), 16, output + i);
+    }
+}
+
+void aes_bitsliced_cbc_decrypt(const unsigned char *input, unsigned char *output, size_t size,
+        const unsigned char *iv, const uint32_t *schedule_key, size_t rounds)
+{
+    const auto round_keys = pack_round_keys(schedule_key, rounds);
+    std::array<unsigned char, 16 * (parallel_blocks + 1)> cypher_blocks{};
+    std::array<unsigned char, 16 * parallel_blocks> blocks{};
+    std::copy_n(iv, 16, cypher_blocks.begin());
+    for (size_t i = 0; i < size; i += blocks.size())
+    {
+        // cypher_blocks starts with the previous cypher block, then the blocks of this batch
+        const auto batch = std::min(blocks.size(), size - i);
+        std::copy_n(input + i, batch, cypher_blocks.begin() + 16);
+        std::copy_n(input + i, batch, blocks.begin());
+        decrypt_blocks(blocks.data(), round_keys, rounds);
+        for (size_t j = 0; j < batch; ++j)
+        {
+            output[i + j] = blocks[j] ^ cypher_blocks[j];
+        }
+        std::copy_n(cypher_blocks.begin() + batch, 16, cypher_blocks.begin());
+    }
+}
+
+void aes_bitsliced_ctr_crypt(const unsigned char *input, unsigned char *output, size_t size,
+        const unsigned char *counter, const uint32_t *schedule_key, size_t rounds)
+{
+    const auto round_keys = pack_round_keys(schedule_key, rounds);
+    std::array<unsigned char, 16> next_counter{};
+    std::copy_n(counter, 16, next_counter.begin());
+    std::array<unsigned char, 16 * parallel_blocks> blocks{};
+    for (size_t i = 0; i < size; i += blocks.size())
+    {
+        for (size_t block = 0; block < parallel_blocks; ++block)
+        {
+            std::copy(next_counter.begin(), next_counter.end(), blocks.begin() + 16 * block);
+            // constant time increment, carry propagates through all bytes
+            unsigned int carry = 1;
+            for (size_t j = 16; j-- > 0;)
+            {
+                carry += next_counter[j];
+                next_counter[j] = carry & 0xFF;
+                carry >>= 8;
+            }
+        }
+        encrypt_blocks(blocks.data(), round_keys, rounds);
+        const auto batch = std::min(blocks.size(), size - i);
+        for (size_t j = 0; j < batch; ++j)
+        {
+            output[i + j] = input[i + j] ^ blocks[j];
+        }
+    }
+}
@@ -0,0 +1,28 @@
+#ifndef TLS_PLAYGROUND_AES_BITSLICED_HPP
+#define TLS_PLAYGROUND_AES_BITSLICED_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Constant time AES without table lookups: 8 blocks are transposed into 8 bit planes and every round
+ * is a fixed sequence of boolean operations, so neither branches nor memory access depend on keys or data.
+ * Schedule keys have the layout of the other backends.
+ */
+
+void aes_bitsliced_build_schedule_key(const unsigned char *key, size_t key_length, uint32_t *encrypt_key,
+        uint32_t *decrypt_key);
+
+void aes_bitsliced_cbc_encrypt(const unsigned char *input, unsigned char *output, size_t size,
+        const unsigned char *iv, const uint32_t *schedule_key, size_t rounds);
+
+/**
+ * Output may alias input.
+ */
+void aes_bitsliced_cbc_decrypt(const unsigned char *input, unsigned char *output, size_t size,
+        const unsigned char *iv, const uint32_t *schedule_key, size_t rounds);
+
+void aes_bitsliced_ctr_crypt(const unsigned char *input, unsigned char *output, size_t size,
+        const unsigned char *counter, const uint32_t *schedule_key, size_t rounds);
+
+#endif //TLS_PLAYGROUND_AES_BITSLICED_HPP
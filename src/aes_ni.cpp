@@ -0,0 +1,292 @@
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include "cpu_features.hpp"
+
+#include "aes_ni.hpp"
+
+#if TLS_PLAYGROUND_X86
+
+#include <immintrin.h>
+
+TLS_PLAYGROUND_TARGET("sse2")
+inline void load_round_keys(const uint32_t *schedule_key, size_t rounds, __m128i *round_keys)
+{
+    for (size_t i = 0; i <= rounds; ++i)
+    {
+        round_keys[i] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(schedule_key + 4 * i));
+    }
+}
+
+TLS_PLAYGROUND_TARGET("aes,sse2")
+void aes_ni_build_schedule_key(const unsigned char *key, size_t key_length, uint32_t *encrypt_key,
+        uint32_t *decrypt_key)
+{
+    const size_t key_words = key_length / 4;
+    const size_t rounds = key_words + 6;
+    std::memcpy(encrypt_key, key, key_length);
+    uint32_t round_constant = 0x01;
+    for (size_t i = key_words; i < 4 * (rounds + 1); ++i)
+    {
+        auto word = encrypt_key[i - 1];
+        if (i % key_words == 0 || (key_words > 6 && i % key_words == 4))
+        {
+            // word goes to column 1: result column 0 is SubWord, column 1 is RotWord(SubWord)
+            const auto assist = _mm_aeskeygenassist_si128(_mm_set_epi32(0, 0, static_cast<int>(word), 0), 0);
+            if (i % key_words == 0)
+            {
+                word = static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_shuffle_epi32(assist, 0x55))) ^ round_constant;
+                round_constant = (round_constant << 1) ^ ((round_constant & 0x80) != 0 ? 0x11b : 0);
+            }
+            else
+            {
+                word = static_cast<uint32_t>(_mm_cvtsi128_si32(assist));
+            }
+        }
+        encrypt_key[i] = encrypt_key[i - key_words] ^ word;
+    }
+    if (decrypt_key == nullptr)
+    {
+        return;
+    }
+    auto *decrypt = reinterpret_cast<__m128i *>(decrypt_key);
+    const auto *encrypt = reinterpret_cast<const __m128i *>(encrypt_key);
+    _mm_storeu_si128(decrypt, _mm_loadu_si128(encrypt + rounds));
+    for (size_t round = 1; round < rounds; ++round)
+    {
+        _mm_storeu_si128(decrypt + round, _mm_aesimc_si128(_mm_loadu_si128(encrypt + rounds - round)));
+    }
+    _mm_storeu_si128(decrypt + rounds, _mm_loadu_si128(encrypt));
+}
+
+TLS_PLAYGROUND_TARGET("aes,sse2")
+void aes_ni_cbc_encrypt(const unsigned char *input, unsigned char *output, size_t size, const unsigned char *iv,
+        const uint32_t *schedule_key, size_t rounds)
+{
+    __m128i keys[15];
+    load_round_keys(schedule_key, rounds, keys);
+    auto block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(iv));
+    for (size_t i = 0; i < size; i += 16)
+    {
+        block = _mm_xor_si128(block, _mm_loadu_si128(reinterpret_cast<const __m128i *>(input + i)));
+        block = _mm_xor_si128(block, keys[0]);
+        for (size_t round = 1; round < rounds; ++round)
+        {
+            block = _mm_aesenc_si128(block, keys[round]);
+        }
+        block = _mm_aesenclast_si128(block, keys[rounds]);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(output + i), block);
+    }
+}
+
+TLS_PLAYGROUND_TARGET("aes,sse2")
+void aes_ni_cbc_encrypt_many(AesNiCbcStream *streams, size_t count, size_t rounds)
+{
+    constexpr size_t lanes = 8;
+    AesNiCbcStream *lane_streams[lanes];
+    const __m128i *lane_keys[lanes];
+    size_t offsets[lanes];
+    __m128i blocks[lanes];
+    size_t active = 0;
+    size_t next = 0;
+    while (true)
+    {
+        while (active < lanes && next < count)
+        {
+            auto &stream = streams[next++];
+            if (stream.size == 0)
+            {
+                continue;
+            }
+            lane_streams[active] = &stream;
+            lane_keys[active] = reinterpret_cast<const __m128i *>(stream.schedule_key);
+            offsets[active] = 0;
+            blocks[active] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(stream.iv));
+            ++active;
+        }
+        if (active == 0)
+        {
+            break;
+        }
+        for (size_t lane = 0; lane < active; ++lane)
+        {
+            const auto *input = lane_streams[lane]->data + offsets[lane];
+            blocks[lane] = _mm_xor_si128(blocks[lane], _mm_loadu_si128(reinterpret_cast<const __m128i *>(input)));
+            blocks[lane] = _mm_xor_si128(blocks[lane], _mm_loadu_si128(lane_keys[lane]));
+        }
+        for (size_t round = 1; round < rounds; ++round)
+        {
+            for (size_t lane = 0; lane < active; ++lane)
+            {
+                blocks[lane] = _mm_aesenc_si128(blocks[lane], _mm_loadu_si128(lane_keys[lane] + round));
+            }
+        }
+        for (size_t lane = 0; lane < active; ++lane)
+        {
+            blocks[lane] = _mm_aesenclast_si128(blocks[lane], _mm_loadu_si128(lane_keys[lane] + rounds));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(lane_streams[lane]->data + offsets[lane]), blocks[lane]);
+            offsets[lane] += 16;
+        }
+        for (size_t lane = active; lane-- > 0;)
+        {
+            if (offsets[lane] < lane_streams[lane]->size)
+            {
+                continue;
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(lane_streams[lane]->iv), blocks[lane]);
+            --active;
+            lane_streams[lane] = lane_streams[active];
+            lane_keys[lane] = lane_keys[active];
+            offsets[lane] = offsets[active];
+            blocks[lane] = blocks[active];
+        }
+    }
+}
+
+TLS_PLAYGROUND_TARGET("aes,sse2")
+void aes_ni_cbc_decrypt(const unsigned char *input, unsigned char *output, size_t size, const unsigned char *iv,
+        const uint32_t *schedule_key, size_t rounds)
+{
+    constexpr size_t lanes = 8;
+    __m128i keys[15];
+    load_round_keys(schedule_key, rounds, keys);
+    auto previous = _mm_loadu_si128(reinterpret_cast<const __m128i *>(iv));
+    size_t i = 0;
+    // blocks don't depend on each other, keep 8 of them in the aesdec pipeline
+    for (; i + 16 * lanes <= size; i += 16 * lanes)
+    {
+        __m128i cypher_blocks[lanes];
+        __m128i blocks[lanes];
+        for (size_t lane = 0; lane < lanes; ++lane)
+        {
+            cypher_blocks[lane] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(input + i + 16 * lane));
+            blocks[lane] = _mm_xor_si128(cypher_blocks[lane], keys[0]);
+        }
+        for (size_t round = 1; round < rounds; ++round)
+        {
+            for (auto &block: blocks)
+            {
+                block = _mm_aesdec_si128(block, keys[round]);
+            }
+        }
+        for (size_t lane = 0; lane < lanes; ++lane)
+        {
+            blocks[lane] = _mm_aesdeclast_si128(blocks[lane], keys[rounds]);
+            blocks[lane] = _mm_xor_si128(blocks[lane], lane == 0 ? previous : cypher_blocks[lane - 1]);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(output + i + 16 * lane), blocks[lane]);
+        }
+        previous = cypher_blocks[lanes - 1];
+    }
+    for (; i < size; i += 16)
+    {
+        const auto cypher_block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(input + i));
+        auto block = _mm_xor_si128(cypher_block, keys[0]);
+        for (size_t round = 1; round < rounds; ++round)
+        {
+            block = _mm_aesdec_si128(block, keys[round]);
+        }
+        block = _mm_aesdeclast_si128(block, keys[rounds]);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(output + i), _mm_xor_si128(block, previous));
+        previous = cypher_block;
+    }
+}
+
+inline void increment_counter(unsigned char *counter)
+{
+    for (size_t i = 16; i-- > 0;)
+    {
+        if (++counter[i] != 0)
+        {
+            return;
+        }
+    }
+}
+
+TLS_PLAYGROUND_TARGET("aes,sse2")
+void aes_ni_ctr_crypt(const unsigned char *input, unsigned char *output, size_t size, const unsigned char *counter,
+        const uint32_t *schedule_key, size_t rounds)
+{
+    constexpr size_t lanes = 8;
+    __m128i keys[15];
+    load_round_keys(schedule_key, rounds, keys);
+    unsigned char next_counter[16];
+    std::memcpy(next_counter, counter, 16);
+    unsigned char counters[16 * lanes];
+    for (size_t i = 0; i < size; i += 16 * lanes)
+    {
+        for (size_t lane = 0; lane < lanes; ++lane)
+        {
+            std::memcpy(counters + 16 * lane, next_counter, 16);
+            increment_counter(next_counter);
+        }
+        __m128i blocks[lanes];
+        for (size_t lane = 0; lane < lanes; ++lane)
+        {
+            blocks[lane] = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(counters + 16 * lane)),
+                    keys[0]);
+        }
+        for (size_t round = 1; round < rounds; ++round)
+        {
+            for (auto &block: blocks)
+            {
+                block = _mm_aesenc_si128(block, keys[round]);
+            }
+        }
+        for (auto &block: blocks)
+        {
+            block = _mm_aesenclast_si128(block, keys[rounds]);
+        }
+        const auto batch = std::min(16 * lanes, size - i);
+        if (batch == 16 * lanes)
+        {
+            for (size_t lane = 0; lane < lanes; ++lane)
+            {
+                const auto *source = reinterpret_cast<const __m128i *>(input + i + 16 * lane);
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(output + i + 16 * lane),
+                        _mm_xor_si128(_mm_loadu_si128(source), blocks[lane]));
+            }
+            continue;
+        }
+        unsigned char key_stream[16 * lanes];
+        for (size_t lane = 0; lane < lanes; ++lane)
+        {
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(key_stream + 16 * lane), blocks[lane]);
+        }
+        for (size_t j = 0; j < batch; ++j)
+        {
+            output[i + j] = input[i + j] ^ key_stream[j];
+        }
+    }
+}
+
+#else
+
+void aes_ni_build_schedule_key(const unsigned char *, size_t, uint32_t *, uint32_t *)
+{
+    throw std::runtime_error("aes-ni is not supported");
+}
+
+void aes_ni_cbc_encrypt(const unsigned char *, unsigned char *, size_t, const unsigned char *, const uint32_t *,
+        size_t)
+{
+    throw std::runtime_error("aes-ni is not supported");
+}
+
+void aes_ni_cbc_encrypt_many(AesNiCbcStream *, size_t, size_t)
+{
+    throw std::runtime_error("aes-ni is not supported");
+}
+
+void aes_ni_cbc_decrypt(const unsigned char *, unsigned char *, size_t, const unsigned char *, const uint32_t *,
+        size_t)
+{
+    throw std::runtime_error("aes-ni is not supported");
+}
+
+void aes_ni_ctr_crypt(const unsigned char *, unsigned char *, size_t, const unsigned char *, const uint32_t *, size_t)
+{
+    throw std::runtime_error("aes-ni is not supported");
+}
+
+#endif
@@ -0,0 +1,45 @@
+#ifndef TLS_PLAYGROUND_AES_NI_HPP
+#define TLS_PLAYGROUND_AES_NI_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * AES-NI backend. Schedule keys have the layout of the portable implementation: 4 * (rounds + 1) little endian
+ * column words, decryption schedule in equivalent inverse cipher form. Callers must check cpu_features().aes,
+ * on other architectures every function throws.
+ */
+
+void aes_ni_build_schedule_key(const unsigned char *key, size_t key_length, uint32_t *encrypt_key,
+        uint32_t *decrypt_key);
+
+void aes_ni_cbc_encrypt(const unsigned char *input, unsigned char *output, size_t size, const unsigned char *iv,
+        const uint32_t *schedule_key, size_t rounds);
+
+/**
+ * Independent CBC encryption stream, data is encrypted in place and iv receives the last cypher block.
+ */
+struct AesNiCbcStream
+{
+    const uint32_t *schedule_key;
+    unsigned char *iv;
+    unsigned char *data;
+    size_t size;
+};
+
+/**
+ * Encrypts up to 8 streams in lockstep, one block of each per step, refilling lanes as streams finish.
+ * All streams must use the same number of rounds.
+ */
+void aes_ni_cbc_encrypt_many(AesNiCbcStream *streams, size_t count, size_t rounds);
+
+void aes_ni_cbc_decrypt(const unsigned char *input, unsigned char *output, size_t size, const unsigned char *iv,
+        const uint32_t *schedule_key, size_t rounds);
+
+/**
+ * CTR key stream xor for any size, counter is the 128-bit big endian counter of the first block.
+ */
+void aes_ni_ctr_crypt(const unsigned char *input, unsigned char *output, size_t size, const unsigned char *counter,
+        const uint32_t *schedule_key, size_t rounds);
+
+#endif //TLS_PLAYGROUND_AES_NI_HPP
@@ -0,0 +1,70 @@
+#ifndef TLS_PLAYGROUND_BIT_PERMUTATION_HPP
+#define TLS_PLAYGROUND_BIT_PERMUTATION_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+/**
+ * Bit permutation with a table fixed at compile time, expanded into one lookup table per input byte. An entry holds
+ * the output bits its byte value contributes, so permuting is one lookup and OR per input byte instead of
+ * a test and set per bit. Tables follow DES conventions: output bit i takes input bit table[i], bits are numbered
+ * from 1, most significant first. Output may repeat or drop input bits, like expansion and compression tables.
+ */
+template<size_t input_bytes, size_t output_bits>
+class BytePermutation
+{
+    static_assert(input_bytes <= 8 && output_bits <= 64);
+
+public:
+    using Word = std::conditional_t<(output_bits <= 32), uint32_t, uint64_t>;
+
+private:
+    std::array<std::array<Word, 256>, input_bytes> tables{};
+
+public:
+    consteval explicit BytePermutation(const std::array<unsigned int, output_bits> &table)
+    {
+        for (size_t i = 0; i < output_bits; ++i)
+        {
+            const auto index = table[i] - 1;
+            const auto output_bit = Word{ 1 } << (output_bits - 1 - i);
+            for (size_t value = 0; value < 256; ++value)
+            {
+                if ((value & (0x80 >> index % 8)) != 0)
+                {
+                    tables[index / 8][value] |= output_bit;
+                }
+            }
+        }
+    }
+
+    /**
+     * @return output bits right aligned, output bit 1 is the most significant of them
+     */
+    constexpr Word operator()(const std::array<unsigned char, input_bytes> &input) const
+    {
+        Word result = 0;
+        for (size_t i = 0; i < input_bytes; ++i)
+        {
+            result |= tables[i][input[i]];
+        }
+        return result;
+    }
+
+    /**
+     * @param input right aligned input bits, input bit 1 is the most significant of the input_bytes * 8 bits
+     */
+    constexpr Word operator()(uint64_t input) const
+    {
+        Word result = 0;
+        for (size_t i = 0; i < input_bytes; ++i)
+        {
+            result |= tables[i][(input >> (8 * (input_bytes - 1 - i))) & 0xFF];
+        }
+        return result;
+    }
+};
+
+#endif //TLS_PLAYGROUND_BIT_PERMUTATION_HPP
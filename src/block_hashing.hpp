@@ -0,0 +1,299 @@
+#ifndef TLS_PLAYGROUND_BLOCK_HASHING_HPP
+#define TLS_PLAYGROUND_BLOCK_HASHING_HPP
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+/**
+ * Pieces shared by the Merkle-Damgard hashes: MD5 stores words, message length and digest little endian,
+ * the SHA family big endian.
+ */
+
+template<std::endian byte_order>
+uint32_t load_word32(const unsigned char *bytes)
+{
+    if constexpr (byte_order == std::endian::big)
+    {
+        return static_cast<uint32_t>(bytes[0]) << 24 | static_cast<uint32_t>(bytes[1]) << 16 |
+               static_cast<uint32_t>(bytes[2]) << 8 | bytes[3];
+    }
+    else
+    {
+        return static_cast<uint32_t>(bytes[3]) << 24 | static_cast<uint32_t>(bytes[2]) << 16 |
+               static_cast<uint32_t>(bytes[1]) << 8 | bytes[0];
+    }
+}
+
+/**
+ * Pads the unprocessed tail of a message into one or two final blocks. The length field takes the last 8 bytes
+ * of 64 byte blocks and the last 16 of 128 byte blocks, its upper half is always zero here.
+ * @return number of blocks written to the start of blocks
+ */
+template<std::endian byte_order, size_t padding_size>
+size_t pad_final_blocks(const unsigned char *tail, size_t tail_size, uint64_t message_size,
+        std::array<unsigned char, padding_size> &blocks)
+{
+    constexpr size_t block_size = padding_size / 2;
+    constexpr size_t length_size = block_size / 8;
+    const size_t count = tail_size < block_size - length_size ? 1 : 2;
+    std::fill_n(blocks.begin(), block_size * count, 0);
+    std::copy_n(tail, tail_size, blocks.begin());
+    blocks[tail_size] = 0x80;
+    const auto bits = message_size * 8;
+    for (size_t i = 0; i < 8; ++i)
+    {
+        const auto position = byte_order == std::endian::big ? block_size * count - 1 - i
+                                                             : block_size * count - length_size + i;
+        blocks[position] = (bits >> (8 * i)) & 0xFF;
+    }
+    return count;
+}
+
+/**
+ * Serialisation of the leading state words, truncated to the digest size.
+ */
+template<std::endian byte_order, size_t hash_size, typename Word, size_t state_size>
+std::array<unsigned char, hash_size> store_hash(const std::array<Word, state_size> &state)
+{
+    std::array<unsigned char, hash_size> result{};
+    for (size_t i = 0; i < result.size(); ++i)
+    {
+        const auto byte = byte_order == std::endian::big ? sizeof(Word) - 1 - i % sizeof(Word) : i % sizeof(Word);
+        result[i] = (state[i / sizeof(Word)] >> (byte * 8)) & 0xFF;
+    }
+    return result;
+}
+
+/**
+ * Incremental hashing, close() returns the digest and starts over. Copy the object to finish a common prefix
+ * several times, a midstate does the same for block aligned prefixes with just the chaining state.
+ */
+template<typename Algorithm>
+class BlockHashing
+{
+public:
+    static constexpr size_t block_size = Algorithm::block_size;
+
+    using State = std::array<typename Algorithm::Word, Algorithm::state_words>;
+
+    /**
+     * Chaining state after a whole number of blocks, e.g. after the key block of HMAC.
+     */
+    struct Midstate
+    {
+        State state;
+        uint64_t size;
+    };
+
+private:
+    State state;
+    std::array<unsigned char, Algorithm::block_size> block_buffer{};
+    size_t buffer_pos{};
+    uint64_t input_size{};
+public:
+    BlockHashing();
+
+    explicit BlockHashing(const Midstate &midstate);
+
+    void append(std::span<const unsigned char> input);
+
+    void append(const std::vector<unsigned char> &input);
+
+    /**
+     * @throws std::runtime_error when appended data doesn't end on a block boundary
+     */
+    [[nodiscard]]
+    Midstate get_midstate() const;
+
+    std::array<unsigned char, Algorithm::digest_size> close();
+};
+
+template<typename Algorithm>
+BlockHashing<Algorithm>::BlockHashing() : state(Algorithm::initial_hash)
+{
+
+}
+
+template<typename Algorithm>
+BlockHashing<Algorithm>::BlockHashing(const Midstate &midstate) : state(midstate.state), input_size(midstate.size)
+{
+    if (input_size % block_buffer.size() != 0)
+    {
+        throw std::runtime_error("midstate must cover whole blocks");
+    }
+}
+
+template<typename Algorithm>
+void BlockHashing<Algorithm>::append(std::span<const unsigned char> input)
+{
+    const auto *data = input.data();
+    auto remains = input.size();
+    input_size += remains;
+    if (buffer_pos > 0)
+    {
+        const auto copy = std::min(block_buffer.size() - buffer_pos, remains);
+        std::copy_n(data, copy, block_buffer.begin() + buffer_pos);
+        buffer_pos += copy;
+        data += copy;
+        remains -= copy;
+        if (buffer_pos < block_buffer.size())
+        {
+            return;
+        }
+        Algorithm::compress(state, block_buffer.data(), 1);
+        buffer_pos = 0;
+    }
+    // whole blocks are hashed straight from the input
+    const auto full_blocks = remains / block_buffer.size();
+    Algorithm::compress(state, data, full_blocks);
+    data += full_blocks * block_buffer.size();
+    remains -= full_blocks * block_buffer.size();
+    std::copy_n(data, remains, block_buffer.begin());
+    buffer_pos = remains;
+}
+
+template<typename Algorithm>
+void BlockHashing<Algorithm>::append(const std::vector<unsigned char> &input)
+{
+    append(std::span(input));
+}
+
+template<typename Algorithm>
+typename BlockHashing<Algorithm>::Midstate BlockHashing<Algorithm>::get_midstate() const
+{
+    if (buffer_pos != 0)
+    {
+        throw std::runtime_error("midstate must cover whole blocks");
+    }
+    return { state, input_size };
+}
+
+template<typename Algorithm>
+std::array<unsigned char, Algorithm::digest_size> BlockHashing<Algorithm>::close()
+{
+    std::array<unsigned char, 2 * Algorithm::block_size> padding{};
+    const auto padding_blocks = pad_final_blocks<Algorithm::byte_order>(block_buffer.data(), buffer_pos,
+            input_size, padding);
+    Algorithm::compress(state, padding.data(), padding_blocks);
+    const auto result = store_hash<Algorithm::byte_order, Algorithm::digest_size>(state);
+    input_size = 0;
+    buffer_pos = 0;
+    state = Algorithm::initial_hash;
+    return result;
+}
+
+/**
+ * Message currently hashed in one lane of a multi-buffer hash: whole blocks come straight from the input,
+ * the final one or two from padding.
+ */
+template<std::endian byte_order>
+struct LaneMessage
+{
+    std::span<const unsigned char> message;
+    size_t index{};
+    size_t block{};
+    size_t full_blocks{};
+    size_t padding_blocks{};
+    std::array<unsigned char, 128> padding{};
+
+    void start(std::span<const unsigned char> next_message, size_t next_index)
+    {
+        message = next_message;
+        index = next_index;
+        block = 0;
+        full_blocks = message.size() / 64;
+        padding_blocks = pad_final_blocks<byte_order>(message.data() + 64 * full_blocks, message.size() % 64,
+                message.size(), padding);
+    }
+
+    [[nodiscard]]
+    const unsigned char *current_block() const
+    {
+        return block < full_blocks ? message.data() + 64 * block : padding.data() + 64 * (block - full_blocks);
+    }
+
+    [[nodiscard]]
+    bool finished() const
+    {
+        return block == full_blocks + padding_blocks;
+    }
+};
+
+/**
+ * Hashes independent messages of 64 byte blocks and 32-bit words in SIMD lanes. Lanes take the next message
+ * as soon as their current one is finished, so lengths may differ freely.
+ * @param compress one block of every lane, state and words transposed to [i * lanes + l]
+ */
+template<size_t lanes, std::endian byte_order, size_t state_words, size_t digest_size>
+void hash_lanes(std::span<const std::span<const unsigned char>> messages,
+        std::vector<std::array<unsigned char, digest_size>> &result,
+        const std::array<uint32_t, state_words> &initial_hash,
+        const uint32_t *round_constants,
+        void (*compress)(uint32_t *, const uint32_t *, const uint32_t *))
+{
+    alignas(64) std::array<uint32_t, state_words * lanes> state{};
+    alignas(64) std::array<uint32_t, 16 * lanes> words{};
+    std::array<LaneMessage<byte_order>, lanes> lane_messages{};
+    // lanes without a message are masked out: they hash this block and their state is never read
+    const std::array<unsigned char, 64> idle_block{};
+    std::array<bool, lanes> active{};
+    size_t next_message = 0;
+    const auto start_message = [&](size_t lane)
+    {
+        active[lane] = next_message < messages.size();
+        if (!active[lane])
+        {
+            return;
+        }
+        lane_messages[lane].start(messages[next_message], next_message);
+        ++next_message;
+        for (size_t i = 0; i < state_words; ++i)
+        {
+            state[i * lanes + lane] = initial_hash[i];
+        }
+    };
+    for (size_t lane = 0; lane < lanes; ++lane)
+    {
+        start_message(lane);
+    }
+    while (std::ranges::find(active, true) != active.end())
+    {
+        for (size_t lane = 0; lane < lanes; ++lane)
+        {
+            const auto *block = active[lane] ? lane_messages[lane].current_block() : idle_block.data();
+            for (size_t i = 0; i < 16; ++i)
+            {
+                words[i * lanes + lane] = load_word32<byte_order>(block + 4 * i);
+            }
+        }
+        compress(state.data(), words.data(), round_constants);
+        for (size_t lane = 0; lane < lanes; ++lane)
+        {
+            auto &current = lane_messages[lane];
+            if (!active[lane])
+            {
+                continue;
+            }
+            ++current.block;
+            if (!current.finished())
+            {
+                continue;
+            }
+            std::array<uint32_t, state_words> lane_state{};
+            for (size_t i = 0; i < state_words; ++i)
+            {
+                lane_state[i] = state[i * lanes + lane];
+            }
+            result[current.index] = store_hash<byte_order, digest_size>(lane_state);
+            start_message(lane);
+        }
+    }
+}
+
+#endif //TLS_PLAYGROUND_BLOCK_HASHING_HPP
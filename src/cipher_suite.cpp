@@ -1,9 +1,42 @@
 #include <stdexcept>
 
 #include "aes.hpp"
+#include "des.hpp"
 
 #include "cipher_suite.hpp"
 
+/**
+ * Appends TLS block padding and encrypts the payload in place, last cypher block becomes the next record iv.
+ */
+template<size_t block_size>
+void cbc_encrypt_record(TlsRecord &record, std::array<unsigned char, block_size> &iv, auto cbc_encrypt)
+{
+    auto padding = block_size - record.payload.size() % block_size;
+    record.payload.insert(record.payload.end(), padding, padding - 1);
+    cbc_encrypt(std::span(record.payload), iv);
+    std::copy(record.payload.end() - iv.size(), record.payload.end(), iv.begin());
+}
+
+template<size_t block_size>
+void cbc_decrypt_record(TlsRecord &record, std::array<unsigned char, block_size> &iv, auto cbc_decrypt)
+{
+    auto &payload = record.payload;
+    if (payload.empty() || payload.size() % block_size != 0)
+    {
+        throw std::runtime_error("tls error: malformed payload");
+    }
+    // last cypher block chains into the next record, keep it before decrypting in place
+    std::array<unsigned char, block_size> next_iv{};
+    std::copy(payload.end() - next_iv.size(), payload.end(), next_iv.begin());
+    cbc_decrypt(std::span(payload), iv);
+    iv = next_iv;
+    if (payload.size() < payload.back() + 1u)
+    {
+        throw std::runtime_error("tls error: malformed payload");
+    }
+    payload.resize(payload.size() - payload.back() - 1);
+}
+
 Aes128CipherSuite::Aes128CipherSuite(const std::array<unsigned char, 16> &iv, const std::array<unsigned char, 16> &key)
         : iv(iv), key(key)
 {
@@ -12,20 +45,60 @@ Aes128CipherSuite::Aes128CipherSuite(const std::array<unsigned char, 16> &iv, co
 
 void Aes128CipherSuite::encrypt(TlsRecord &record)
 {
-    auto padding = 16 - record.payload.size() % 16;
-    record.payload.insert(record.payload.end(), padding, padding - 1);
-    record.payload = aes128_cbc_encrypt(record.payload, iv, key);
-    std::copy(record.payload.end() - iv.size(), record.payload.end(), iv.begin());
+    cbc_encrypt_record(record, iv, [this](auto payload, const auto &chain_iv)
+    {
+        aes_cbc_encrypt(payload, payload, chain_iv, key);
+    });
 }
 
 void Aes128CipherSuite::decrypt(TlsRecord &tls_record)
 {
-    std::vector<unsigned char> decrypted_block = aes128_cbc_decrypt(tls_record.payload, iv, key);
-    if (decrypted_block.empty() || decrypted_block.size() < decrypted_block.back())
+    cbc_decrypt_record(tls_record, iv, [this](auto payload, const auto &chain_iv)
     {
-        throw std::runtime_error("tls error: malformed payload");
-    }
-    decrypted_block.resize(decrypted_block.size() - decrypted_block.back() - 1);
-    std::copy(tls_record.payload.end() - iv.size(), tls_record.payload.end(), iv.begin());
-    tls_record.payload = decrypted_block;
+        aes_cbc_decrypt(payload, payload, chain_iv, key);
+    });
+}
+
+TripleDesCipherSuite::TripleDesCipherSuite(const std::array<unsigned char, 8> &iv,
+        const std::array<unsigned char, 24> &key) : iv(iv), key(key)
+{
+
+}
+
+void TripleDesCipherSuite::encrypt(TlsRecord &tls_record)
+{
+    cbc_encrypt_record(tls_record, iv, [this](auto payload, const auto &chain_iv)
+    {
+        des3_cbc_encrypt(payload, payload, key, chain_iv);
+    });
+}
+
+void TripleDesCipherSuite::decrypt(TlsRecord &tls_record)
+{
+    cbc_decrypt_record(tls_record, iv, [this](auto payload, const auto &chain_iv)
+    {
+        des3_cbc_decrypt(payload, payload, key, chain_iv);
+    });
+}
+
+DesCipherSuite::DesCipherSuite(const std::array<unsigned char, 8> &iv, const std::array<unsigned char, 8> &key)
+        : iv(iv), key(key)
+{
+
+}
+
+void DesCipherSuite::encrypt(TlsRecord &tls_record)
+{
+    cbc_encrypt_record(tls_record, iv, [this](auto payload, const auto &chain_iv)
+    {
+        des_cbc_encrypt(payload, payload, key, chain_iv);
+    });
+}
+
+void DesCipherSuite::decrypt(TlsRecord &tls_record)
+{
+    cbc_decrypt_record(tls_record, iv, [this](auto payload, const auto &chain_iv)
+    {
+        des_cbc_decrypt(payload, payload, key, chain_iv);
+    });
 }
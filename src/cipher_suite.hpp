@@ -3,6 +3,8 @@
 
 #include <array>
 
+#include "aes.hpp"
+#include "des.hpp"
 #include "tls_record_mac.hpp"
 
 class CipherSuite
@@ -33,7 +35,7 @@ public:
 class Aes128CipherSuite : public CipherSuite
 {
     std::array<unsigned char, 16> iv;
-    std::array<unsigned char, 16> key;
+    AesKey<128> key;
 public:
     Aes128CipherSuite(const std::array<unsigned char, 16> &iv, const std::array<unsigned char, 16> &key);
 
@@ -44,4 +46,38 @@ public:
     void decrypt(TlsRecord &tls_record) override;
 };
 
+/**
+ * TLS_RSA_WITH_3DES_EDE_CBC_SHA record cipher. Round keys are scheduled once per connection direction.
+ */
+class TripleDesCipherSuite : public CipherSuite
+{
+    std::array<unsigned char, 8> iv;
+    TripleDesKey key;
+public:
+    TripleDesCipherSuite(const std::array<unsigned char, 8> &iv, const std::array<unsigned char, 24> &key);
+
+    ~TripleDesCipherSuite() override = default;
+
+    void encrypt(TlsRecord &tls_record) override;
+
+    void decrypt(TlsRecord &tls_record) override;
+};
+
+/**
+ * TLS_RSA_WITH_DES_CBC_SHA record cipher.
+ */
+class DesCipherSuite : public CipherSuite
+{
+    std::array<unsigned char, 8> iv;
+    DesKey key;
+public:
+    DesCipherSuite(const std::array<unsigned char, 8> &iv, const std::array<unsigned char, 8> &key);
+
+    ~DesCipherSuite() override = default;
+
+    void encrypt(TlsRecord &tls_record) override;
+
+    void decrypt(TlsRecord &tls_record) override;
+};
+
 #endif //TLS_PLAYGROUND_CIPHER_SUITE_HPP
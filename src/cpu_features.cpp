@@ -0,0 +1,85 @@
+#include <array>
+#include <cstdint>
+
+#include "cpu_features.hpp"
+
+#if TLS_PLAYGROUND_X86
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+#if TLS_PLAYGROUND_X86
+
+std::array<uint32_t, 4> cpuid(uint32_t leaf, uint32_t subleaf)
+{
+    std::array<uint32_t, 4> result{};
+#if defined(_MSC_VER)
+    std::array<int, 4> registers{};
+    __cpuidex(registers.data(), static_cast<int>(leaf), static_cast<int>(subleaf));
+    for (size_t i = 0; i < result.size(); ++i)
+    {
+        result[i] = static_cast<uint32_t>(registers[i]);
+    }
+#else
+    __cpuid_count(leaf, subleaf, result[0], result[1], result[2], result[3]);
+#endif
+    return result;
+}
+
+/**
+ * XCR0: register state components enabled by the operating system.
+ */
+uint64_t read_xcr0()
+{
+#if defined(_MSC_VER)
+    return _xgetbv(0);
+#else
+    uint32_t eax;
+    uint32_t edx;
+    __asm__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return static_cast<uint64_t>(edx) << 32 | eax;
+#endif
+}
+
+CpuFeatures detect_cpu_features()
+{
+    CpuFeatures result{};
+    const auto max_leaf = cpuid(0, 0)[0];
+    if (max_leaf >= 1)
+    {
+        const auto ecx = cpuid(1, 0)[2];
+        result.aes = (ecx >> 25) & 1;
+        result.pclmul = (ecx >> 1) & 1;
+        // wide registers are usable only when the operating system saves them on context switch
+        const bool os_saves_state = (ecx >> 27) & 1;
+        const auto saved_state = os_saves_state ? read_xcr0() : 0;
+        const bool sse41 = (ecx >> 19) & 1;
+        if (max_leaf >= 7)
+        {
+            const auto ebx = cpuid(7, 0)[1];
+            // SHA extensions come with SSE4.1 in practice, but the backend needs both
+            result.sha = sse41 && ((ebx >> 29) & 1);
+            result.avx2 = (saved_state & 0x06) == 0x06 && ((ebx >> 5) & 1);
+            result.avx512 = (saved_state & 0xE6) == 0xE6 && ((ebx >> 16) & 1);
+        }
+    }
+    return result;
+}
+
+#else
+
+CpuFeatures detect_cpu_features()
+{
+    return {};
+}
+
+#endif
+
+CpuFeatures &cpu_features()
+{
+    static CpuFeatures features = detect_cpu_features();
+    return features;
+}
@@ -0,0 +1,35 @@
+#ifndef TLS_PLAYGROUND_CPU_FEATURES_HPP
+#define TLS_PLAYGROUND_CPU_FEATURES_HPP
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define TLS_PLAYGROUND_X86 1
+#else
+#define TLS_PLAYGROUND_X86 0
+#endif
+
+/**
+ * Enables instruction set extensions for a single function, so the rest of the library stays portable.
+ * MSVC allows intrinsics everywhere and needs no annotation.
+ */
+#if defined(__GNUC__) || defined(__clang__)
+#define TLS_PLAYGROUND_TARGET(features) __attribute__((target(features)))
+#else
+#define TLS_PLAYGROUND_TARGET(features)
+#endif
+
+struct CpuFeatures
+{
+    bool aes{};
+    bool pclmul{};
+    bool sha{};
+    bool avx2{};
+    bool avx512{};
+};
+
+/**
+ * Features of the running CPU, detected with CPUID on first call.
+ * Result is mutable so tests can switch hardware paths off and check portable fallbacks.
+ */
+CpuFeatures &cpu_features();
+
+#endif //TLS_PLAYGROUND_CPU_FEATURES_HPP
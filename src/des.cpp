@@ -1,5 +1,9 @@
 #include <algorithm>
+#include <bit>
+#include <cstdint>
 
+#include "bit_permutation.hpp"
+#include "des_bitsliced.hpp"
 #include "des.hpp"
 
 void schedule_key_rotl(std::array<unsigned char, 7> &key)
@@ -26,7 +30,7 @@ void schedule_key_rotr(std::array<unsigned char, 7> &key)
     key[6] = (0xFE & copy[6]) >> 1 | (0x01 & copy[5]) << 7;
 }
 
-const auto schedule_key_permutation_table = std::array<unsigned int, 56>{
+constexpr auto schedule_key_permutation_table = std::array<unsigned int, 56>{
         57, 49, 41, 33, 25, 17, 9, 1,
         58, 50, 42, 34, 26, 18, 10, 2,
         59, 51, 43, 35, 27, 19, 11, 3,
@@ -37,7 +41,7 @@ const auto schedule_key_permutation_table = std::array<unsigned int, 56>{
         28, 20, 12, 4
 };
 
-const auto schedule_key_reduce_table = std::array<unsigned int, 48>{
+constexpr auto schedule_key_reduce_table = std::array<unsigned int, 48>{
         14, 17, 11, 24, 1, 5,
         3, 28, 15, 6, 21, 10,
         23, 19, 12, 4, 26, 8,
@@ -48,57 +52,31 @@ const auto schedule_key_reduce_table = std::array<unsigned int, 48>{
         46, 42, 50, 36, 29, 32
 };
 
-std::array<std::array<unsigned char, 6>, 16> build_encrypt_schedule_key(const std::array<unsigned char, 8> &key)
-{
-    std::array<unsigned char, 7> permuted_key;
-    permute(permuted_key, key, schedule_key_permutation_table);
-    std::array<std::array<unsigned char, 6>, 16> schedule_keys{};
-    for (int round = 0; round < 16; round++)
-    {
-        schedule_key_rotl(permuted_key);
-        if (!(round <= 1 || round == 8 || round == 15))
-        {
-            // Rotate twice except in rounds 1, 2, 9 & 16
-            schedule_key_rotl(permuted_key);
-        }
-        permute(schedule_keys[round], permuted_key, schedule_key_reduce_table);
-    }
-    return schedule_keys;
-}
+constexpr BytePermutation<8, 56> schedule_key_permutation(schedule_key_permutation_table);
+
+constexpr BytePermutation<7, 48> schedule_key_reduction(schedule_key_reduce_table);
 
-std::array<std::array<unsigned char, 6>, 16> build_decrypt_schedule_key(const std::array<unsigned char, 8> &key)
+/**
+ * @return 48-bit round keys
+ */
+std::array<uint64_t, 16> build_encrypt_schedule_key(const std::array<unsigned char, 8> &key)
 {
-    std::array<unsigned char, 7> permuted_key;
-    permute(permuted_key, key, schedule_key_permutation_table);
-    std::array<std::array<unsigned char, 6>, 16> schedule_keys{};
-    for (int round = 0; round < 16; round++)
+    const auto permuted_key = schedule_key_permutation(key);
+    auto left = static_cast<uint32_t>(permuted_key >> 28);
+    auto right = static_cast<uint32_t>(permuted_key & 0x0FFFFFFF);
+    std::array<uint64_t, 16> schedule_keys{};
+    for (size_t round = 0; round < schedule_keys.size(); ++round)
     {
-        permute(schedule_keys[round], permuted_key, schedule_key_reduce_table);
-        schedule_key_rotr(permuted_key);
-        if (!(round >= 14 || round == 7 || round == 0))
-        {
-            // Rotate twice except in rounds 1, 2, 9 & 16
-            schedule_key_rotr(permuted_key);
-        }
+        // Rotate twice except in rounds 1, 2, 9 & 16
+        const auto shift = round <= 1 || round == 8 || round == 15 ? 1 : 2;
+        left = (left << shift | left >> (28 - shift)) & 0x0FFFFFFF;
+        right = (right << shift | right >> (28 - shift)) & 0x0FFFFFFF;
+        schedule_keys[round] = schedule_key_reduction(static_cast<uint64_t>(left) << 28 | right);
     }
     return schedule_keys;
 }
 
-/**
- * Add 32 to each item as we are expending right 4 bytes of 8 byte array
- */
-const auto des_expansion_table = std::array<unsigned int, 48>{
-        32 + 32, 1 + 32, 2 + 32, 3 + 32, 4 + 32, 5 + 32,
-        4 + 32, 5 + 32, 6 + 32, 7 + 32, 8 + 32, 9 + 32,
-        8 + 32, 9 + 32, 10 + 32, 11 + 32, 12 + 32, 13 + 32,
-        12 + 32, 13 + 32, 14 + 32, 15 + 32, 16 + 32, 17 + 32,
-        16 + 32, 17 + 32, 18 + 32, 19 + 32, 20 + 32, 21 + 32,
-        20 + 32, 21 + 32, 22 + 32, 23 + 32, 24 + 32, 25 + 32,
-        24 + 32, 25 + 32, 26 + 32, 27 + 32, 28 + 32, 29 + 32,
-        28 + 32, 29 + 32, 30 + 32, 31 + 32, 32 + 32, 1 + 32
-};
-
-const auto sbox_permute_table = std::array<unsigned int, 32>{
+constexpr auto sbox_permute_table = std::array<unsigned int, 32>{
         16, 7, 20, 21,
         29, 12, 28, 17,
         1, 15, 23, 26,
@@ -109,7 +87,7 @@ const auto sbox_permute_table = std::array<unsigned int, 32>{
         22, 11, 4, 25
 };
 
-const auto sbox = std::array<std::array<unsigned char, 64>, 8>{
+constexpr auto sbox = std::array<std::array<unsigned char, 64>, 8>{
         std::array<unsigned char, 64>{ 14, 0, 4, 15, 13, 7, 1, 4, 2, 14, 15, 2, 11, 13, 8, 1,
                                        3, 10, 10, 6, 6, 12, 12, 11, 5, 9, 9, 5, 0, 3, 7, 8,
                                        4, 15, 1, 12, 14, 8, 8, 2, 13, 4, 6, 9, 2, 1, 11, 7,
@@ -144,300 +122,694 @@ const auto sbox = std::array<std::array<unsigned char, 64>, 8>{
                                        0, 15, 6, 12, 10, 9, 13, 0, 15, 3, 3, 5, 5, 6, 8, 11 }
 };
 
-const auto final_permute_table = std::array<unsigned int, 64>{
-        40, 8, 48, 16, 56, 24, 64, 32,
-        39, 7, 47, 15, 55, 23, 63, 31,
-        38, 6, 46, 14, 54, 22, 62, 30,
-        37, 5, 45, 13, 53, 21, 61, 29,
-        36, 4, 44, 12, 52, 20, 60, 28,
-        35, 3, 43, 11, 51, 19, 59, 27,
-        34, 2, 42, 10, 50, 18, 58, 26,
-        33, 1, 41, 9, 49, 17, 57, 25
-};
-
-const auto initial_permute_table = std::array<unsigned int, 64>{
-        58, 50, 42, 34, 26, 18, 10, 2,
-        60, 52, 44, 36, 28, 20, 12, 4,
-        62, 54, 46, 38, 30, 22, 14, 6,
-        64, 56, 48, 40, 32, 24, 16, 8,
-        57, 49, 41, 33, 25, 17, 9, 1,
-        59, 51, 43, 35, 27, 19, 11, 3,
-        61, 53, 45, 37, 29, 21, 13, 5,
-        63, 55, 47, 39, 31, 23, 15, 7
-};
-
-void des_block_process(const std::array<unsigned char, 8> &input_block,
-        std::array<unsigned char, 8> &output_block,
-        std::array<std::array<unsigned char, 6>, 16> schedule_keys)
+/**
+ * S-box output passed through the P permutation for every 6-bit input, so a round is 8 lookups ORed together.
+ * Entries are rotated left by one bit like the halves they are applied to.
+ */
+consteval std::array<std::array<uint32_t, 64>, 8> build_sp_tables()
 {
-    std::array<unsigned char, 8> input_cypher;
-    permute(input_cypher, input_block, initial_permute_table);
-    for (const auto &round_key: schedule_keys)
+    constexpr BytePermutation<4, 32> permutation(sbox_permute_table);
+    std::array<std::array<uint32_t, 64>, 8> result{};
+    for (size_t box = 0; box < 8; ++box)
     {
-        std::array<unsigned char, 6> expanded_block;
-        permute(expanded_block, input_cypher, des_expansion_table);
-        std::transform(expanded_block.begin(), expanded_block.end(), round_key.cbegin(), expanded_block.begin(),
-                [](const auto &left, const auto &right)
-                {
-                    return left ^ right;
-                });
-        std::array<unsigned char, 4> sbox_block{};
-        sbox_block[0] = sbox[0][(expanded_block[0] & 0xFC) >> 2] << 4;
-        sbox_block[0] |= sbox[1][(expanded_block[0] & 0x03) << 4 | (expanded_block[1] & 0xF0) >> 4];
-        sbox_block[1] = sbox[2][(expanded_block[1] & 0x0F) << 2 | (expanded_block[2] & 0xC0) >> 6] << 4;
-        sbox_block[1] |= sbox[3][(expanded_block[2] & 0x3F)];
-        sbox_block[2] = sbox[4][(expanded_block[3] & 0xFC) >> 2] << 4;
-        sbox_block[2] |= sbox[5][(expanded_block[3] & 0x03) << 4 | (expanded_block[4] & 0xF0) >> 4];
-        sbox_block[3] = sbox[6][(expanded_block[4] & 0x0F) << 2 | (expanded_block[5] & 0xC0) >> 6] << 4;
-        sbox_block[3] |= sbox[7][(expanded_block[5] & 0x3F)];
-        std::array<unsigned char, 4> sbox_permuted_block;
-        permute(sbox_permuted_block, sbox_block, sbox_permute_table);
-        std::transform(sbox_permuted_block.begin(), sbox_permuted_block.end(), input_cypher.cbegin(),
-                sbox_permuted_block.begin(),
-                [](const auto &left, const auto &right)
-                {
-                    return left ^ right;
-                });
-        input_cypher[0] = input_cypher[4];
-        input_cypher[1] = input_cypher[5];
-        input_cypher[2] = input_cypher[6];
-        input_cypher[3] = input_cypher[7];
-        input_cypher[4] = sbox_permuted_block[0];
-        input_cypher[5] = sbox_permuted_block[1];
-        input_cypher[6] = sbox_permuted_block[2];
-        input_cypher[7] = sbox_permuted_block[3];
+        for (uint32_t input = 0; input < 64; ++input)
+        {
+            const auto substituted = static_cast<uint32_t>(sbox[box][input]) << (28 - 4 * box);
+            result[box][input] = std::rotl(permutation(substituted), 1);
+        }
     }
-    std::swap(input_cypher[4], input_cypher[0]);
-    std::swap(input_cypher[5], input_cypher[1]);
-    std::swap(input_cypher[6], input_cypher[2]);
-    std::swap(input_cypher[7], input_cypher[3]);
-    permute(output_block, input_cypher, final_permute_table);
+    return result;
 }
 
-std::vector<unsigned char> des_ecb_pkcs5_encrypt(
-        const std::vector<unsigned char> &data,
-        const std::array<unsigned char, 8> &key)
+alignas(64) constexpr auto sp_tables = build_sp_tables();
+
+using RoundKeys = DesKey::RoundKeys;
+
+uint32_t load_half(const unsigned char *bytes)
 {
-    std::vector<unsigned char> result{};
-    std::array<unsigned char, 8> input_block;
-    std::array<unsigned char, 8> cypher_block;
-    const auto schedule_keys = build_encrypt_schedule_key(key);
-    for (size_t i = 0; i <= data.size(); i += 8)
+    return static_cast<uint32_t>(bytes[0]) << 24 | static_cast<uint32_t>(bytes[1]) << 16
+           | static_cast<uint32_t>(bytes[2]) << 8 | bytes[3];
+}
+
+void store_half(uint32_t half, unsigned char *bytes)
+{
+    bytes[0] = half >> 24;
+    bytes[1] = (half >> 16) & 0xFF;
+    bytes[2] = (half >> 8) & 0xFF;
+    bytes[3] = half & 0xFF;
+}
+
+RoundKeys build_round_keys(const std::array<uint64_t, 16> &schedule_keys)
+{
+    RoundKeys result{};
+    for (size_t round = 0; round < schedule_keys.size(); ++round)
     {
-        if (i + 8 < data.size())
-        {
-            std::copy_n(data.cbegin() + i, 8, input_block.begin());
-            des_block_process(input_block, cypher_block, schedule_keys);
-            std::copy_n(cypher_block.cbegin(), 8, std::back_inserter(result));
-        }
-        else
+        for (size_t group = 0; group < 8; ++group)
         {
-            input_block.fill(i + 8 - data.size());
-            std::copy_n(data.cbegin() + i, data.size() - i, input_block.begin());
-            des_block_process(input_block, cypher_block, schedule_keys);
-            std::copy_n(cypher_block.cbegin(), 8, std::back_inserter(result));
+            const auto bits = static_cast<uint32_t>(schedule_keys[round] >> (42 - 6 * group)) & 0x3F;
+            result[2 * round + group % 2] |= bits << (24 - 8 * (group / 2));
         }
     }
     return result;
 }
 
-std::vector<unsigned char> des_ecb_pkcs5_decrypt(
-        const std::vector<unsigned char> &data,
-        const std::array<unsigned char, 8> &key)
+/**
+ * Initial permutation as swaps of bit groups between the halves, finishing with both halves rotated left by one,
+ * which lines up every 6-bit expansion group with a byte of the round key words.
+ */
+void initial_permutation(uint32_t &left, uint32_t &right)
 {
-    if (data.empty() || data.size() % 8 != 0)
+    uint32_t work = ((left >> 4) ^ right) & 0x0F0F0F0F;
+    right ^= work;
+    left ^= work << 4;
+    work = ((left >> 16) ^ right) & 0x0000FFFF;
+    right ^= work;
+    left ^= work << 16;
+    work = ((right >> 2) ^ left) & 0x33333333;
+    left ^= work;
+    right ^= work << 2;
+    work = ((right >> 8) ^ left) & 0x00FF00FF;
+    left ^= work;
+    right ^= work << 8;
+    right = std::rotl(right, 1);
+    work = (left ^ right) & 0xAAAAAAAA;
+    left ^= work;
+    right ^= work;
+    left = std::rotl(left, 1);
+}
+
+/**
+ * Steps of initial permutation in reverse order.
+ */
+void final_permutation(uint32_t &left, uint32_t &right)
+{
+    left = std::rotr(left, 1);
+    uint32_t work = (left ^ right) & 0xAAAAAAAA;
+    left ^= work;
+    right ^= work;
+    right = std::rotr(right, 1);
+    work = ((right >> 8) ^ left) & 0x00FF00FF;
+    left ^= work;
+    right ^= work << 8;
+    work = ((right >> 2) ^ left) & 0x33333333;
+    left ^= work;
+    right ^= work << 2;
+    work = ((left >> 16) ^ right) & 0x0000FFFF;
+    right ^= work;
+    left ^= work << 16;
+    work = ((left >> 4) ^ right) & 0x0F0F0F0F;
+    right ^= work;
+    left ^= work << 4;
+}
+
+inline uint32_t feistel(uint32_t half, uint32_t odd_key, uint32_t even_key)
+{
+    const auto odd = std::rotr(half, 4) ^ odd_key;
+    const auto even = half ^ even_key;
+    return sp_tables[0][(odd >> 24) & 0x3F] | sp_tables[2][(odd >> 16) & 0x3F]
+           | sp_tables[4][(odd >> 8) & 0x3F] | sp_tables[6][odd & 0x3F]
+           | sp_tables[1][(even >> 24) & 0x3F] | sp_tables[3][(even >> 16) & 0x3F]
+           | sp_tables[5][(even >> 8) & 0x3F] | sp_tables[7][even & 0x3F];
+}
+
+/**
+ * 16 rounds on permuted halves, including the swap after the last round. Output of one pass is valid input
+ * of the next, so 3DES runs the permutations only once.
+ */
+void des_rounds(uint32_t &left, uint32_t &right, const RoundKeys &keys)
+{
+    for (size_t i = 0; i < keys.size(); i += 4)
     {
-        throw std::runtime_error("Malformed cypher data");
+        left ^= feistel(right, keys[i], keys[i + 1]);
+        right ^= feistel(left, keys[i + 2], keys[i + 3]);
     }
-    std::vector<unsigned char> result{};
-    std::array<unsigned char, 8> input_block;
-    std::array<unsigned char, 8> output_block;
-    const auto schedule_keys = build_decrypt_schedule_key(key);
-    for (size_t i = 0; i < data.size(); i += 8)
+    std::swap(left, right);
+}
+
+void des_crypt_block(const std::array<unsigned char, 8> &input_block,
+        std::array<unsigned char, 8> &output_block,
+        const RoundKeys &keys)
+{
+    auto left = load_half(input_block.data());
+    auto right = load_half(input_block.data() + 4);
+    initial_permutation(left, right);
+    des_rounds(left, right, keys);
+    final_permutation(left, right);
+    store_half(left, output_block.data());
+    store_half(right, output_block.data() + 4);
+}
+
+/**
+ * EDE: encrypt with first key, decrypt with second, encrypt with third.
+ * For decryption pass decrypt round keys in reverse order.
+ */
+void des3_crypt_block(const std::array<unsigned char, 8> &input_block,
+        std::array<unsigned char, 8> &output_block,
+        const RoundKeys &first,
+        const RoundKeys &second,
+        const RoundKeys &third)
+{
+    auto left = load_half(input_block.data());
+    auto right = load_half(input_block.data() + 4);
+    initial_permutation(left, right);
+    des_rounds(left, right, first);
+    des_rounds(left, right, second);
+    des_rounds(left, right, third);
+    final_permutation(left, right);
+    store_half(left, output_block.data());
+    store_half(right, output_block.data() + 4);
+}
+
+DesKey::DesKey(const std::array<unsigned char, 8> &key) : encrypt_key(build_round_keys(build_encrypt_schedule_key(key)))
+{
+    // decryption runs the rounds backwards
+    for (size_t round = 0; round < 16; ++round)
     {
-        std::copy_n(data.cbegin() + i, 8, input_block.begin());
-        des_block_process(input_block, output_block, schedule_keys);
-        std::copy_n(output_block.cbegin(), 8, std::back_inserter(result));
+        decrypt_key[2 * round] = encrypt_key[2 * (15 - round)];
+        decrypt_key[2 * round + 1] = encrypt_key[2 * (15 - round) + 1];
     }
-    if (result.back() > 8 || result.back() < 1)
+}
+
+const DesKey::RoundKeys &DesKey::get_encrypt_key() const
+{
+    return encrypt_key;
+}
+
+const DesKey::RoundKeys &DesKey::get_decrypt_key() const
+{
+    return decrypt_key;
+}
+
+std::array<unsigned char, 8> des3_part_key(const std::array<unsigned char, 24> &key, size_t index)
+{
+    std::array<unsigned char, 8> result;
+    std::copy_n(key.cbegin() + 8 * index, 8, result.begin());
+    return result;
+}
+
+TripleDesKey::TripleDesKey(const std::array<unsigned char, 24> &key)
+        : first(des3_part_key(key, 0)), second(des3_part_key(key, 1)), third(des3_part_key(key, 2))
+{
+
+}
+
+const DesKey &TripleDesKey::get_first() const
+{
+    return first;
+}
+
+const DesKey &TripleDesKey::get_second() const
+{
+    return second;
+}
+
+const DesKey &TripleDesKey::get_third() const
+{
+    return third;
+}
+
+void des_encrypt_block(const std::array<unsigned char, 8> &input_block,
+        std::array<unsigned char, 8> &output_block,
+        const DesKey &key)
+{
+    des_crypt_block(input_block, output_block, key.get_encrypt_key());
+}
+
+void des_decrypt_block(const std::array<unsigned char, 8> &input_block,
+        std::array<unsigned char, 8> &output_block,
+        const DesKey &key)
+{
+    des_crypt_block(input_block, output_block, key.get_decrypt_key());
+}
+
+void des3_encrypt_block(const std::array<unsigned char, 8> &input_block,
+        std::array<unsigned char, 8> &output_block,
+        const TripleDesKey &key)
+{
+    des3_crypt_block(input_block, output_block, key.get_first().get_encrypt_key(),
+            key.get_second().get_decrypt_key(), key.get_third().get_encrypt_key());
+}
+
+void des3_decrypt_block(const std::array<unsigned char, 8> &input_block,
+        std::array<unsigned char, 8> &output_block,
+        const TripleDesKey &key)
+{
+    des3_crypt_block(input_block, output_block, key.get_third().get_decrypt_key(),
+            key.get_second().get_encrypt_key(), key.get_first().get_decrypt_key());
+}
+
+void check_blocks(std::span<const unsigned char> input, std::span<unsigned char> output)
+{
+    if (input.size() % 8 != 0)
     {
-        throw std::runtime_error("PKCS5 padding expected");
+        throw std::runtime_error("input should be padded");
+    }
+    if (input.size() != output.size())
+    {
+        throw std::runtime_error("output size should match input size");
     }
-    result.resize(result.size() - result.back());
-    return result;
 }
 
-std::vector<unsigned char> des_cbc_pkcs5_encrypt(
-        const std::vector<unsigned char> &data,
-        const std::array<unsigned char, 8> &key,
-        const std::array<unsigned char, 8> &iv)
+template<typename BlockProcess>
+void ecb_process(std::span<const unsigned char> input, std::span<unsigned char> output, BlockProcess process)
 {
-    std::vector<unsigned char> result{};
+    check_blocks(input, output);
+    std::array<unsigned char, 8> input_block;
+    std::array<unsigned char, 8> output_block;
+    for (size_t i = 0; i < input.size(); i += 8)
+    {
+        std::copy_n(input.begin() + i, 8, input_block.begin());
+        process(input_block, output_block);
+        std::copy(output_block.cbegin(), output_block.cend(), output.begin() + i);
+    }
+}
+
+template<typename BlockProcess>
+void cbc_encrypt(std::span<const unsigned char> input,
+        std::span<unsigned char> output,
+        const std::array<unsigned char, 8> &iv,
+        BlockProcess process)
+{
+    check_blocks(input, output);
     std::array<unsigned char, 8> input_block;
     std::array<unsigned char, 8> cypher_block = iv;
-    const auto schedule_keys = build_encrypt_schedule_key(key);
-    for (size_t i = 0; i <= data.size(); i += 8)
+    for (size_t i = 0; i < input.size(); i += 8)
     {
-        if (i + 8 < data.size())
+        for (size_t j = 0; j < 8; ++j)
         {
-            std::copy_n(data.cbegin() + i, 8, input_block.begin());
-            std::transform(input_block.begin(), input_block.end(), cypher_block.cbegin(),
-                    input_block.begin(),
-                    [](const auto &left, const auto &right)
-                    {
-                        return left ^ right;
-                    });
-            des_block_process(input_block, cypher_block, schedule_keys);
-            std::copy_n(cypher_block.cbegin(), 8, std::back_inserter(result));
+            input_block[j] = input[i + j] ^ cypher_block[j];
         }
-        else
+        process(input_block, cypher_block);
+        std::copy(cypher_block.cbegin(), cypher_block.cend(), output.begin() + i);
+    }
+}
+
+template<typename BlockProcess>
+void cbc_decrypt(std::span<const unsigned char> input,
+        std::span<unsigned char> output,
+        const std::array<unsigned char, 8> &iv,
+        BlockProcess process)
+{
+    check_blocks(input, output);
+    std::array<unsigned char, 8> cypher_block;
+    std::array<unsigned char, 8> output_block;
+    auto previous = iv;
+    for (size_t i = 0; i < input.size(); i += 8)
+    {
+        // copy first, output may be the same memory
+        std::copy_n(input.begin() + i, 8, cypher_block.begin());
+        process(cypher_block, output_block);
+        for (size_t j = 0; j < 8; ++j)
         {
-            input_block.fill(i + 8 - data.size());
-            std::copy_n(data.cbegin() + i, data.size() - i, input_block.begin());
-            std::transform(input_block.begin(), input_block.end(), cypher_block.cbegin(),
-                    input_block.begin(),
-                    [](const auto &left, const auto &right)
-                    {
-                        return left ^ right;
-                    });
-            des_block_process(input_block, cypher_block, schedule_keys);
-            std::copy_n(cypher_block.cbegin(), 8, std::back_inserter(result));
+            output[i + j] = output_block[j] ^ previous[j];
         }
+        previous = cypher_block;
     }
-    return result;
 }
 
-std::vector<unsigned char> des_cbc_pkcs5_decrypt(
-        const std::vector<unsigned char> &data,
+void des_ecb_encrypt(std::span<const unsigned char> input,
+        std::span<unsigned char> output,
+        const DesKey &key)
+{
+    ecb_process(input, output, [&key](const auto &input_block, auto &output_block)
+    {
+        des_encrypt_block(input_block, output_block, key);
+    });
+}
+
+void des_ecb_decrypt(std::span<const unsigned char> input,
+        std::span<unsigned char> output,
+        const DesKey &key)
+{
+    ecb_process(input, output, [&key](const auto &input_block, auto &output_block)
+    {
+        des_decrypt_block(input_block, output_block, key);
+    });
+}
+
+void des_cbc_encrypt(std::span<const unsigned char> input,
+        std::span<unsigned char> output,
+        const DesKey &key,
+        const std::array<unsigned char, 8> &iv)
+{
+    cbc_encrypt(input, output, iv, [&key](const auto &input_block, auto &output_block)
+    {
+        des_encrypt_block(input_block, output_block, key);
+    });
+}
+
+void des_cbc_decrypt(std::span<const unsigned char> input,
+        std::span<unsigned char> output,
+        const DesKey &key,
+        const std::array<unsigned char, 8> &iv)
+{
+    cbc_decrypt(input, output, iv, [&key](const auto &input_block, auto &output_block)
+    {
+        des_decrypt_block(input_block, output_block, key);
+    });
+}
+
+void des3_cbc_encrypt(std::span<const unsigned char> input,
+        std::span<unsigned char> output,
+        const TripleDesKey &key,
+        const std::array<unsigned char, 8> &iv)
+{
+    cbc_encrypt(input, output, iv, [&key](const auto &input_block, auto &output_block)
+    {
+        des3_encrypt_block(input_block, output_block, key);
+    });
+}
+
+void des3_cbc_decrypt(std::span<const unsigned char> input,
+        std::span<unsigned char> output,
+        const TripleDesKey &key,
+        const std::array<unsigned char, 8> &iv)
+{
+    cbc_decrypt(input, output, iv, [&key](const auto &input_block, auto &output_block)
+    {
+        des3_decrypt_block(input_block, output_block, key);
+    });
+}
+
+void des_ecb_encrypt(std::span<const unsigned char> input,
+        std::span<unsigned char> output,
+        const std::array<unsigned char, 8> &key)
+{
+    des_ecb_encrypt(input, output, DesKey(key));
+}
+
+void des_ecb_decrypt(std::span<const unsigned char> input,
+        std::span<unsigned char> output,
+        const std::array<unsigned char, 8> &key)
+{
+    des_ecb_decrypt(input, output, DesKey(key));
+}
+
+void des_cbc_encrypt(std::span<const unsigned char> input,
+        std::span<unsigned char> output,
         const std::array<unsigned char, 8> &key,
         const std::array<unsigned char, 8> &iv)
 {
-    if (data.empty() || data.size() % 8 != 0)
+    des_cbc_encrypt(input, output, DesKey(key), iv);
+}
+
+void des_cbc_decrypt(std::span<const unsigned char> input,
+        std::span<unsigned char> output,
+        const std::array<unsigned char, 8> &key,
+        const std::array<unsigned char, 8> &iv)
+{
+    des_cbc_decrypt(input, output, DesKey(key), iv);
+}
+
+void des3_cbc_encrypt(std::span<const unsigned char> input,
+        std::span<unsigned char> output,
+        const std::array<unsigned char, 24> &key,
+        const std::array<unsigned char, 8> &iv)
+{
+    des3_cbc_encrypt(input, output, TripleDesKey(key), iv);
+}
+
+void des3_cbc_decrypt(std::span<const unsigned char> input,
+        std::span<unsigned char> output,
+        const std::array<unsigned char, 24> &key,
+        const std::array<unsigned char, 8> &iv)
+{
+    des3_cbc_decrypt(input, output, TripleDesKey(key), iv);
+}
+
+uint64_t load_block(const unsigned char *bytes)
+{
+    return static_cast<uint64_t>(load_half(bytes)) << 32 | load_half(bytes + 4);
+}
+
+void store_block(uint64_t block, unsigned char *bytes)
+{
+    store_half(block >> 32, bytes);
+    store_half(block & 0xFFFFFFFF, bytes + 4);
+}
+
+/**
+ * Number of DES passes a key makes over every block.
+ */
+template<typename Key>
+constexpr size_t des_pass_count = 1;
+
+template<>
+constexpr size_t des_pass_count<TripleDesKey> = 3;
+
+/**
+ * Round keys in processing order: single DES, or EDE of the three part keys, reversed for decryption.
+ */
+std::array<const RoundKeys *, des_pass_count<DesKey>> process_round_keys(const DesKey &key, bool encrypt)
+{
+    return { encrypt ? &key.get_encrypt_key() : &key.get_decrypt_key() };
+}
+
+std::array<const RoundKeys *, des_pass_count<TripleDesKey>> process_round_keys(const TripleDesKey &key, bool encrypt)
+{
+    if (encrypt)
     {
-        throw std::runtime_error("Malformed cypher data");
+        return { &key.get_first().get_encrypt_key(), &key.get_second().get_decrypt_key(),
+                 &key.get_third().get_encrypt_key() };
     }
-    std::vector<unsigned char> result{};
-    std::array<unsigned char, 8> input_block;
-    std::array<unsigned char, 8> output_block;
-    auto next_iv = iv;
-    const auto schedule_keys = build_decrypt_schedule_key(key);
-    for (size_t i = 0; i < data.size(); i += 8)
+    return { &key.get_third().get_decrypt_key(), &key.get_second().get_encrypt_key(),
+             &key.get_first().get_decrypt_key() };
+}
+
+template<typename Key>
+void bitsliced_ecb_process(std::span<const unsigned char> input,
+        std::span<unsigned char> output,
+        const Key &key,
+        bool encrypt)
+{
+    check_blocks(input, output);
+    const auto round_keys = process_round_keys(key, encrypt);
+    std::array<BitslicedDesKey, des_pass_count<Key>> keys{};
+    for (size_t i = 0; i < keys.size(); ++i)
     {
-        std::copy_n(data.cbegin() + i, 8, input_block.begin());
-        des_block_process(input_block, output_block, schedule_keys);
-        std::transform(output_block.begin(), output_block.end(), next_iv.cbegin(),
-                output_block.begin(),
-                [](const auto &left, const auto &right)
-                {
-                    return left ^ right;
-                });
-        next_iv = input_block;
-        std::copy_n(output_block.cbegin(), 8, std::back_inserter(result));
+        des_bitsliced_set_key(keys[i], *round_keys[i], ~uint64_t{ 0 });
     }
-    if (result.back() > 8 || result.back() < 1)
+    std::array<uint64_t, des_bitsliced_blocks> blocks{};
+    for (size_t i = 0; i < input.size(); i += 8 * blocks.size())
     {
-        throw std::runtime_error("PKCS5 padding expected");
+        const auto count = std::min(blocks.size(), (input.size() - i) / 8);
+        for (size_t j = 0; j < count; ++j)
+        {
+            blocks[j] = load_block(input.data() + i + 8 * j);
+        }
+        des_bitsliced_process(blocks, keys.data(), keys.size());
+        for (size_t j = 0; j < count; ++j)
+        {
+            store_block(blocks[j], output.data() + i + 8 * j);
+        }
     }
-    result.resize(result.size() - result.back());
-    return result;
 }
 
-std::vector<unsigned char> des3_cbc_pkcs5_encrypt(
-        const std::vector<unsigned char> &data,
-        const std::array<unsigned char, 24> &key,
-        const std::array<unsigned char, 8> &iv)
+void des_ecb_encrypt_bitsliced(std::span<const unsigned char> input,
+        std::span<unsigned char> output,
+        const DesKey &key)
 {
-    std::array<unsigned char, 8> des_key;
-    std::copy_n(key.cbegin(), 8, des_key.begin());
-    const auto schedule_keys1 = build_encrypt_schedule_key(des_key);
-    std::copy_n(key.cbegin() + 8, 8, des_key.begin());
-    const auto schedule_keys2 = build_decrypt_schedule_key(des_key);
-    std::copy_n(key.cbegin() + 16, 8, des_key.begin());
-    const auto schedule_keys3 = build_encrypt_schedule_key(des_key);
-    std::vector<unsigned char> result{};
-    std::array<unsigned char, 8> input_block;
-    std::array<unsigned char, 8> cypher_block = iv;
+    bitsliced_ecb_process(input, output, key, true);
+}
+
+void des_ecb_decrypt_bitsliced(std::span<const unsigned char> input,
+        std::span<unsigned char> output,
+        const DesKey &key)
+{
+    bitsliced_ecb_process(input, output, key, false);
+}
+
+void des3_ecb_encrypt_bitsliced(std::span<const unsigned char> input,
+        std::span<unsigned char> output,
+        const TripleDesKey &key)
+{
+    bitsliced_ecb_process(input, output, key, true);
+}
+
+void des3_ecb_decrypt_bitsliced(std::span<const unsigned char> input,
+        std::span<unsigned char> output,
+        const TripleDesKey &key)
+{
+    bitsliced_ecb_process(input, output, key, false);
+}
 
-    for (size_t i = 0; i <= data.size(); i += 8)
+template<typename Key>
+void bitsliced_cbc_process_many(std::vector<DesCbcJob<Key>> &jobs, bool encrypt)
+{
+    for (const auto &job: jobs)
     {
-        if (i + 8 < data.size())
+        if (job.data.size() % 8 != 0)
         {
-            std::copy_n(data.cbegin() + i, 8, input_block.begin());
-            std::transform(input_block.begin(), input_block.end(), cypher_block.cbegin(),
-                    input_block.begin(),
-                    [](const auto &left, const auto &right)
-                    {
-                        return left ^ right;
-                    });
-            des_block_process(input_block, cypher_block, schedule_keys1);
-            std::copy_n(cypher_block.cbegin(), 8, input_block.begin());
-            des_block_process(input_block, cypher_block, schedule_keys2);
-            std::copy_n(cypher_block.cbegin(), 8, input_block.begin());
-            des_block_process(input_block, cypher_block, schedule_keys3);
-            std::copy_n(cypher_block.cbegin(), 8, std::back_inserter(result));
+            throw std::runtime_error("input should be padded");
         }
-        else
+    }
+    std::array<BitslicedDesKey, des_pass_count<Key>> keys{};
+    std::array<DesCbcJob<Key> *, des_bitsliced_blocks> lane_jobs{};
+    std::array<size_t, des_bitsliced_blocks> offsets{};
+    std::array<uint64_t, des_bitsliced_blocks> chain{};
+    std::array<uint64_t, des_bitsliced_blocks> inputs{};
+    std::array<uint64_t, des_bitsliced_blocks> blocks{};
+    size_t next = 0;
+    while (true)
+    {
+        size_t active = 0;
+        for (size_t lane = 0; lane < des_bitsliced_blocks; ++lane)
         {
-            input_block.fill(i + 8 - data.size());
-            std::copy_n(data.cbegin() + i, data.size() - i, input_block.begin());
-            std::transform(input_block.begin(), input_block.end(), cypher_block.cbegin(),
-                    input_block.begin(),
-                    [](const auto &left, const auto &right)
-                    {
-                        return left ^ right;
-                    });
-            des_block_process(input_block, cypher_block, schedule_keys1);
-            std::copy_n(cypher_block.cbegin(), 8, input_block.begin());
-            des_block_process(input_block, cypher_block, schedule_keys2);
-            std::copy_n(cypher_block.cbegin(), 8, input_block.begin());
-            des_block_process(input_block, cypher_block, schedule_keys3);
-            std::copy_n(cypher_block.cbegin(), 8, std::back_inserter(result));
+            while (lane_jobs[lane] == nullptr && next < jobs.size())
+            {
+                auto &job = jobs[next++];
+                if (job.data.empty())
+                {
+                    continue;
+                }
+                const auto round_keys = process_round_keys(*job.key, encrypt);
+                for (size_t i = 0; i < keys.size(); ++i)
+                {
+                    des_bitsliced_set_key(keys[i], *round_keys[i], des_bitsliced_lane(lane));
+                }
+                lane_jobs[lane] = &job;
+                offsets[lane] = 0;
+                chain[lane] = load_block(job.iv.data());
+            }
+            if (lane_jobs[lane] != nullptr)
+            {
+                inputs[lane] = load_block(lane_jobs[lane]->data.data() + offsets[lane]);
+                blocks[lane] = encrypt ? inputs[lane] ^ chain[lane] : inputs[lane];
+                ++active;
+            }
+        }
+        if (active == 0)
+        {
+            break;
+        }
+        des_bitsliced_process(blocks, keys.data(), keys.size());
+        for (size_t lane = 0; lane < des_bitsliced_blocks; ++lane)
+        {
+            auto *job = lane_jobs[lane];
+            if (job == nullptr)
+            {
+                continue;
+            }
+            const auto output = encrypt ? blocks[lane] : blocks[lane] ^ chain[lane];
+            store_block(output, job->data.data() + offsets[lane]);
+            chain[lane] = encrypt ? output : inputs[lane];
+            offsets[lane] += 8;
+            if (offsets[lane] == job->data.size())
+            {
+                store_block(chain[lane], job->iv.data());
+                lane_jobs[lane] = nullptr;
+            }
         }
     }
+}
+
+void des_cbc_encrypt_many(std::vector<DesCbcJob<DesKey>> &jobs)
+{
+    bitsliced_cbc_process_many(jobs, true);
+}
+
+void des_cbc_decrypt_many(std::vector<DesCbcJob<DesKey>> &jobs)
+{
+    bitsliced_cbc_process_many(jobs, false);
+}
+
+void des3_cbc_encrypt_many(std::vector<DesCbcJob<TripleDesKey>> &jobs)
+{
+    bitsliced_cbc_process_many(jobs, true);
+}
+
+void des3_cbc_decrypt_many(std::vector<DesCbcJob<TripleDesKey>> &jobs)
+{
+    bitsliced_cbc_process_many(jobs, false);
+}
+
+std::vector<unsigned char> pkcs5_pad(const std::vector<unsigned char> &data)
+{
+    std::vector<unsigned char> result;
+    const auto padding = 8 - data.size() % 8;
+    result.reserve(data.size() + padding);
+    result.insert(result.end(), data.begin(), data.end());
+    result.insert(result.end(), padding, static_cast<unsigned char>(padding));
     return result;
 }
 
-std::vector<unsigned char> des3_cbc_pkcs5_decrypt(
-        const std::vector<unsigned char> &data,
-        const std::array<unsigned char, 24> &key,
-        const std::array<unsigned char, 8> &iv)
+void check_cypher_data(const std::vector<unsigned char> &data)
 {
     if (data.empty() || data.size() % 8 != 0)
     {
         throw std::runtime_error("Malformed cypher data");
     }
-    std::array<unsigned char, 8> des_key;
-    std::copy_n(key.cbegin() + 16, 8, des_key.begin());
-    const auto schedule_keys1 = build_decrypt_schedule_key(des_key);
-    std::copy_n(key.cbegin() + 8, 8, des_key.begin());
-    const auto schedule_keys2 = build_encrypt_schedule_key(des_key);
-    std::copy_n(key.cbegin(), 8, des_key.begin());
-    const auto schedule_keys3 = build_decrypt_schedule_key(des_key);
-    std::vector<unsigned char> result{};
-    std::array<unsigned char, 8> input_block;
-    std::array<unsigned char, 8> output_block;
-    auto next_iv = iv;
-    for (size_t i = 0; i < data.size(); i += 8)
-    {
-        std::copy_n(data.cbegin() + i, 8, input_block.begin());
-        des_block_process(input_block, output_block, schedule_keys1);
-        std::copy_n(output_block.cbegin(), 8, input_block.begin());
-        des_block_process(input_block, output_block, schedule_keys2);
-        std::copy_n(output_block.cbegin(), 8, input_block.begin());
-        des_block_process(input_block, output_block, schedule_keys3);
-        std::transform(output_block.begin(), output_block.end(), next_iv.cbegin(),
-                output_block.begin(),
-                [](const auto &left, const auto &right)
-                {
-                    return left ^ right;
-                });
-        std::copy_n(data.cbegin() + i, 8, next_iv.begin());
-        std::copy_n(output_block.cbegin(), 8, std::back_inserter(result));
-    }
-    if (result.back() > 8 || result.back() < 1)
+}
+
+void pkcs5_unpad(std::vector<unsigned char> &data)
+{
+    if (data.back() > 8 || data.back() < 1)
     {
         throw std::runtime_error("PKCS5 padding expected");
     }
-    result.resize(result.size() - result.back());
+    data.resize(data.size() - data.back());
+}
+
+std::vector<unsigned char> des_ecb_pkcs5_encrypt(
+        const std::vector<unsigned char> &data,
+        const std::array<unsigned char, 8> &key)
+{
+    auto result = pkcs5_pad(data);
+    des_ecb_encrypt(std::span(result), std::span(result), key);
     return result;
-}
\ No newline at end of file
+}
+
+std::vector<unsigned char> des_ecb_pkcs5_decrypt(
+        const std::vector<unsigned char> &data,
+        const std::array<unsigned char, 8> &key)
+{
+    check_cypher_data(data);
+    std::vector<unsigned char> result(data.size());
+    des_ecb_decrypt(std::span(data), std::span(result), key);
+    pkcs5_unpad(result);
+    return result;
+}
+
+std::vector<unsigned char> des_cbc_pkcs5_encrypt(
+        const std::vector<unsigned char> &data,
+        const std::array<unsigned char, 8> &key,
+        const std::array<unsigned char, 8> &iv)
+{
+    auto result = pkcs5_pad(data);
+    des_cbc_encrypt(std::span(result), std::span(result), key, iv);
+    return result;
+}
+
+std::vector<unsigned char> des_cbc_pkcs5_decrypt(
+        const std::vector<unsigned char> &data,
+        const std::array<unsigned char, 8> &key,
+        const std::array<unsigned char, 8> &iv)
+{
+    check_cypher_data(data);
+    std::vector<unsigned char> result(data.size());
+    des_cbc_decrypt(std::span(data), std::span(result), key, iv);
+    pkcs5_unpad(result);
+    return result;
+}
+
+std::vector<unsigned char> des3_cbc_pkcs5_encrypt(
+        const std::vector<unsigned char> &data,
+        const std::array<unsigned char, 24> &key,
+        const std::array<unsigned char, 8> &iv)
+{
+    auto result = pkcs5_pad(data);
+    des3_cbc_encrypt(std::span(result), std::span(result), key, iv);
+    return result;
+}
+
+std::vector<unsigned char> des3_cbc_pkcs5_decrypt(
+        const std::vector<unsigned char> &data,
+        const std::array<unsigned char, 24> &key,
+        const std::array<unsigned char, 8> &iv)
+{
+    check_cypher_data(data);
+    std::vector<unsigned char> result(data.size());
+    des3_cbc_decrypt(std::span(data), std::span(result), key, iv);
+    pkcs5_unpad(result);
+    return result;
+}
@@ -2,6 +2,8 @@
 #define TLS_PLAYGROUND_DES_HPP
 
 #include <array>
+#include <cstdint>
+#include <span>
 #include <stdexcept>
 #include <vector>
 
@@ -52,9 +54,176 @@ void schedule_key_rotl(std::array<unsigned char, 7> &key);
 
 void schedule_key_rotr(std::array<unsigned char, 7> &key);
 
-void des_block_process(const std::array<unsigned char, 8> &input_block,
+/**
+ * Expanded DES key: round keys of both directions are computed once in the layout the round function consumes,
+ * so a key can be reused for any number of blocks or records.
+ */
+class DesKey
+{
+public:
+    /**
+     * Two words per round: 6-bit groups of S-boxes 1, 3, 5, 7 and of 2, 4, 6, 8.
+     */
+    using RoundKeys = std::array<uint32_t, 32>;
+
+private:
+    RoundKeys encrypt_key;
+    RoundKeys decrypt_key;
+
+public:
+    explicit DesKey(const std::array<unsigned char, 8> &key);
+
+    [[nodiscard]]
+    const RoundKeys &get_encrypt_key() const;
+
+    [[nodiscard]]
+    const RoundKeys &get_decrypt_key() const;
+};
+
+/**
+ * Three part keys of EDE, expanded once.
+ */
+class TripleDesKey
+{
+    DesKey first;
+    DesKey second;
+    DesKey third;
+
+public:
+    explicit TripleDesKey(const std::array<unsigned char, 24> &key);
+
+    [[nodiscard]]
+    const DesKey &get_first() const;
+
+    [[nodiscard]]
+    const DesKey &get_second() const;
+
+    [[nodiscard]]
+    const DesKey &get_third() const;
+};
+
+void des_encrypt_block(const std::array<unsigned char, 8> &input_block,
+        std::array<unsigned char, 8> &output_block,
+        const DesKey &key);
+
+void des_decrypt_block(const std::array<unsigned char, 8> &input_block,
+        std::array<unsigned char, 8> &output_block,
+        const DesKey &key);
+
+void des3_encrypt_block(const std::array<unsigned char, 8> &input_block,
+        std::array<unsigned char, 8> &output_block,
+        const TripleDesKey &key);
+
+void des3_decrypt_block(const std::array<unsigned char, 8> &input_block,
         std::array<unsigned char, 8> &output_block,
-        std::array<std::array<unsigned char, 6>, 16> schedule_keys);
+        const TripleDesKey &key);
+
+/**
+ * Unpadded block functions write into caller's buffer. Input must be multiple of 8 bytes,
+ * output must have the input size and may be the same memory.
+ */
+void des_ecb_encrypt(std::span<const unsigned char> input,
+        std::span<unsigned char> output,
+        const DesKey &key);
+
+void des_ecb_decrypt(std::span<const unsigned char> input,
+        std::span<unsigned char> output,
+        const DesKey &key);
+
+void des_cbc_encrypt(std::span<const unsigned char> input,
+        std::span<unsigned char> output,
+        const DesKey &key,
+        const std::array<unsigned char, 8> &iv);
+
+void des_cbc_decrypt(std::span<const unsigned char> input,
+        std::span<unsigned char> output,
+        const DesKey &key,
+        const std::array<unsigned char, 8> &iv);
+
+void des3_cbc_encrypt(std::span<const unsigned char> input,
+        std::span<unsigned char> output,
+        const TripleDesKey &key,
+        const std::array<unsigned char, 8> &iv);
+
+void des3_cbc_decrypt(std::span<const unsigned char> input,
+        std::span<unsigned char> output,
+        const TripleDesKey &key,
+        const std::array<unsigned char, 8> &iv);
+
+/**
+ * Raw key overloads expand the key on every call.
+ */
+void des_ecb_encrypt(std::span<const unsigned char> input,
+        std::span<unsigned char> output,
+        const std::array<unsigned char, 8> &key);
+
+void des_ecb_decrypt(std::span<const unsigned char> input,
+        std::span<unsigned char> output,
+        const std::array<unsigned char, 8> &key);
+
+void des_cbc_encrypt(std::span<const unsigned char> input,
+        std::span<unsigned char> output,
+        const std::array<unsigned char, 8> &key,
+        const std::array<unsigned char, 8> &iv);
+
+void des_cbc_decrypt(std::span<const unsigned char> input,
+        std::span<unsigned char> output,
+        const std::array<unsigned char, 8> &key,
+        const std::array<unsigned char, 8> &iv);
+
+void des3_cbc_encrypt(std::span<const unsigned char> input,
+        std::span<unsigned char> output,
+        const std::array<unsigned char, 24> &key,
+        const std::array<unsigned char, 8> &iv);
+
+void des3_cbc_decrypt(std::span<const unsigned char> input,
+        std::span<unsigned char> output,
+        const std::array<unsigned char, 24> &key,
+        const std::array<unsigned char, 8> &iv);
+
+/**
+ * Bitsliced batch ECB: 64 blocks are processed at once in constant time. Same contract as des_ecb_encrypt,
+ * much higher throughput for bulk data, a partial last batch costs as much as a full one.
+ */
+void des_ecb_encrypt_bitsliced(std::span<const unsigned char> input,
+        std::span<unsigned char> output,
+        const DesKey &key);
+
+void des_ecb_decrypt_bitsliced(std::span<const unsigned char> input,
+        std::span<unsigned char> output,
+        const DesKey &key);
+
+void des3_ecb_encrypt_bitsliced(std::span<const unsigned char> input,
+        std::span<unsigned char> output,
+        const TripleDesKey &key);
+
+void des3_ecb_decrypt_bitsliced(std::span<const unsigned char> input,
+        std::span<unsigned char> output,
+        const TripleDesKey &key);
+
+/**
+ * One independent CBC stream for the multi-stream functions. Data is processed in place and iv is replaced with
+ * the last cypher block, so the next record of the same stream continues the chain.
+ */
+template<typename Key>
+struct DesCbcJob
+{
+    const Key *key;
+    std::array<unsigned char, 8> iv;
+    std::span<unsigned char> data;
+};
+
+/**
+ * CBC is serial within a stream, so up to 64 independent streams, each with its own key, share one bitsliced
+ * batch: every stream occupies a lane and finished streams are replaced by the next job.
+ */
+void des_cbc_encrypt_many(std::vector<DesCbcJob<DesKey>> &jobs);
+
+void des_cbc_decrypt_many(std::vector<DesCbcJob<DesKey>> &jobs);
+
+void des3_cbc_encrypt_many(std::vector<DesCbcJob<TripleDesKey>> &jobs);
+
+void des3_cbc_decrypt_many(std::vector<DesCbcJob<TripleDesKey>> &jobs);
 
 std::vector<unsigned char> des_ecb_pkcs5_decrypt(
         const std::vector<unsigned char> &data,
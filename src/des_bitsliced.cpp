@@ -0,0 +1,861 @@
+#include <algorithm>
+
+#include "des_bitsliced.hpp"
+
+/**
+ * Planes of one half, index is DES bit number - 1.
+ */
+using HalfPlanes = std::array<uint64_t, 32>;
+
+/**
+ * S-box circuits, each XORs its four outputs into the half at positions after the P permutation.
+ * Circuits come from Shannon decomposition of the S-box tables with shared subexpressions, 75 to 95 gates each.
+ */
+inline void sbox1(uint64_t x0, uint64_t x1, uint64_t x2, uint64_t x3, uint64_t x4, uint64_t x5, uint64_t *out)
+{
+    const auto t0 = ~x5;
+    const auto t1 = x1 ^ t0;
+    const auto t2 = x4 ^ t1;
+    const auto t3 = x4 & x5;
+    const auto t4 = x3 & t3;
+    const auto t5 = t2 ^ t4;
+    const auto t6 = ~x1;
+    const auto t7 = x3 & t2;
+    const auto t8 = t6 ^ t7;
+    const auto t9 = x2 & t8;
+    const auto t10 = t5 ^ t9;
+    const auto t11 = x1 & x5;
+    const auto t12 = ~x4;
+    const auto t13 = t12 | t11;
+    const auto t14 = t6 & t0;
+    const auto t15 = x4 & x1;
+    const auto t16 = t14 ^ t15;
+    const auto t17 = x3 & t16;
+    const auto t18 = t13 ^ t17;
+    const auto t19 = ~t11;
+    const auto t20 = x4 & t19;
+    const auto t21 = x1 ^ t20;
+    const auto t22 = x4 ^ t14;
+    const auto t23 = x3 & t22;
+    const auto t24 = t21 ^ t23;
+    const auto t25 = x2 & t24;
+    const auto t26 = t18 ^ t25;
+    const auto t27 = x0 & t26;
+    const auto t28 = t10 ^ t27;
+    const auto t29 = t14 ^ t3;
+    const auto t30 = ~t14;
+    const auto t31 = x4 & t6;
+    const auto t32 = t30 ^ t31;
+    const auto t33 = x3 & t32;
+    const auto t34 = t29 ^ t33;
+    const auto t35 = x4 & t0;
+    const auto t36 = t19 ^ t35;
+    const auto t37 = t12 & x5;
+    const auto t38 = x3 & t37;
+    const auto t39 = t36 ^ t38;
+    const auto t40 = x2 & t39;
+    const auto t41 = t34 ^ t40;
+    const auto t42 = x3 & t20;
+    const auto t43 = t32 ^ t42;
+    const auto t44 = t6 | x5;
+    const auto t45 = x4 & t30;
+    const auto t46 = t44 ^ t45;
+    const auto t47 = t44 ^ t3;
+    const auto t48 = x3 & t47;
+    const auto t49 = t46 ^ t48;
+    const auto t50 = x2 & t49;
+    const auto t51 = t43 ^ t50;
+    const auto t52 = x0 & t51;
+    const auto t53 = t41 ^ t52;
+    const auto t54 = x1 | t0;
+    const auto t55 = t54 ^ t31;
+    const auto t56 = x4 & t54;
+    const auto t57 = t44 ^ t56;
+    const auto t58 = x3 & t57;
+    const auto t59 = t55 ^ t58;
+    const auto t60 = x3 & t14;
+    const auto t61 = t32 ^ t60;
+    const auto t62 = x2 & t61;
+    const auto t63 = t59 ^ t62;
+    const auto t64 = ~t44;
+    const auto t65 = t12 & t64;
+    const auto t66 = x3 & t65;
+    const auto t67 = t57 ^ t66;
+    const auto t68 = t65 ^ t48;
+    const auto t69 = x2 & t68;
+    const auto t70 = t67 ^ t69;
+    const auto t71 = x0 & t70;
+    const auto t72 = t63 ^ t71;
+    const auto t73 = ~t1;
+    const auto t74 = x4 & t73;
+    const auto t75 = t64 ^ t74;
+    const auto t76 = t19 ^ t15;
+    const auto t77 = x3 & t76;
+    const auto t78 = t75 ^ t77;
+    const auto t79 = x4 | t11;
+    const auto t80 = x2 & t79;
+    const auto t81 = t78 ^ t80;
+    const auto t82 = x4 & t14;
+    const auto t83 = x5 ^ t82;
+    const auto t84 = t0 ^ t31;
+    const auto t85 = x3 & t84;
+    const auto t86 = t83 ^ t85;
+    const auto t87 = ~t21;
+    const auto t88 = t14 ^ t35;
+    const auto t89 = x3 & t88;
+    const auto t90 = t87 ^ t89;
+    const auto t91 = x2 & t90;
+    const auto t92 = t86 ^ t91;
+    const auto t93 = x0 & t92;
+    const auto t94 = t81 ^ t93;
+    out[8] ^= t28;
+    out[16] ^= t53;
+    out[22] ^= t72;
+    out[30] ^= t94;
+}
+
+inline void sbox2(uint64_t x0, uint64_t x1, uint64_t x2, uint64_t x3, uint64_t x4, uint64_t x5, uint64_t *out)
+{
+    const auto t0 = ~x5;
+    const auto t1 = x4 ^ t0;
+    const auto t2 = ~x4;
+    const auto t3 = t2 | t0;
+    const auto t4 = x0 & t3;
+    const auto t5 = t1 ^ t4;
+    const auto t6 = ~x0;
+    const auto t7 = t6 | t3;
+    const auto t8 = x2 & t7;
+    const auto t9 = t5 ^ t8;
+    const auto t10 = t2 & x5;
+    const auto t11 = x0 & t10;
+    const auto t12 = x5 ^ t11;
+    const auto t13 = t6 & t0;
+    const auto t14 = x2 & t13;
+    const auto t15 = t12 ^ t14;
+    const auto t16 = x1 & t15;
+    const auto t17 = t9 ^ t16;
+    const auto t18 = x4 & t0;
+    const auto t19 = x0 & t18;
+    const auto t20 = x4 ^ t19;
+    const auto t21 = x1 | t20;
+    const auto t22 = x3 & t21;
+    const auto t23 = t17 ^ t22;
+    const auto t24 = x0 ^ t1;
+    const auto t25 = x2 & x5;
+    const auto t26 = t24 ^ t25;
+    const auto t27 = ~x2;
+    const auto t28 = t27 | t19;
+    const auto t29 = x1 & t28;
+    const auto t30 = t26 ^ t29;
+    const auto t31 = x2 | t3;
+    const auto t32 = t0 ^ t19;
+    const auto t33 = x1 & t32;
+    const auto t34 = t31 ^ t33;
+    const auto t35 = x3 & t34;
+    const auto t36 = t30 ^ t35;
+    const auto t37 = t2 ^ t4;
+    const auto t38 = x0 | x4;
+    const auto t39 = x2 & t38;
+    const auto t40 = t37 ^ t39;
+    const auto t41 = x0 & t1;
+    const auto t42 = t3 ^ t41;
+    const auto t43 = ~t18;
+    const auto t44 = x0 & t43;
+    const auto t45 = x5 ^ t44;
+    const auto t46 = x2 & t45;
+    const auto t47 = t42 ^ t46;
+    const auto t48 = x1 & t47;
+    const auto t49 = t40 ^ t48;
+    const auto t50 = t6 | t2;
+    const auto t51 = t6 & t1;
+    const auto t52 = x2 & t51;
+    const auto t53 = t50 ^ t52;
+    const auto t54 = x0 | t10;
+    const auto t55 = x2 & x0;
+    const auto t56 = t54 ^ t55;
+    const auto t57 = x1 & t56;
+    const auto t58 = t53 ^ t57;
+    const auto t59 = x3 & t58;
+    const auto t60 = t49 ^ t59;
+    const auto t61 = t6 | t10;
+    const auto t62 = t2 & t0;
+    const auto t63 = x0 & t62;
+    const auto t64 = t1 ^ t63;
+    const auto t65 = x2 & t64;
+    const auto t66 = t61 ^ t65;
+    const auto t67 = t18 ^ t11;
+    const auto t68 = x2 & t67;
+    const auto t69 = t45 ^ t68;
+    const auto t70 = x1 & t69;
+    const auto t71 = t66 ^ t70;
+    const auto t72 = x0 | t3;
+    const auto t73 = x0 & x5;
+    const auto t74 = t18 ^ t73;
+    const auto t75 = x1 & t74;
+    const auto t76 = t72 ^ t75;
+    const auto t77 = x3 & t76;
+    const auto t78 = t71 ^ t77;
+    out[12] ^= t23;
+    out[27] ^= t36;
+    out[1] ^= t60;
+    out[17] ^= t78;
+}
+
+inline void sbox3(uint64_t x0, uint64_t x1, uint64_t x2, uint64_t x3, uint64_t x4, uint64_t x5, uint64_t *out)
+{
+    const auto t0 = ~x2;
+    const auto t1 = x0 | t0;
+    const auto t2 = x5 & x0;
+    const auto t3 = t1 ^ t2;
+    const auto t4 = x0 & x2;
+    const auto t5 = x5 & t4;
+    const auto t6 = t0 ^ t5;
+    const auto t7 = x4 & t6;
+    const auto t8 = t3 ^ t7;
+    const auto t9 = x0 | x2;
+    const auto t10 = ~x0;
+    const auto t11 = x5 & t10;
+    const auto t12 = t9 ^ t11;
+    const auto t13 = ~t9;
+    const auto t14 = x5 & t13;
+    const auto t15 = t10 ^ t14;
+    const auto t16 = x4 & t15;
+    const auto t17 = t12 ^ t16;
+    const auto t18 = x3 & t17;
+    const auto t19 = t8 ^ t18;
+    const auto t20 = t10 | x2;
+    const auto t21 = ~x5;
+    const auto t22 = t21 & x2;
+    const auto t23 = x4 & t22;
+    const auto t24 = t20 ^ t23;
+    const auto t25 = t21 & t10;
+    const auto t26 = x4 & t25;
+    const auto t27 = t13 ^ t26;
+    const auto t28 = x3 & t27;
+    const auto t29 = t24 ^ t28;
+    const auto t30 = x1 & t29;
+    const auto t31 = t19 ^ t30;
+    const auto t32 = x0 ^ x2;
+    const auto t33 = x5 ^ t32;
+    const auto t34 = x4 & x2;
+    const auto t35 = t33 ^ t34;
+    const auto t36 = ~t20;
+    const auto t37 = t21 | t36;
+    const auto t38 = x4 & t37;
+    const auto t39 = x5 ^ t38;
+    const auto t40 = x3 & t39;
+    const auto t41 = t35 ^ t40;
+    const auto t42 = x5 | t9;
+    const auto t43 = x4 | t42;
+    const auto t44 = x5 ^ t13;
+    const auto t45 = x3 & t44;
+    const auto t46 = t43 ^ t45;
+    const auto t47 = x1 & t46;
+    const auto t48 = t41 ^ t47;
+    const auto t49 = ~t32;
+    const auto t50 = x5 & t49;
+    const auto t51 = t10 ^ t50;
+    const auto t52 = x5 | t1;
+    const auto t53 = x4 & t52;
+    const auto t54 = t51 ^ t53;
+    const auto t55 = t49 ^ t14;
+    const auto t56 = x4 | t55;
+    const auto t57 = x3 & t56;
+    const auto t58 = t54 ^ t57;
+    const auto t59 = x5 & t32;
+    const auto t60 = t0 ^ t59;
+    const auto t61 = t60 ^ t26;
+    const auto t62 = x5 | t13;
+    const auto t63 = ~t2;
+    const auto t64 = x4 & t63;
+    const auto t65 = t62 ^ t64;
+    const auto t66 = x3 & t65;
+    const auto t67 = t61 ^ t66;
+    const auto t68 = x1 & t67;
+    const auto t69 = t58 ^ t68;
+    const auto t70 = t36 ^ t11;
+    const auto t71 = x4 & t9;
+    const auto t72 = t70 ^ t71;
+    const auto t73 = x4 & t10;
+    const auto t74 = t63 ^ t73;
+    const auto t75 = x3 & t74;
+    const auto t76 = t72 ^ t75;
+    const auto t77 = x5 | t20;
+    const auto t78 = t36 ^ t2;
+    const auto t79 = x4 & t78;
+    const auto t80 = t77 ^ t79;
+    const auto t81 = x3 & t5;
+    const auto t82 = t80 ^ t81;
+    const auto t83 = x1 & t82;
+    const auto t84 = t76 ^ t83;
+    out[23] ^= t31;
+    out[15] ^= t48;
+    out[29] ^= t69;
+    out[5] ^= t84;
+}
+
+inline void sbox4(uint64_t x0, uint64_t x1, uint64_t x2, uint64_t x3, uint64_t x4, uint64_t x5, uint64_t *out)
+{
+    const auto t0 = ~x2;
+    const auto t1 = t0 & x4;
+    const auto t2 = x0 ^ t1;
+    const auto t3 = ~x4;
+    const auto t4 = x2 & t3;
+    const auto t5 = ~x0;
+    const auto t6 = t5 | t4;
+    const auto t7 = x3 & t6;
+    const auto t8 = t2 ^ t7;
+    const auto t9 = x2 | x4;
+    const auto t10 = x0 & t1;
+    const auto t11 = t9 ^ t10;
+    const auto t12 = x2 ^ t3;
+    const auto t13 = x0 & t12;
+    const auto t14 = x4 ^ t13;
+    const auto t15 = x3 & t14;
+    const auto t16 = t11 ^ t15;
+    const auto t17 = x1 & t16;
+    const auto t18 = t8 ^ t17;
+    const auto t19 = t12 ^ t10;
+    const auto t20 = ~t4;
+    const auto t21 = x0 & t20;
+    const auto t22 = t3 ^ t21;
+    const auto t23 = x3 & t22;
+    const auto t24 = t19 ^ t23;
+    const auto t25 = ~t1;
+    const auto t26 = x0 | t25;
+    const auto t27 = ~t12;
+    const auto t28 = x3 & t27;
+    const auto t29 = t26 ^ t28;
+    const auto t30 = x1 & t29;
+    const auto t31 = t24 ^ t30;
+    const auto t32 = x5 & t31;
+    const auto t33 = t18 ^ t32;
+    const auto t34 = x0 & t25;
+    const auto t35 = t20 ^ t34;
+    const auto t36 = x3 & x4;
+    const auto t37 = t35 ^ t36;
+    const auto t38 = x2 ^ t13;
+    const auto t39 = x3 & t38;
+    const auto t40 = t0 ^ t39;
+    const auto t41 = x1 & t40;
+    const auto t42 = t37 ^ t41;
+    const auto t43 = ~t31;
+    const auto t44 = x5 & t43;
+    const auto t45 = t42 ^ t44;
+    const auto t46 = x0 | t1;
+    const auto t47 = x3 & t46;
+    const auto t48 = t19 ^ t47;
+    const auto t49 = ~t34;
+    const auto t50 = t49 ^ t39;
+    const auto t51 = x1 & t50;
+    const auto t52 = t48 ^ t51;
+    const auto t53 = ~t14;
+    const auto t54 = t0 | t3;
+    const auto t55 = t54 ^ t34;
+    const auto t56 = x3 & t55;
+    const auto t57 = t53 ^ t56;
+    const auto t58 = x0 & t4;
+    const auto t59 = t12 ^ t58;
+    const auto t60 = t59 ^ t28;
+    const auto t61 = x1 & t60;
+    const auto t62 = t57 ^ t61;
+    const auto t63 = x5 & t62;
+    const auto t64 = t52 ^ t63;
+    const auto t65 = t0 ^ t21;
+    const auto t66 = x3 & t3;
+    const auto t67 = t65 ^ t66;
+    const auto t68 = x0 | t27;
+    const auto t69 = t68 ^ t15;
+    const auto t70 = x1 & t69;
+    const auto t71 = t67 ^ t70;
+    const auto t72 = ~t62;
+    const auto t73 = x5 & t72;
+    const auto t74 = t71 ^ t73;
+    out[25] ^= t33;
+    out[19] ^= t45;
+    out[9] ^= t64;
+    out[0] ^= t74;
+}
+
+inline void sbox5(uint64_t x0, uint64_t x1, uint64_t x2, uint64_t x3, uint64_t x4, uint64_t x5, uint64_t *out)
+{
+    const auto t0 = ~x2;
+    const auto t1 = t0 & x5;
+    const auto t2 = x2 | x5;
+    const auto t3 = x3 & t2;
+    const auto t4 = t1 ^ t3;
+    const auto t5 = ~x5;
+    const auto t6 = t0 | t5;
+    const auto t7 = x3 & t5;
+    const auto t8 = t6 ^ t7;
+    const auto t9 = x1 & t8;
+    const auto t10 = t4 ^ t9;
+    const auto t11 = t0 | x5;
+    const auto t12 = x3 & t11;
+    const auto t13 = t5 ^ t12;
+    const auto t14 = ~t6;
+    const auto t15 = x3 ^ t14;
+    const auto t16 = x1 & t15;
+    const auto t17 = t13 ^ t16;
+    const auto t18 = x4 & t17;
+    const auto t19 = t10 ^ t18;
+    const auto t20 = ~t11;
+    const auto t21 = x3 & x5;
+    const auto t22 = t20 ^ t21;
+    const auto t23 = x2 ^ t5;
+    const auto t24 = x3 & t23;
+    const auto t25 = t14 ^ t24;
+    const auto t26 = x1 & t25;
+    const auto t27 = t22 ^ t26;
+    const auto t28 = ~t1;
+    const auto t29 = x3 & x2;
+    const auto t30 = t28 ^ t29;
+    const auto t31 = x3 | x5;
+    const auto t32 = x1 & t31;
+    const auto t33 = t30 ^ t32;
+    const auto t34 = x4 & t33;
+    const auto t35 = t27 ^ t34;
+    const auto t36 = x0 & t35;
+    const auto t37 = t19 ^ t36;
+    const auto t38 = x3 & t6;
+    const auto t39 = t2 ^ t38;
+    const auto t40 = x3 | t14;
+    const auto t41 = x1 & t40;
+    const auto t42 = t39 ^ t41;
+    const auto t43 = x3 | t6;
+    const auto t44 = x4 & t43;
+    const auto t45 = t42 ^ t44;
+    const auto t46 = ~t2;
+    const auto t47 = x3 | t46;
+    const auto t48 = ~x1;
+    const auto t49 = t48 | t47;
+    const auto t50 = x5 ^ t24;
+    const auto t51 = x4 & t50;
+    const auto t52 = t49 ^ t51;
+    const auto t53 = x0 & t52;
+    const auto t54 = t45 ^ t53;
+    const auto t55 = x3 & t46;
+    const auto t56 = t6 ^ t55;
+    const auto t57 = ~t3;
+    const auto t58 = x1 & t57;
+    const auto t59 = t56 ^ t58;
+    const auto t60 = t23 ^ t12;
+    const auto t61 = x3 ^ t46;
+    const auto t62 = x1 & t61;
+    const auto t63 = t60 ^ t62;
+    const auto t64 = x4 & t63;
+    const auto t65 = t59 ^ t64;
+    const auto t66 = t46 ^ t12;
+    const auto t67 = ~t60;
+    const auto t68 = x1 & t67;
+    const auto t69 = t66 ^ t68;
+    const auto t70 = t6 ^ t21;
+    const auto t71 = x1 & t70;
+    const auto t72 = t67 ^ t71;
+    const auto t73 = x4 & t72;
+    const auto t74 = t69 ^ t73;
+    const auto t75 = x0 & t74;
+    const auto t76 = t65 ^ t75;
+    const auto t77 = x3 & t14;
+    const auto t78 = t20 ^ t77;
+    const auto t79 = t78 ^ t32;
+    const auto t80 = ~t66;
+    const auto t81 = t23 ^ t21;
+    const auto t82 = x1 & t81;
+    const auto t83 = t80 ^ t82;
+    const auto t84 = x4 & t83;
+    const auto t85 = t79 ^ t84;
+    const auto t86 = x3 & t0;
+    const auto t87 = t46 ^ t86;
+    const auto t88 = x1 & t87;
+    const auto t89 = t39 ^ t88;
+    const auto t90 = t12 ^ t62;
+    const auto t91 = x4 & t90;
+    const auto t92 = t89 ^ t91;
+    const auto t93 = x0 & t92;
+    const auto t94 = t85 ^ t93;
+    out[7] ^= t37;
+    out[13] ^= t54;
+    out[24] ^= t76;
+    out[2] ^= t94;
+}
+
+inline void sbox6(uint64_t x0, uint64_t x1, uint64_t x2, uint64_t x3, uint64_t x4, uint64_t x5, uint64_t *out)
+{
+    const auto t0 = ~x1;
+    const auto t1 = x0 & x5;
+    const auto t2 = t0 ^ t1;
+    const auto t3 = ~x5;
+    const auto t4 = ~x0;
+    const auto t5 = t4 & t3;
+    const auto t6 = x4 & t5;
+    const auto t7 = t2 ^ t6;
+    const auto t8 = t0 & x5;
+    const auto t9 = x0 & t8;
+    const auto t10 = x5 ^ t9;
+    const auto t11 = x4 | t10;
+    const auto t12 = x3 & t11;
+    const auto t13 = t7 ^ t12;
+    const auto t14 = x1 ^ x5;
+    const auto t15 = ~t8;
+    const auto t16 = x0 & t15;
+    const auto t17 = t14 ^ t16;
+    const auto t18 = x5 ^ t16;
+    const auto t19 = x4 & t18;
+    const auto t20 = t17 ^ t19;
+    const auto t21 = x1 & x5;
+    const auto t22 = x0 & t21;
+    const auto t23 = t15 ^ t22;
+    const auto t24 = x4 & t3;
+    const auto t25 = t23 ^ t24;
+    const auto t26 = x3 & t25;
+    const auto t27 = t20 ^ t26;
+    const auto t28 = x2 & t27;
+    const auto t29 = t13 ^ t28;
+    const auto t30 = ~t14;
+    const auto t31 = x0 ^ t30;
+    const auto t32 = x4 ^ t31;
+    const auto t33 = x0 & t30;
+    const auto t34 = t21 ^ t33;
+    const auto t35 = x4 & t34;
+    const auto t36 = t0 ^ t35;
+    const auto t37 = x3 & t36;
+    const auto t38 = t32 ^ t37;
+    const auto t39 = x1 | x5;
+    const auto t40 = t4 | t39;
+    const auto t41 = ~t39;
+    const auto t42 = t4 | t41;
+    const auto t43 = x4 & t42;
+    const auto t44 = t40 ^ t43;
+    const auto t45 = x4 & t4;
+    const auto t46 = t22 ^ t45;
+    const auto t47 = x3 & t46;
+    const auto t48 = t44 ^ t47;
+    const auto t49 = x2 & t48;
+    const auto t50 = t38 ^ t49;
+    const auto t51 = x0 & t14;
+    const auto t52 = x5 ^ t51;
+    const auto t53 = x0 ^ t21;
+    const auto t54 = x4 & t53;
+    const auto t55 = t52 ^ t54;
+    const auto t56 = x0 & t39;
+    const auto t57 = t30 ^ t56;
+    const auto t58 = ~x4;
+    const auto t59 = t58 | t57;
+    const auto t60 = x3 & t59;
+    const auto t61 = t55 ^ t60;
+    const auto t62 = x1 ^ t33;
+    const auto t63 = t0 ^ t16;
+    const auto t64 = x4 & t63;
+    const auto t65 = t62 ^ t64;
+    const auto t66 = x2 & t65;
+    const auto t67 = t61 ^ t66;
+    const auto t68 = x4 ^ t16;
+    const auto t69 = x1 ^ t22;
+    const auto t70 = x0 | t8;
+    const auto t71 = x4 & t70;
+    const auto t72 = t69 ^ t71;
+    const auto t73 = x3 & t72;
+    const auto t74 = t68 ^ t73;
+    const auto t75 = ~t69;
+    const auto t76 = x4 & x0;
+    const auto t77 = t75 ^ t76;
+    const auto t78 = x0 & t3;
+    const auto t79 = t41 ^ t78;
+    const auto t80 = t79 ^ t6;
+    const auto t81 = x3 & t80;
+    const auto t82 = t77 ^ t81;
+    const auto t83 = x2 & t82;
+    const auto t84 = t74 ^ t83;
+    out[3] ^= t29;
+    out[28] ^= t50;
+    out[10] ^= t67;
+    out[18] ^= t84;
+}
+
+inline void sbox7(uint64_t x0, uint64_t x1, uint64_t x2, uint64_t x3, uint64_t x4, uint64_t x5, uint64_t *out)
+{
+    const auto t0 = ~x0;
+    const auto t1 = t0 & x5;
+    const auto t2 = ~x5;
+    const auto t3 = t0 | t2;
+    const auto t4 = x2 & t3;
+    const auto t5 = t1 ^ t4;
+    const auto t6 = t0 | x5;
+    const auto t7 = x2 & x0;
+    const auto t8 = t6 ^ t7;
+    const auto t9 = x4 & t8;
+    const auto t10 = t5 ^ t9;
+    const auto t11 = ~t3;
+    const auto t12 = t0 & t2;
+    const auto t13 = x2 & t12;
+    const auto t14 = t11 ^ t13;
+    const auto t15 = x4 & t14;
+    const auto t16 = x0 ^ t15;
+    const auto t17 = x3 & t16;
+    const auto t18 = t10 ^ t17;
+    const auto t19 = x0 ^ t13;
+    const auto t20 = x4 & t7;
+    const auto t21 = t19 ^ t20;
+    const auto t22 = ~t19;
+    const auto t23 = x4 & x0;
+    const auto t24 = t22 ^ t23;
+    const auto t25 = x3 & t24;
+    const auto t26 = t21 ^ t25;
+    const auto t27 = x1 & t26;
+    const auto t28 = t18 ^ t27;
+    const auto t29 = x4 ^ t8;
+    const auto t30 = x0 ^ x5;
+    const auto t31 = x2 & t30;
+    const auto t32 = x4 & t31;
+    const auto t33 = t0 ^ t32;
+    const auto t34 = x3 & t33;
+    const auto t35 = t29 ^ t34;
+    const auto t36 = ~t30;
+    const auto t37 = t36 ^ t4;
+    const auto t38 = t3 ^ t7;
+    const auto t39 = x4 & t1;
+    const auto t40 = t38 ^ t39;
+    const auto t41 = x3 & t40;
+    const auto t42 = t37 ^ t41;
+    const auto t43 = x1 & t42;
+    const auto t44 = t35 ^ t43;
+    const auto t45 = x2 & t36;
+    const auto t46 = t11 ^ t45;
+    const auto t47 = ~t6;
+    const auto t48 = x2 & t47;
+    const auto t49 = t12 ^ t48;
+    const auto t50 = x4 & t49;
+    const auto t51 = t46 ^ t50;
+    const auto t52 = ~t1;
+    const auto t53 = ~x2;
+    const auto t54 = t53 | t52;
+    const auto t55 = x2 & t1;
+    const auto t56 = t2 ^ t55;
+    const auto t57 = x4 & t56;
+    const auto t58 = t54 ^ t57;
+    const auto t59 = x3 & t58;
+    const auto t60 = t51 ^ t59;
+    const auto t61 = ~t48;
+    const auto t62 = x4 | t61;
+    const auto t63 = x0 ^ t55;
+    const auto t64 = x4 & t36;
+    const auto t65 = t63 ^ t64;
+    const auto t66 = x3 & t65;
+    const auto t67 = t62 ^ t66;
+    const auto t68 = x1 & t67;
+    const auto t69 = t60 ^ t68;
+    const auto t70 = x2 ^ t30;
+    const auto t71 = x4 ^ t70;
+    const auto t72 = x2 | t11;
+    const auto t73 = x4 | t72;
+    const auto t74 = x3 & t73;
+    const auto t75 = t71 ^ t74;
+    const auto t76 = ~t4;
+    const auto t77 = x4 & t11;
+    const auto t78 = t76 ^ t77;
+    const auto t79 = x4 & x5;
+    const auto t80 = t1 ^ t79;
+    const auto t81 = x3 & t80;
+    const auto t82 = t78 ^ t81;
+    const auto t83 = x1 & t82;
+    const auto t84 = t75 ^ t83;
+    out[31] ^= t28;
+    out[11] ^= t44;
+    out[21] ^= t69;
+    out[6] ^= t84;
+}
+
+inline void sbox8(uint64_t x0, uint64_t x1, uint64_t x2, uint64_t x3, uint64_t x4, uint64_t x5, uint64_t *out)
+{
+    const auto t0 = ~x4;
+    const auto t1 = x2 ^ t0;
+    const auto t2 = x3 & x2;
+    const auto t3 = t1 ^ t2;
+    const auto t4 = ~t1;
+    const auto t5 = ~x3;
+    const auto t6 = t5 | t4;
+    const auto t7 = x5 & t6;
+    const auto t8 = t3 ^ t7;
+    const auto t9 = x3 & t1;
+    const auto t10 = x4 ^ t9;
+    const auto t11 = ~x2;
+    const auto t12 = x3 & t11;
+    const auto t13 = t0 ^ t12;
+    const auto t14 = x5 & t13;
+    const auto t15 = t10 ^ t14;
+    const auto t16 = x1 & t15;
+    const auto t17 = t8 ^ t16;
+    const auto t18 = t11 | t0;
+    const auto t19 = x3 & t4;
+    const auto t20 = t18 ^ t19;
+    const auto t21 = x3 | t1;
+    const auto t22 = x5 & t21;
+    const auto t23 = t20 ^ t22;
+    const auto t24 = x2 & t0;
+    const auto t25 = t24 ^ t9;
+    const auto t26 = x5 & t25;
+    const auto t27 = t2 ^ t26;
+    const auto t28 = x1 & t27;
+    const auto t29 = t23 ^ t28;
+    const auto t30 = x0 & t29;
+    const auto t31 = t17 ^ t30;
+    const auto t32 = x2 | t0;
+    const auto t33 = x3 ^ t32;
+    const auto t34 = x5 ^ t33;
+    const auto t35 = x3 & t0;
+    const auto t36 = t1 ^ t35;
+    const auto t37 = x1 & t36;
+    const auto t38 = t34 ^ t37;
+    const auto t39 = t24 ^ t12;
+    const auto t40 = ~t32;
+    const auto t41 = t40 ^ t12;
+    const auto t42 = x5 & t41;
+    const auto t43 = t39 ^ t42;
+    const auto t44 = x3 | t4;
+    const auto t45 = x5 & t2;
+    const auto t46 = t44 ^ t45;
+    const auto t47 = x1 & t46;
+    const auto t48 = t43 ^ t47;
+    const auto t49 = x0 & t48;
+    const auto t50 = t38 ^ t49;
+    const auto t51 = x2 | x4;
+    const auto t52 = x3 & x4;
+    const auto t53 = t51 ^ t52;
+    const auto t54 = ~x5;
+    const auto t55 = t54 | t44;
+    const auto t56 = x1 & t55;
+    const auto t57 = t53 ^ t56;
+    const auto t58 = t32 ^ t35;
+    const auto t59 = x3 | x4;
+    const auto t60 = x5 & t59;
+    const auto t61 = t58 ^ t60;
+    const auto t62 = ~t18;
+    const auto t63 = t62 ^ t52;
+    const auto t64 = x5 & t63;
+    const auto t65 = t40 ^ t64;
+    const auto t66 = x1 & t65;
+    const auto t67 = t61 ^ t66;
+    const auto t68 = x0 & t67;
+    const auto t69 = t57 ^ t68;
+    const auto t70 = ~t24;
+    const auto t71 = x3 & t70;
+    const auto t72 = t40 ^ t71;
+    const auto t73 = x5 & t72;
+    const auto t74 = t36 ^ t73;
+    const auto t75 = ~t52;
+    const auto t76 = x5 & t4;
+    const auto t77 = t75 ^ t76;
+    const auto t78 = x1 & t77;
+    const auto t79 = t74 ^ t78;
+    const auto t80 = x5 & t20;
+    const auto t81 = t51 ^ t80;
+    const auto t82 = t24 ^ t35;
+    const auto t83 = t82 ^ t42;
+    const auto t84 = x1 & t83;
+    const auto t85 = t81 ^ t84;
+    const auto t86 = x0 & t85;
+    const auto t87 = t79 ^ t86;
+    out[4] ^= t31;
+    out[26] ^= t50;
+    out[14] ^= t69;
+    out[20] ^= t87;
+}
+
+/**
+ * DES bit number taken by initial permutation for output bit index: columns of the block read bottom up,
+ * even rows first.
+ */
+constexpr size_t initial_permutation_source(size_t index)
+{
+    const auto row = index / 8;
+    const auto column = index % 8;
+    return 8 * (7 - column) + (row < 4 ? 2 * row + 2 : 2 * (row - 4) + 1);
+}
+
+/**
+ * Hacker's Delight transposition generalized to 64x64: bit 63 - c of row r swaps with bit 63 - r of row c.
+ */
+void transpose(std::array<uint64_t, des_bitsliced_blocks> &rows)
+{
+    uint64_t mask = 0x00000000FFFFFFFF;
+    for (size_t width = 32; width != 0; width >>= 1, mask ^= mask << width)
+    {
+        for (size_t k = 0; k < rows.size(); k = ((k | width) + 1) & ~width)
+        {
+            const auto swap = (rows[k] ^ (rows[k | width] >> width)) & mask;
+            rows[k] ^= swap;
+            rows[k | width] ^= swap << width;
+        }
+    }
+}
+
+void feistel(HalfPlanes &target, const HalfPlanes &source, const std::array<uint64_t, 48> &key)
+{
+    // expansion: box b reads half bits 4b .. 4b + 5, DES numbering, wrapping around
+    const auto expanded = [&](size_t box, size_t bit)
+    {
+        return source[(4 * box + bit + 31) % 32] ^ key[6 * box + bit];
+    };
+    sbox1(expanded(0, 0), expanded(0, 1), expanded(0, 2), expanded(0, 3), expanded(0, 4), expanded(0, 5),
+            target.data());
+    sbox2(expanded(1, 0), expanded(1, 1), expanded(1, 2), expanded(1, 3), expanded(1, 4), expanded(1, 5),
+            target.data());
+    sbox3(expanded(2, 0), expanded(2, 1), expanded(2, 2), expanded(2, 3), expanded(2, 4), expanded(2, 5),
+            target.data());
+    sbox4(expanded(3, 0), expanded(3, 1), expanded(3, 2), expanded(3, 3), expanded(3, 4), expanded(3, 5),
+            target.data());
+    sbox5(expanded(4, 0), expanded(4, 1), expanded(4, 2), expanded(4, 3), expanded(4, 4), expanded(4, 5),
+            target.data());
+    sbox6(expanded(5, 0), expanded(5, 1), expanded(5, 2), expanded(5, 3), expanded(5, 4), expanded(5, 5),
+            target.data());
+    sbox7(expanded(6, 0), expanded(6, 1), expanded(6, 2), expanded(6, 3), expanded(6, 4), expanded(6, 5),
+            target.data());
+    sbox8(expanded(7, 0), expanded(7, 1), expanded(7, 2), expanded(7, 3), expanded(7, 4), expanded(7, 5),
+            target.data());
+}
+
+void des_bitsliced_set_key(BitslicedDesKey &key, const std::array<uint32_t, 32> &round_keys, uint64_t lanes)
+{
+    // table engine keeps 6-bit groups of odd S-boxes in the first word of a round, even ones in the second
+    for (size_t round = 0; round < key.size(); ++round)
+    {
+        for (size_t bit = 0; bit < 48; ++bit)
+        {
+            const auto group = bit / 6;
+            const auto word = round_keys[2 * round + group % 2];
+            const uint64_t value = (word >> (24 - 8 * (group / 2) + 5 - bit % 6)) & 1;
+            key[round][bit] = (key[round][bit] & ~lanes) | ((0 - value) & lanes);
+        }
+    }
+}
+
+void des_bitsliced_process(std::array<uint64_t, des_bitsliced_blocks> &blocks,
+        const BitslicedDesKey *keys,
+        size_t key_count)
+{
+    transpose(blocks);
+    HalfPlanes left;
+    HalfPlanes right;
+    for (size_t i = 0; i < 32; ++i)
+    {
+        left[i] = blocks[initial_permutation_source(i) - 1];
+        right[i] = blocks[initial_permutation_source(32 + i) - 1];
+    }
+    for (size_t i = 0; i < key_count; ++i)
+    {
+        for (size_t round = 0; round < 16; round += 2)
+        {
+            feistel(left, right, keys[i][round]);
+            feistel(right, left, keys[i][round + 1]);
+        }
+        std::swap(left, right);
+    }
+    // final permutation is the inverse of the initial one
+    for (size_t i = 0; i < 32; ++i)
+    {
+        blocks[initial_permutation_source(i) - 1] = left[i];
+        blocks[initial_permutation_source(32 + i) - 1] = right[i];
+    }
+    transpose(blocks);
+}
@@ -0,0 +1,41 @@
+#ifndef TLS_PLAYGROUND_DES_BITSLICED_HPP
+#define TLS_PLAYGROUND_DES_BITSLICED_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Bitsliced DES: 64 blocks are transposed into 64 bit planes and S-boxes are evaluated as boolean circuits,
+ * so every block of a batch goes through the rounds together and nothing depends on key or data.
+ */
+
+constexpr size_t des_bitsliced_blocks = 64;
+
+/**
+ * Round key bits as planes: bit of a lane is the key bit of the stream processed in that lane.
+ */
+using BitslicedDesKey = std::array<std::array<uint64_t, 48>, 16>;
+
+/**
+ * Plane bit holding given block of a batch.
+ */
+constexpr uint64_t des_bitsliced_lane(size_t block)
+{
+    return uint64_t{ 1 } << (des_bitsliced_blocks - 1 - block);
+}
+
+/**
+ * Sets round keys of the selected lanes from round keys of the table engine (DesKey).
+ */
+void des_bitsliced_set_key(BitslicedDesKey &key, const std::array<uint32_t, 32> &round_keys, uint64_t lanes);
+
+/**
+ * Blocks are big endian 64-bit words, processed in place by the given keys one after another,
+ * so 3DES passes three keys and runs initial and final permutations once.
+ */
+void des_bitsliced_process(std::array<uint64_t, des_bitsliced_blocks> &blocks,
+        const BitslicedDesKey *keys,
+        size_t key_count);
+
+#endif //TLS_PLAYGROUND_DES_BITSLICED_HPP
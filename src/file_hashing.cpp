@@ -0,0 +1,232 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <future>
+#include <span>
+#include <stdexcept>
+#include <thread>
+#include <variant>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "md5.hpp"
+#include "sha.hpp"
+
+#include "file_hashing.hpp"
+
+using FileHashing = std::variant<Md5Hashing, Sha1Hashing, Sha256Hashing, Sha384Hashing, Sha512Hashing>;
+
+/**
+ * Chunk of the read pipeline, big enough that a chunk takes much longer to hash than to hand over to the reader.
+ */
+const size_t read_chunk_size = 1 << 20;
+
+HashAlgorithm parse_hash_algorithm(const std::string &name)
+{
+    if (name == "md5")
+    {
+        return HashAlgorithm::Md5;
+    }
+    if (name == "sha1")
+    {
+        return HashAlgorithm::Sha1;
+    }
+    if (name == "sha256")
+    {
+        return HashAlgorithm::Sha256;
+    }
+    if (name == "sha384")
+    {
+        return HashAlgorithm::Sha384;
+    }
+    if (name == "sha512")
+    {
+        return HashAlgorithm::Sha512;
+    }
+    throw std::runtime_error("unknown hash algorithm " + name);
+}
+
+FileHashing make_file_hashing(HashAlgorithm algorithm)
+{
+    switch (algorithm)
+    {
+    case HashAlgorithm::Md5:
+        return Md5Hashing{};
+    case HashAlgorithm::Sha1:
+        return Sha1Hashing{};
+    case HashAlgorithm::Sha256:
+        return Sha256Hashing{};
+    case HashAlgorithm::Sha384:
+        return Sha384Hashing{};
+    case HashAlgorithm::Sha512:
+        return Sha512Hashing{};
+    }
+    throw std::runtime_error("unknown hash algorithm");
+}
+
+std::runtime_error file_error(const std::filesystem::path &path, const std::string &operation)
+{
+    return std::runtime_error(path.string() + ": " + operation + " failed: " + std::strerror(errno));
+}
+
+class FileDescriptor
+{
+    int descriptor;
+public:
+    explicit FileDescriptor(const std::filesystem::path &path) : descriptor(::open(path.c_str(), O_RDONLY))
+    {
+        if (descriptor < 0)
+        {
+            throw file_error(path, "open");
+        }
+    }
+
+    FileDescriptor(const FileDescriptor &) = delete;
+
+    FileDescriptor &operator=(const FileDescriptor &) = delete;
+
+    ~FileDescriptor()
+    {
+        ::close(descriptor);
+    }
+
+    [[nodiscard]]
+    int get() const
+    {
+        return descriptor;
+    }
+};
+
+/**
+ * @return false when the file can't be mapped, nothing is hashed then
+ */
+bool hash_mapped(int descriptor, size_t size, FileHashing &hashing)
+{
+    void *mapping = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    if (mapping == MAP_FAILED)
+    {
+        return false;
+    }
+    // read ahead aggressively and drop pages behind the cursor early
+    ::madvise(mapping, size, MADV_SEQUENTIAL);
+    const std::span data(static_cast<const unsigned char *>(mapping), size);
+    std::visit([data](auto &file_hashing)
+    {
+        file_hashing.append(data);
+    }, hashing);
+    ::munmap(mapping, size);
+    return true;
+}
+
+/**
+ * Fills buffer unless the end of file comes first.
+ * @return number of bytes read, 0 at end of file
+ */
+size_t read_chunk(int descriptor, const std::filesystem::path &path, std::vector<unsigned char> &buffer)
+{
+    size_t filled = 0;
+    while (filled < buffer.size())
+    {
+        const auto result = ::read(descriptor, buffer.data() + filled, buffer.size() - filled);
+        if (result == 0)
+        {
+            break;
+        }
+        if (result < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            throw file_error(path, "read");
+        }
+        filled += static_cast<size_t>(result);
+    }
+    return filled;
+}
+
+void hash_streamed(int descriptor, const std::filesystem::path &path, FileHashing &hashing)
+{
+    std::array<std::vector<unsigned char>, 2> buffers{ std::vector<unsigned char>(read_chunk_size),
+                                                       std::vector<unsigned char>(read_chunk_size) };
+    const auto read_into = [descriptor, &path, &buffers](size_t buffer)
+    {
+        return std::async(std::launch::async, read_chunk, descriptor, std::cref(path), std::ref(buffers[buffer]));
+    };
+    auto pending = read_into(0);
+    for (size_t current = 0;; current ^= 1)
+    {
+        const auto size = pending.get();
+        if (size == 0)
+        {
+            break;
+        }
+        pending = read_into(current ^ 1);
+        const auto data = std::span<const unsigned char>(buffers[current]).first(size);
+        std::visit([data](auto &file_hashing)
+        {
+            file_hashing.append(data);
+        }, hashing);
+    }
+}
+
+std::vector<unsigned char> hash_file(const std::filesystem::path &path, HashAlgorithm algorithm)
+{
+    const FileDescriptor file(path);
+    struct stat status{};
+    if (::fstat(file.get(), &status) != 0)
+    {
+        throw file_error(path, "stat");
+    }
+    if (S_ISDIR(status.st_mode))
+    {
+        throw std::runtime_error(path.string() + ": is a directory");
+    }
+    auto hashing = make_file_hashing(algorithm);
+    const bool mappable = S_ISREG(status.st_mode) && status.st_size > 0;
+    if (!mappable || !hash_mapped(file.get(), static_cast<size_t>(status.st_size), hashing))
+    {
+        hash_streamed(file.get(), path, hashing);
+    }
+    return std::visit([](auto &file_hashing)
+    {
+        const auto digest = file_hashing.close();
+        return std::vector<unsigned char>(digest.begin(), digest.end());
+    }, hashing);
+}
+
+std::vector<FileHash> hash_files(const std::vector<std::filesystem::path> &paths, HashAlgorithm algorithm,
+        size_t threads)
+{
+    std::vector<FileHash> result(paths.size());
+    std::atomic<size_t> next_file{};
+    const auto worker = [&]()
+    {
+        for (auto file = next_file++; file < paths.size(); file = next_file++)
+        {
+            result[file].path = paths[file];
+            try
+            {
+                result[file].digest = hash_file(paths[file], algorithm);
+            }
+            catch (const std::exception &e)
+            {
+                result[file].error = e.what();
+            }
+        }
+    };
+    {
+        std::vector<std::jthread> workers;
+        for (size_t thread = 1; thread < std::min(threads, paths.size()); ++thread)
+        {
+            workers.emplace_back(worker);
+        }
+        worker();
+    }
+    return result;
+}
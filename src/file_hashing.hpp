@@ -0,0 +1,49 @@
+#ifndef TLS_PLAYGROUND_FILE_HASHING_HPP
+#define TLS_PLAYGROUND_FILE_HASHING_HPP
+
+#include <cstddef>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+enum class HashAlgorithm
+{
+    Md5,
+    Sha1,
+    Sha256,
+    Sha384,
+    Sha512
+};
+
+/**
+ * @param name md5, sha1, sha256, sha384 or sha512
+ * @throws std::runtime_error for unknown names
+ */
+HashAlgorithm parse_hash_algorithm(const std::string &name);
+
+/**
+ * Hashes a file without loading it into memory. Regular files are memory mapped and read sequentially,
+ * anything else (pipes, devices, empty files) goes through a double-buffered read pipeline where the next chunk
+ * is read while the current one is hashed.
+ * @throws std::runtime_error when the file can't be opened or read
+ */
+std::vector<unsigned char> hash_file(const std::filesystem::path &path, HashAlgorithm algorithm);
+
+struct FileHash
+{
+    std::filesystem::path path;
+    std::vector<unsigned char> digest;
+    /**
+     * Failure reason, empty when digest is valid.
+     */
+    std::string error;
+};
+
+/**
+ * Hashes files on up to threads worker threads, one file per thread at a time. A failing file doesn't stop
+ * the others. Results are in the order of paths.
+ */
+std::vector<FileHash> hash_files(const std::vector<std::filesystem::path> &paths, HashAlgorithm algorithm,
+        size_t threads);
+
+#endif //TLS_PLAYGROUND_FILE_HASHING_HPP
@@ -0,0 +1,317 @@
+#include <algorithm>
+#include <stdexcept>
+
+#include "cpu_features.hpp"
+
+#include "gcm.hpp"
+
+#if TLS_PLAYGROUND_X86
+#include <immintrin.h>
+#endif
+
+/**
+ * Reduction of 4 bits shifted out of the low end, already placed in the top 16 bits.
+ */
+constexpr std::array<uint64_t, 16> remainder_table{
+        0x0000, 0x1c20, 0x3840, 0x2460, 0x7080, 0x6ca0, 0x48c0, 0x54e0,
+        0xe100, 0xfd20, 0xd940, 0xc560, 0x9180, 0x8da0, 0xa9c0, 0xb5e0
+};
+
+uint64_t load_big_endian(const unsigned char *bytes)
+{
+    uint64_t result = 0;
+    for (size_t i = 0; i < 8; ++i)
+    {
+        result = result << 8 | bytes[i];
+    }
+    return result;
+}
+
+void store_big_endian(uint64_t value, unsigned char *bytes)
+{
+    for (size_t i = 8; i-- > 0;)
+    {
+        bytes[i] = value & 0xFF;
+        value >>= 8;
+    }
+}
+
+GhashKey::GhashKey(const std::array<unsigned char, 16> &hash_key)
+{
+    // GCM bit order is reflected: index 8 is H, smaller powers of two are H multiplied by x
+    uint64_t high = load_big_endian(hash_key.data());
+    uint64_t low = load_big_endian(hash_key.data() + 8);
+    table_high[8] = high;
+    table_low[8] = low;
+    for (size_t i = 4; i > 0; i >>= 1)
+    {
+        const uint64_t reduction = (low & 1) != 0 ? 0xe100000000000000 : 0;
+        low = high << 63 | low >> 1;
+        high = high >> 1 ^ reduction;
+        table_high[i] = high;
+        table_low[i] = low;
+    }
+    for (size_t i = 2; i <= 8; i <<= 1)
+    {
+        for (size_t j = 1; j < i; ++j)
+        {
+            table_high[i + j] = table_high[i] ^ table_high[j];
+            table_low[i + j] = table_low[i] ^ table_low[j];
+        }
+    }
+
+    powers[0] = hash_key;
+    for (size_t i = 1; i < powers.size(); ++i)
+    {
+        powers[i] = powers[i - 1];
+        multiply(powers[i]);
+    }
+}
+
+void GhashKey::multiply(std::array<unsigned char, 16> &value) const
+{
+    uint64_t high = table_high[value[15] & 0x0F];
+    uint64_t low = table_low[value[15] & 0x0F];
+    for (size_t i = 16; i-- > 0;)
+    {
+        const auto low_nibble = value[i] & 0x0F;
+        const auto high_nibble = value[i] >> 4;
+        if (i != 15)
+        {
+            const auto remainder = low & 0x0F;
+            low = high << 60 | low >> 4;
+            high = high >> 4 ^ remainder_table[remainder] << 48;
+            high ^= table_high[low_nibble];
+            low ^= table_low[low_nibble];
+        }
+        const auto remainder = low & 0x0F;
+        low = high << 60 | low >> 4;
+        high = high >> 4 ^ remainder_table[remainder] << 48;
+        high ^= table_high[high_nibble];
+        low ^= table_low[high_nibble];
+    }
+    store_big_endian(high, value.data());
+    store_big_endian(low, value.data() + 8);
+}
+
+#if TLS_PLAYGROUND_X86
+
+/**
+ * Carry-less multiplication works on byte reversed values, then GCM reflected bit order only needs shift by one.
+ */
+TLS_PLAYGROUND_TARGET("ssse3")
+inline __m128i reverse_bytes(__m128i value)
+{
+    return _mm_shuffle_epi8(value, _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+}
+
+TLS_PLAYGROUND_TARGET("pclmul,sse2")
+inline void multiply_unreduced(__m128i first, __m128i second, __m128i &low, __m128i &high)
+{
+    const auto middle = _mm_xor_si128(_mm_clmulepi64_si128(first, second, 0x10),
+            _mm_clmulepi64_si128(first, second, 0x01));
+    low = _mm_xor_si128(low, _mm_xor_si128(_mm_clmulepi64_si128(first, second, 0x00), _mm_slli_si128(middle, 8)));
+    high = _mm_xor_si128(high, _mm_xor_si128(_mm_clmulepi64_si128(first, second, 0x11), _mm_srli_si128(middle, 8)));
+}
+
+/**
+ * Reduces 256-bit product modulo x^128 + x^7 + x^2 + x + 1. Linear, so a sum of products needs a single reduction.
+ */
+TLS_PLAYGROUND_TARGET("sse2")
+inline __m128i reduce(__m128i low, __m128i high)
+{
+    // shift the 256-bit value left by one to account for reflected bit order
+    auto low_carry = _mm_srli_epi32(low, 31);
+    auto high_carry = _mm_srli_epi32(high, 31);
+    low = _mm_slli_epi32(low, 1);
+    high = _mm_slli_epi32(high, 1);
+    const auto middle_carry = _mm_srli_si128(low_carry, 12);
+    high_carry = _mm_slli_si128(high_carry, 4);
+    low_carry = _mm_slli_si128(low_carry, 4);
+    low = _mm_or_si128(low, low_carry);
+    high = _mm_or_si128(_mm_or_si128(high, high_carry), middle_carry);
+
+    auto first = _mm_xor_si128(_mm_xor_si128(_mm_slli_epi32(low, 31), _mm_slli_epi32(low, 30)),
+            _mm_slli_epi32(low, 25));
+    const auto second = _mm_srli_si128(first, 4);
+    first = _mm_slli_si128(first, 12);
+    low = _mm_xor_si128(low, first);
+    auto folded = _mm_xor_si128(_mm_xor_si128(_mm_srli_epi32(low, 1), _mm_srli_epi32(low, 2)),
+            _mm_srli_epi32(low, 7));
+    folded = _mm_xor_si128(folded, second);
+    low = _mm_xor_si128(low, folded);
+    return _mm_xor_si128(high, low);
+}
+
+TLS_PLAYGROUND_TARGET("pclmul,ssse3,sse2")
+void ghash_clmul(unsigned char *state, const unsigned char *data, size_t blocks,
+        const std::array<std::array<unsigned char, 16>, 4> &powers)
+{
+    __m128i hash_powers[4];
+    for (size_t i = 0; i < 4; ++i)
+    {
+        hash_powers[i] = reverse_bytes(_mm_loadu_si128(reinterpret_cast<const __m128i *>(powers[i].data())));
+    }
+    auto value = reverse_bytes(_mm_loadu_si128(reinterpret_cast<const __m128i *>(state)));
+    size_t i = 0;
+    // (((X + A) * H + B) * H + C) * H + D) * H = (X + A) * H^4 + B * H^3 + C * H^2 + D * H
+    for (; i + 4 <= blocks; i += 4)
+    {
+        auto low = _mm_setzero_si128();
+        auto high = _mm_setzero_si128();
+        for (size_t j = 0; j < 4; ++j)
+        {
+            auto block = reverse_bytes(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 16 * (i + j))));
+            if (j == 0)
+            {
+                block = _mm_xor_si128(block, value);
+            }
+            multiply_unreduced(block, hash_powers[3 - j], low, high);
+        }
+        value = reduce(low, high);
+    }
+    for (; i < blocks; ++i)
+    {
+        auto low = _mm_setzero_si128();
+        auto high = _mm_setzero_si128();
+        const auto block = reverse_bytes(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 16 * i)));
+        multiply_unreduced(_mm_xor_si128(block, value), hash_powers[0], low, high);
+        value = reduce(low, high);
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(state), reverse_bytes(value));
+}
+
+#endif
+
+void GhashKey::update(std::array<unsigned char, 16> &state, std::span<const unsigned char> data) const
+{
+    const auto whole_blocks = data.size() / 16;
+#if TLS_PLAYGROUND_X86
+    if (cpu_features().pclmul)
+    {
+        ghash_clmul(state.data(), data.data(), whole_blocks, powers);
+    }
+    else
+#endif
+    {
+        for (size_t i = 0; i < whole_blocks; ++i)
+        {
+            for (size_t j = 0; j < 16; ++j)
+            {
+                state[j] ^= data[16 * i + j];
+            }
+            multiply(state);
+        }
+    }
+    if (data.size() % 16 != 0)
+    {
+        for (size_t j = 16 * whole_blocks; j < data.size(); ++j)
+        {
+            state[j % 16] ^= data[j];
+        }
+        multiply(state);
+    }
+}
+
+/**
+ * Encryption runs in pieces small enough to be hashed while they are still in L1 cache.
+ */
+constexpr size_t gcm_chunk_size = 4096;
+
+std::array<unsigned char, 16> initial_counter(const std::array<unsigned char, 12> &iv)
+{
+    std::array<unsigned char, 16> result{};
+    std::copy(iv.begin(), iv.end(), result.begin());
+    result[15] = 1;
+    return result;
+}
+
+std::array<unsigned char, 16> length_block(size_t additional_data_size, size_t data_size)
+{
+    std::array<unsigned char, 16> result{};
+    store_big_endian(static_cast<uint64_t>(additional_data_size) * 8, result.data());
+    store_big_endian(static_cast<uint64_t>(data_size) * 8, result.data() + 8);
+    return result;
+}
+
+template<size_t bits>
+std::array<unsigned char, 16> compute_hash_key(const AesKey<bits> &key)
+{
+    // H is encryption of zero block, CTR with zero counter over zero data gives exactly that
+    std::array<unsigned char, 16> result{};
+    aes_ctr_crypt(std::span(result), std::span(result), {}, key);
+    return result;
+}
+
+template<size_t bits>
+AesGcm<bits>::AesGcm(const std::array<unsigned char, bits / 8> &key)
+        : key(key), hash_key(compute_hash_key(this->key))
+{
+}
+
+template<size_t bits>
+std::vector<unsigned char> AesGcm<bits>::encrypt(const std::vector<unsigned char> &input,
+        const std::array<unsigned char, 12> &iv,
+        const std::vector<unsigned char> &additional_data) const
+{
+    const auto counter = initial_counter(iv);
+    std::array<unsigned char, 16> state{};
+    hash_key.update(state, additional_data);
+    std::vector<unsigned char> result(input.size() + 16);
+    std::copy(input.begin(), input.end(), result.begin());
+    for (size_t i = 0; i < input.size(); i += gcm_chunk_size)
+    {
+        // key stream starts with the block after initial counter
+        const auto chunk = std::span(result).subspan(i, std::min(gcm_chunk_size, input.size() - i));
+        aes_ctr_crypt(chunk, chunk, counter, key, 16 + i);
+        hash_key.update(state, chunk);
+    }
+    hash_key.update(state, length_block(additional_data.size(), input.size()));
+    aes_ctr_crypt(std::span(state), std::span(state), counter, key);
+    std::copy(state.begin(), state.end(), result.end() - 16);
+    return result;
+}
+
+template<size_t bits>
+std::vector<unsigned char> AesGcm<bits>::decrypt(const std::vector<unsigned char> &cypher_data,
+        const std::array<unsigned char, 12> &iv,
+        const std::vector<unsigned char> &additional_data) const
+{
+    if (cypher_data.size() < 16)
+    {
+        throw std::runtime_error("Malformed cypher data");
+    }
+    const auto size = cypher_data.size() - 16;
+    const auto counter = initial_counter(iv);
+    std::array<unsigned char, 16> state{};
+    hash_key.update(state, additional_data);
+    std::vector<unsigned char> result(cypher_data.begin(), cypher_data.end() - 16);
+    for (size_t i = 0; i < size; i += gcm_chunk_size)
+    {
+        const auto chunk = std::span(result).subspan(i, std::min(gcm_chunk_size, size - i));
+        hash_key.update(state, chunk);
+        aes_ctr_crypt(chunk, chunk, counter, key, 16 + i);
+    }
+    hash_key.update(state, length_block(additional_data.size(), size));
+    aes_ctr_crypt(std::span(state), std::span(state), counter, key);
+    // compare without early exit, so timing doesn't tell how many tag bytes matched
+    unsigned char difference = 0;
+    for (size_t i = 0; i < state.size(); ++i)
+    {
+        difference |= state[i] ^ cypher_data[size + i];
+    }
+    if (difference != 0)
+    {
+        throw std::runtime_error("gcm authentication failed");
+    }
+    return result;
+}
+
+template
+class AesGcm<128>;
+
+template
+class AesGcm<192>;
+
+template
+class AesGcm<256>;
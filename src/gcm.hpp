@@ -0,0 +1,63 @@
+#ifndef TLS_PLAYGROUND_GCM_HPP
+#define TLS_PLAYGROUND_GCM_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "aes.hpp"
+
+/**
+ * Precomputed multiplication by hash key H in GF(2^128): 4-bit tables for portable code
+ * and H^1..H^4 for carry-less multiplication with aggregated reduction.
+ */
+class GhashKey
+{
+    std::array<uint64_t, 16> table_high{};
+    std::array<uint64_t, 16> table_low{};
+    std::array<std::array<unsigned char, 16>, 4> powers{};
+
+    void multiply(std::array<unsigned char, 16> &value) const;
+
+public:
+    explicit GhashKey(const std::array<unsigned char, 16> &hash_key);
+
+    /**
+     * Absorbs data into GHASH state, incomplete last block is padded with zeroes.
+     */
+    void update(std::array<unsigned char, 16> &state, std::span<const unsigned char> data) const;
+};
+
+/**
+ * AES-GCM with 96-bit nonce. Key schedule and GHASH tables are computed once per key.
+ */
+template<size_t bits>
+class AesGcm
+{
+    AesKey<bits> key;
+    GhashKey hash_key;
+
+public:
+    explicit AesGcm(const std::array<unsigned char, bits / 8> &key);
+
+    /**
+     * @return cypher data followed by 16 bytes tag
+     */
+    [[nodiscard]]
+    std::vector<unsigned char> encrypt(const std::vector<unsigned char> &input,
+            const std::array<unsigned char, 12> &iv,
+            const std::vector<unsigned char> &additional_data) const;
+
+    /**
+     * @param cypher_data cypher data followed by 16 bytes tag
+     * @throws std::runtime_error when tag doesn't match
+     */
+    [[nodiscard]]
+    std::vector<unsigned char> decrypt(const std::vector<unsigned char> &cypher_data,
+            const std::array<unsigned char, 12> &iv,
+            const std::vector<unsigned char> &additional_data) const;
+};
+
+#endif //TLS_PLAYGROUND_GCM_HPP
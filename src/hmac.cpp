@@ -1,65 +1,83 @@
+#include <algorithm>
 #include <cstddef>
 
-#include "sha.hpp"
-#include "md5.hpp"
 #include "hmac.hpp"
 
-template<int hash_length>
-std::array<unsigned char, hash_length> hmac(
-        const std::vector<unsigned char> &input,
-        const std::vector<unsigned char> &key,
-        const auto hash_func)
+template<typename Algorithm>
+Hmac<Algorithm>::Hmac(std::span<const unsigned char> key)
 {
-    if (key.size() > 64)
-    {
-        const auto key_hash = hash_func(key);
-        return hmac<hash_length>(input, { key_hash.begin(), key_hash.end() }, hash_func);
-    }
-    std::vector<unsigned char> block(64, 0x36);
-    for (size_t i = 0; i < key.size(); ++i)
+    std::array<unsigned char, Algorithm::block_size> block{};
+    if (key.size() > block.size())
     {
-        block[i] ^= key[i];
+        Hashing key_hashing{};
+        key_hashing.append(key);
+        const auto key_hash = key_hashing.close();
+        std::copy(key_hash.begin(), key_hash.end(), block.begin());
     }
-    block.insert(block.cend(), input.begin(), input.end());
-    const auto round1_hash = hash_func(block);
-    block.resize(64 + round1_hash.size());
-    for (size_t i = 0; i < 64; ++i)
+    else
     {
-        block[i] = 0x5c;
+        std::copy(key.begin(), key.end(), block.begin());
     }
-    for (size_t i = 0; i < key.size(); ++i)
+    for (auto &byte: block)
     {
-        block[i] ^= key[i];
+        byte ^= 0x36;
     }
-    for (size_t i = 0; i < round1_hash.size(); ++i)
+    Hashing hashing{};
+    hashing.append(block);
+    inner_midstate = hashing.get_midstate();
+    for (auto &byte: block)
     {
-        block[i + 64] = round1_hash[i];
+        byte ^= 0x36 ^ 0x5c;
     }
-    return hash_func(block);
+    hashing = Hashing{};
+    hashing.append(block);
+    outer_midstate = hashing.get_midstate();
+    inner = Hashing(inner_midstate);
+}
+
+template<typename Algorithm>
+void Hmac<Algorithm>::update(std::span<const unsigned char> input)
+{
+    inner.append(input);
 }
 
+template<typename Algorithm>
+typename Hmac<Algorithm>::Digest Hmac<Algorithm>::final()
+{
+    const auto inner_hash = inner.close();
+    Hashing outer(outer_midstate);
+    outer.append(inner_hash);
+    inner = Hashing(inner_midstate);
+    return outer.close();
+}
+
+template class Hmac<Md5>;
+template class Hmac<Sha1>;
+template class Hmac<Sha256>;
+
 std::array<unsigned char, 32> hmac_sha256(
         const std::vector<unsigned char> &input,
         const std::vector<unsigned char> &key)
 {
-    return hmac<32>(input, key, &sha256_hash);
+    HmacSha256 hmac(key);
+    hmac.update(input);
+    return hmac.final();
 }
 
 std::array<unsigned char, 20> hmac_sha1(
         const std::vector<unsigned char> &input,
         const std::vector<unsigned char> &key)
 {
-    return hmac<20>(input, key, [](const auto &input)
-    {
-        Sha1Hashing hashing{};
-        hashing.append(input);
-        return hashing.close();
-    });
+    HmacSha1 hmac(key);
+    hmac.update(input);
+    return hmac.final();
 }
 
 std::array<unsigned char, 16> hmac_md5(
         const std::vector<unsigned char> &input,
         const std::vector<unsigned char> &key)
 {
-    return hmac<16>(input, key, &md5_hash);
-}
\ No newline at end of file
+    HmacMd5 hmac(key);
+    hmac.update(input);
+    return hmac.final();
+}
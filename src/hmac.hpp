@@ -2,8 +2,48 @@
 #define TLS_PLAYGROUND_HMAC_HPP
 
 #include <array>
+#include <span>
 #include <vector>
 
+#include "block_hashing.hpp"
+#include "md5.hpp"
+#include "sha.hpp"
+
+/**
+ * HMAC with a fixed key. The key blocks are hashed once at construction and kept as inner and outer midstates,
+ * so every message costs only its own blocks plus one outer block and never allocates.
+ */
+template<typename Algorithm>
+class Hmac
+{
+public:
+    using Hashing = BlockHashing<Algorithm>;
+    using Digest = std::array<unsigned char, Algorithm::digest_size>;
+
+private:
+    typename Hashing::Midstate inner_midstate{};
+    typename Hashing::Midstate outer_midstate{};
+    Hashing inner;
+public:
+    explicit Hmac(std::span<const unsigned char> key);
+
+    void update(std::span<const unsigned char> input);
+
+    /**
+     * Finishes the current message and starts the next one with the same key.
+     */
+    [[nodiscard]]
+    Digest final();
+};
+
+extern template class Hmac<Md5>;
+extern template class Hmac<Sha1>;
+extern template class Hmac<Sha256>;
+
+using HmacMd5 = Hmac<Md5>;
+using HmacSha1 = Hmac<Sha1>;
+using HmacSha256 = Hmac<Sha256>;
+
 [[nodiscard]]
 std::array<unsigned char, 32> hmac_sha256(
         const std::vector<unsigned char> &input,
@@ -393,15 +393,21 @@ BigNumber BigNumber::power_modulus(const BigNumber &exp, const BigNumber &modulu
     }
     BigNumber result({ 1 });
     BigNumber multiplier = *this;
-    BigNumber mask({ 1 });
-    while (mask < exp)
+    // walk exponent bits directly, least significant first
+    for (auto byte = exp.magnitude.rbegin(); byte != exp.magnitude.rend(); ++byte)
     {
-        if ((mask & exp) != ZERO)
+        for (unsigned char mask = 0x01; mask != 0; mask <<= 1)
         {
-            result = result * multiplier % modulus;
+            if ((*byte & mask) != 0)
+            {
+                result = result * multiplier % modulus;
+            }
+            if (mask == 0x80 && byte + 1 == exp.magnitude.rend())
+            {
+                break;
+            }
+            multiplier = multiplier * multiplier % modulus;
         }
-        mask <<= 1;
-        multiplier = multiplier * multiplier % modulus;
     }
     return result;
 }
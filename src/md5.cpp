@@ -1,140 +1,99 @@
 #include <algorithm>
 #include <array>
-#include <cmath>
+#include <bit>
 #include <cstdint>
+#include <utility>
+
+#include "block_hashing.hpp"
+#include "cpu_features.hpp"
+#include "md5_multi_buffer.hpp"
 
 #include "md5.hpp"
 
-uint_fast32_t F(uint_fast32_t x, uint_fast32_t y, uint_fast32_t z)
+namespace md5
 {
-    return (x & y) | (~x & z);
-}
 
-uint_fast32_t G(uint_fast32_t x, uint_fast32_t y, uint_fast32_t z)
-{
-    return (x & z) | (y & ~z);
-}
-
-uint_fast32_t H(uint_fast32_t x, uint_fast32_t y, uint_fast32_t z)
-{
-    return (x ^ y ^ z);
-}
+    const std::array<uint32_t, 64> round_constants{
+            0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee,
+            0xf57c0faf, 0x4787c62a, 0xa8304613, 0xfd469501,
+            0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be,
+            0x6b901122, 0xfd987193, 0xa679438e, 0x49b40821,
+            0xf61e2562, 0xc040b340, 0x265e5a51, 0xe9b6c7aa,
+            0xd62f105d, 0x02441453, 0xd8a1e681, 0xe7d3fbc8,
+            0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed,
+            0xa9e3e905, 0xfcefa3f8, 0x676f02d9, 0x8d2a4c8a,
+            0xfffa3942, 0x8771f681, 0x6d9d6122, 0xfde5380c,
+            0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70,
+            0x289b7ec6, 0xeaa127fa, 0xd4ef3085, 0x04881d05,
+            0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665,
+            0xf4292244, 0x432aff97, 0xab9423a7, 0xfc93a039,
+            0x655b59c3, 0x8f0ccc92, 0xffeff47d, 0x85845dd1,
+            0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1,
+            0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391
+    };
 
-uint_fast32_t I(uint_fast32_t x, uint_fast32_t y, uint_fast32_t z)
-{
-    return y ^ (x | ~z);
-}
+    const std::array<uint32_t, 4> initial_hash{
+            0x67452301,
+            0xefcdab89,
+            0x98badcfe,
+            0x10325476
+    };
 
-void md5_block_hash(const std::array<unsigned char, 64> &input, std::array<uint_fast32_t, 4> &hash)
-{
-    uint_fast32_t a, b, c, d;
-    int j;
-    std::array<uint_fast32_t, 16> x{};
-    a = hash[0];
-    b = hash[1];
-    c = hash[2];
-    d = hash[3];
-    for (j = 0; j < 16; j++)
+    /**
+     * Step t of the fully unrolled compression. Working variables rotate through the array instead of being
+     * moved and message words are read straight from the block, everything indexed by t is resolved at compile
+     * time.
+     */
+    template<size_t t>
+    inline void step(std::array<uint32_t, 4> &v, const unsigned char *block)
     {
-        x[j] = input[(j * 4) + 3] << 24 |
-               input[(j * 4) + 2] << 16 |
-               input[(j * 4) + 1] << 8 |
-               input[(j * 4)];
+        constexpr size_t offset = (4 - t % 4) % 4;
+        auto &a = v[offset];
+        const auto b = v[(offset + 1) % 4];
+        const auto c = v[(offset + 2) % 4];
+        const auto d = v[(offset + 3) % 4];
+        uint32_t f;
+        if constexpr (t < 16)
+        {
+            f = d ^ (b & (c ^ d));
+        }
+        else if constexpr (t < 32)
+        {
+            // the two halves never overlap, so c & ~d can be added before b is known
+            f = (b & d) + (c & ~d);
+        }
+        else if constexpr (t < 48)
+        {
+            f = b ^ c ^ d;
+        }
+        else
+        {
+            f = c ^ (b | ~d);
+        }
+        const auto word = load_word32<std::endian::little>(block + 4 * md5_message_index(t));
+        a = b + std::rotl(a + f + round_constants[t] + word, md5_shift(t));
     }
-    const auto round = [&](auto F, auto &a, auto b, auto c, auto d, auto k, auto s, auto i)
-    {
-        a = (a + F(b, c, d) + x[k] + (uint_fast32_t)(4294967296 * fabs(sin((double)i))));
-        a &= 0xffffffff;
-        a = (a << s) | (a >> (32 - s));
-        a &= 0xffffffff;
-        a += b;
-        a &= 0xffffffff;
-    };
-    // Round 1
-    round(F, a, b, c, d, 0, 7, 1);
-    round(F, d, a, b, c, 1, 12, 2);
-    round(F, c, d, a, b, 2, 17, 3);
-    round(F, b, c, d, a, 3, 22, 4);
-    round(F, a, b, c, d, 4, 7, 5);
-    round(F, d, a, b, c, 5, 12, 6);
-    round(F, c, d, a, b, 6, 17, 7);
-    round(F, b, c, d, a, 7, 22, 8);
-    round(F, a, b, c, d, 8, 7, 9);
-    round(F, d, a, b, c, 9, 12, 10);
-    round(F, c, d, a, b, 10, 17, 11);
-    round(F, b, c, d, a, 11, 22, 12);
-    round(F, a, b, c, d, 12, 7, 13);
-    round(F, d, a, b, c, 13, 12, 14);
-    round(F, c, d, a, b, 14, 17, 15);
-    round(F, b, c, d, a, 15, 22, 16);
 
-    // Round 2
-    round(G, a, b, c, d, 1, 5, 17);
-    round(G, d, a, b, c, 6, 9, 18);
-    round(G, c, d, a, b, 11, 14, 19);
-    round(G, b, c, d, a, 0, 20, 20);
-    round(G, a, b, c, d, 5, 5, 21);
-    round(G, d, a, b, c, 10, 9, 22);
-    round(G, c, d, a, b, 15, 14, 23);
-    round(G, b, c, d, a, 4, 20, 24);
-    round(G, a, b, c, d, 9, 5, 25);
-    round(G, d, a, b, c, 14, 9, 26);
-    round(G, c, d, a, b, 3, 14, 27);
-    round(G, b, c, d, a, 8, 20, 28);
-    round(G, a, b, c, d, 13, 5, 29);
-    round(G, d, a, b, c, 2, 9, 30);
-    round(G, c, d, a, b, 7, 14, 31);
-    round(G, b, c, d, a, 12, 20, 32);
-
-    // Round 3
-    round(H, a, b, c, d, 5, 4, 33);
-    round(H, d, a, b, c, 8, 11, 34);
-    round(H, c, d, a, b, 11, 16, 35);
-    round(H, b, c, d, a, 14, 23, 36);
-    round(H, a, b, c, d, 1, 4, 37);
-    round(H, d, a, b, c, 4, 11, 38);
-    round(H, c, d, a, b, 7, 16, 39);
-    round(H, b, c, d, a, 10, 23, 40);
-    round(H, a, b, c, d, 13, 4, 41);
-    round(H, d, a, b, c, 0, 11, 42);
-    round(H, c, d, a, b, 3, 16, 43);
-    round(H, b, c, d, a, 6, 23, 44);
-    round(H, a, b, c, d, 9, 4, 45);
-    round(H, d, a, b, c, 12, 11, 46);
-    round(H, c, d, a, b, 15, 16, 47);
-    round(H, b, c, d, a, 2, 23, 48);
-
-    // Round 4
-    round(I, a, b, c, d, 0, 6, 49);
-    round(I, d, a, b, c, 7, 10, 50);
-    round(I, c, d, a, b, 14, 15, 51);
-    round(I, b, c, d, a, 5, 21, 52);
-    round(I, a, b, c, d, 12, 6, 53);
-    round(I, d, a, b, c, 3, 10, 54);
-    round(I, c, d, a, b, 10, 15, 55);
-    round(I, b, c, d, a, 1, 21, 56);
-    round(I, a, b, c, d, 8, 6, 57);
-    round(I, d, a, b, c, 15, 10, 58);
-    round(I, c, d, a, b, 6, 15, 59);
-    round(I, b, c, d, a, 13, 21, 60);
-    round(I, a, b, c, d, 4, 6, 61);
-    round(I, d, a, b, c, 11, 10, 62);
-    round(I, c, d, a, b, 2, 15, 63);
-    round(I, b, c, d, a, 9, 21, 64);
+    template<size_t... steps>
+    inline void all_steps(std::array<uint32_t, 4> &v, const unsigned char *block, std::index_sequence<steps...>)
+    {
+        (step<steps>(v, block), ...);
+    }
 
-    hash[0] += a;
-    hash[1] += b;
-    hash[2] += c;
-    hash[3] += d;
+    void compress(std::array<uint32_t, 4> &state, const unsigned char *blocks, size_t count)
+    {
+        for (size_t block = 0; block < count; ++block)
+        {
+            auto v = state;
+            all_steps(v, blocks + 64 * block, std::make_index_sequence<64>());
+            for (size_t i = 0; i < state.size(); ++i)
+            {
+                state[i] += v[i];
+            }
+        }
+    }
 }
 
-const auto initial_hash = std::array<uint_fast32_t, 4>{
-        0x67452301,
-        0xefcdab89,
-        0x98badcfe,
-        0x10325476
-};
-
 std::array<unsigned char, 16> md5_hash(const std::vector<unsigned char> &input)
 {
     Md5Hashing hashing{};
@@ -142,83 +101,41 @@ std::array<unsigned char, 16> md5_hash(const std::vector<unsigned char> &input)
     return hashing.close();
 }
 
-Md5Hashing::Md5Hashing() : state(initial_hash)
+std::vector<std::array<unsigned char, 16>> md5_hash_many(std::span<const std::span<const unsigned char>> messages)
 {
-
-}
-
-void Md5Hashing::append(const std::vector<unsigned char> &input)
-{
-    auto remains = input.size();
-    auto input_iter = input.begin();
-    while (remains > 0)
+    std::vector<std::array<unsigned char, 16>> result(messages.size());
+    if (TLS_PLAYGROUND_X86 && cpu_features().avx512)
     {
-        auto copy = std::min(block_buffer.size() - buffer_pos, remains);
-        std::copy_n(input_iter, copy, block_buffer.begin() + buffer_pos);
-        buffer_pos += copy;
-        remains -= copy;
-        input_iter += copy;
-        if (buffer_pos == block_buffer.size())
-        {
-            md5_block_hash(block_buffer, state);
-            buffer_pos = 0;
-        }
+        hash_lanes<16, std::endian::little>(messages, result, md5::initial_hash, md5::round_constants.data(),
+                &md5_compress_x16_avx512);
     }
-    input_size += input.size();
-}
-
-std::array<unsigned char, 16> Md5Hashing::close()
-{
-    if (buffer_pos <= block_buffer.size() - 9)
+    else if (TLS_PLAYGROUND_X86 && cpu_features().avx2)
     {
-        std::fill(block_buffer.begin() + buffer_pos, block_buffer.end() - 8, 0);
-        block_buffer[buffer_pos] = 0x80;
-        block_buffer[block_buffer.size() - 1] = (input_size * 8 & 0xFF00000000000000) >> 56;
-        block_buffer[block_buffer.size() - 2] = (input_size * 8 & 0x00FF000000000000) >> 48;
-        block_buffer[block_buffer.size() - 3] = (input_size * 8 & 0x0000FF0000000000) >> 40;
-        block_buffer[block_buffer.size() - 4] = (input_size * 8 & 0x000000FF00000000) >> 32;
-        block_buffer[block_buffer.size() - 5] = (input_size * 8 & 0xFF000000) >> 24;
-        block_buffer[block_buffer.size() - 6] = (input_size * 8 & 0x00FF0000) >> 16;
-        block_buffer[block_buffer.size() - 7] = (input_size * 8 & 0x0000FF00) >> 8;
-        block_buffer[block_buffer.size() - 8] = (input_size * 8 & 0x000000FF);
-        md5_block_hash(block_buffer, state);
+        hash_lanes<8, std::endian::little>(messages, result, md5::initial_hash, md5::round_constants.data(),
+                &md5_compress_x8_avx2);
+    }
+    else if (TLS_PLAYGROUND_X86)
+    {
+        hash_lanes<4, std::endian::little>(messages, result, md5::initial_hash, md5::round_constants.data(),
+                &md5_compress_x4_sse2);
     }
     else
     {
-        std::fill(block_buffer.begin() + buffer_pos, block_buffer.end(), 0);
-        block_buffer[buffer_pos] = 0x80;
-        md5_block_hash(block_buffer, state);
-        std::fill(block_buffer.begin(), block_buffer.end() - 8, 0);
-        block_buffer[block_buffer.size() - 1] = (input_size * 8 & 0xFF00000000000000) >> 56;
-        block_buffer[block_buffer.size() - 2] = (input_size * 8 & 0x00FF000000000000) >> 48;
-        block_buffer[block_buffer.size() - 3] = (input_size * 8 & 0x0000FF0000000000) >> 40;
-        block_buffer[block_buffer.size() - 4] = (input_size * 8 & 0x000000FF00000000) >> 32;
-        block_buffer[block_buffer.size() - 5] = (input_size * 8 & 0xFF000000) >> 24;
-        block_buffer[block_buffer.size() - 6] = (input_size * 8 & 0x00FF0000) >> 16;
-        block_buffer[block_buffer.size() - 7] = (input_size * 8 & 0x0000FF00) >> 8;
-        block_buffer[block_buffer.size() - 8] = (input_size * 8 & 0x000000FF);
-        md5_block_hash(block_buffer, state);
+        std::ranges::transform(messages, result.begin(), [](const auto message)
+        {
+            Md5Hashing hashing{};
+            hashing.append(message);
+            return hashing.close();
+        });
     }
-    std::array<unsigned char, 16> result{
-            static_cast<unsigned char>(state[0] & 0xFF),
-            static_cast<unsigned char>((state[0] & 0xFF00) >> 8),
-            static_cast<unsigned char>((state[0] & 0xFF0000) >> 16),
-            static_cast<unsigned char>((state[0] & 0xFF000000) >> 24),
-            static_cast<unsigned char>(state[1] & 0xFF),
-            static_cast<unsigned char>((state[1] & 0xFF00) >> 8),
-            static_cast<unsigned char>((state[1] & 0xFF0000) >> 16),
-            static_cast<unsigned char>((state[1] & 0xFF000000) >> 24),
-            static_cast<unsigned char>(state[2] & 0xFF),
-            static_cast<unsigned char>((state[2] & 0xFF00) >> 8),
-            static_cast<unsigned char>((state[2] & 0xFF0000) >> 16),
-            static_cast<unsigned char>((state[2] & 0xFF000000) >> 24),
-            static_cast<unsigned char>(state[3] & 0xFF),
-            static_cast<unsigned char>((state[3] & 0xFF00) >> 8),
-            static_cast<unsigned char>((state[3] & 0xFF0000) >> 16),
-            static_cast<unsigned char>((state[3] & 0xFF000000) >> 24)
-    };
-    input_size = 0;
-    buffer_pos = 0;
-    state = initial_hash;
     return result;
 }
+
+const std::array<uint32_t, 4> Md5::initial_hash = md5::initial_hash;
+
+void Md5::compress(std::array<uint32_t, 4> &state, const unsigned char *blocks, size_t count)
+{
+    md5::compress(state, blocks, count);
+}
+
+template class BlockHashing<Md5>;
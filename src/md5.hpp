@@ -2,26 +2,38 @@
 #ifndef TLS_PLAYGROUND_MD5_HPP
 #define TLS_PLAYGROUND_MD5_HPP
 
+#include <array>
+#include <bit>
 #include <cstddef>
 #include <cstdint>
-#include <array>
+#include <span>
 #include <vector>
 
-std::array<unsigned char, 16> md5_hash(const std::vector<unsigned char> &input);
+#include "block_hashing.hpp"
 
-class Md5Hashing
-{
-    std::array<uint_fast32_t, 4> state;
-    std::array<unsigned char, 64> block_buffer{};
-    size_t buffer_pos{};
-    size_t input_size{};
-public:
-    Md5Hashing();
+std::array<unsigned char, 16> md5_hash(const std::vector<unsigned char> &input);
 
-    void append(const std::vector<unsigned char> &input);
+/**
+ * Hashes independent messages in SIMD lanes, 16 with AVX-512, 8 with AVX2 and 4 with SSE2. Lanes take the next
+ * message as soon as their current one is finished, so lengths may differ freely.
+ * @return digests in the order of messages
+ */
+std::vector<std::array<unsigned char, 16>> md5_hash_many(std::span<const std::span<const unsigned char>> messages);
 
-    std::array<unsigned char, 16> close();
+struct Md5
+{
+    using Word = uint32_t;
+    static constexpr std::endian byte_order = std::endian::little;
+    static constexpr size_t state_words = 4;
+    static constexpr size_t block_size = 64;
+    static constexpr size_t digest_size = 16;
+    static const std::array<Word, state_words> initial_hash;
+
+    static void compress(std::array<Word, state_words> &state, const unsigned char *blocks, size_t count);
 };
 
+extern template class BlockHashing<Md5>;
+
+using Md5Hashing = BlockHashing<Md5>;
 
 #endif //TLS_PLAYGROUND_MD5_HPP
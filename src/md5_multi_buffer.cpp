@@ -0,0 +1,180 @@
+#include <stdexcept>
+#include <utility>
+
+#include "cpu_features.hpp"
+
+#include "md5_multi_buffer.hpp"
+
+#if TLS_PLAYGROUND_X86
+
+#include <immintrin.h>
+
+/**
+ * Step t of every lane. Working variables rotate through v like in the portable compression, F and G are
+ * written in their two operation forms d ^ (b & (c ^ d)) and c ^ (d & (b ^ c)).
+ */
+template<size_t t>
+TLS_PLAYGROUND_TARGET("sse2")
+inline void md5_step_sse2(__m128i (&v)[4], const __m128i *w, const uint32_t *round_constants)
+{
+    constexpr size_t offset = (4 - t % 4) % 4;
+    auto &a = v[offset];
+    const auto b = v[(offset + 1) % 4];
+    const auto c = v[(offset + 2) % 4];
+    const auto d = v[(offset + 3) % 4];
+    __m128i f;
+    if constexpr (t < 16)
+    {
+        f = _mm_xor_si128(d, _mm_and_si128(b, _mm_xor_si128(c, d)));
+    }
+    else if constexpr (t < 32)
+    {
+        f = _mm_xor_si128(c, _mm_and_si128(d, _mm_xor_si128(b, c)));
+    }
+    else if constexpr (t < 48)
+    {
+        f = _mm_xor_si128(_mm_xor_si128(b, c), d);
+    }
+    else
+    {
+        f = _mm_xor_si128(c, _mm_or_si128(b, _mm_xor_si128(d, _mm_set1_epi32(-1))));
+    }
+    const auto sum = _mm_add_epi32(_mm_add_epi32(a, f), _mm_add_epi32(w[md5_message_index(t)],
+            _mm_set1_epi32(static_cast<int>(round_constants[t]))));
+    constexpr int shift = md5_shift(t);
+    a = _mm_add_epi32(b, _mm_or_si128(_mm_slli_epi32(sum, shift), _mm_srli_epi32(sum, 32 - shift)));
+}
+
+template<size_t... steps>
+TLS_PLAYGROUND_TARGET("sse2")
+inline void md5_steps_sse2(__m128i (&v)[4], const __m128i *w, const uint32_t *round_constants,
+        std::index_sequence<steps...>)
+{
+    (md5_step_sse2<steps>(v, w, round_constants), ...);
+}
+
+TLS_PLAYGROUND_TARGET("sse2")
+void md5_compress_x4_sse2(uint32_t *state, const uint32_t *words, const uint32_t *round_constants)
+{
+    const auto *w = reinterpret_cast<const __m128i *>(words);
+    auto *s = reinterpret_cast<__m128i *>(state);
+    __m128i v[4]{ _mm_load_si128(s), _mm_load_si128(s + 1), _mm_load_si128(s + 2), _mm_load_si128(s + 3) };
+    md5_steps_sse2(v, w, round_constants, std::make_index_sequence<64>());
+    for (size_t i = 0; i < 4; ++i)
+    {
+        _mm_store_si128(s + i, _mm_add_epi32(_mm_load_si128(s + i), v[i]));
+    }
+}
+
+template<size_t t>
+TLS_PLAYGROUND_TARGET("avx2")
+inline void md5_step_avx2(__m256i (&v)[4], const __m256i *w, const uint32_t *round_constants)
+{
+    constexpr size_t offset = (4 - t % 4) % 4;
+    auto &a = v[offset];
+    const auto b = v[(offset + 1) % 4];
+    const auto c = v[(offset + 2) % 4];
+    const auto d = v[(offset + 3) % 4];
+    __m256i f;
+    if constexpr (t < 16)
+    {
+        f = _mm256_xor_si256(d, _mm256_and_si256(b, _mm256_xor_si256(c, d)));
+    }
+    else if constexpr (t < 32)
+    {
+        f = _mm256_xor_si256(c, _mm256_and_si256(d, _mm256_xor_si256(b, c)));
+    }
+    else if constexpr (t < 48)
+    {
+        f = _mm256_xor_si256(_mm256_xor_si256(b, c), d);
+    }
+    else
+    {
+        f = _mm256_xor_si256(c, _mm256_or_si256(b, _mm256_xor_si256(d, _mm256_set1_epi32(-1))));
+    }
+    const auto sum = _mm256_add_epi32(_mm256_add_epi32(a, f), _mm256_add_epi32(w[md5_message_index(t)],
+            _mm256_set1_epi32(static_cast<int>(round_constants[t]))));
+    constexpr int shift = md5_shift(t);
+    a = _mm256_add_epi32(b, _mm256_or_si256(_mm256_slli_epi32(sum, shift), _mm256_srli_epi32(sum, 32 - shift)));
+}
+
+template<size_t... steps>
+TLS_PLAYGROUND_TARGET("avx2")
+inline void md5_steps_avx2(__m256i (&v)[4], const __m256i *w, const uint32_t *round_constants,
+        std::index_sequence<steps...>)
+{
+    (md5_step_avx2<steps>(v, w, round_constants), ...);
+}
+
+TLS_PLAYGROUND_TARGET("avx2")
+void md5_compress_x8_avx2(uint32_t *state, const uint32_t *words, const uint32_t *round_constants)
+{
+    const auto *w = reinterpret_cast<const __m256i *>(words);
+    auto *s = reinterpret_cast<__m256i *>(state);
+    __m256i v[4]{ _mm256_load_si256(s), _mm256_load_si256(s + 1), _mm256_load_si256(s + 2),
+                  _mm256_load_si256(s + 3) };
+    md5_steps_avx2(v, w, round_constants, std::make_index_sequence<64>());
+    for (size_t i = 0; i < 4; ++i)
+    {
+        _mm256_store_si256(s + i, _mm256_add_epi32(_mm256_load_si256(s + i), v[i]));
+    }
+}
+
+/**
+ * Round functions as three input truth tables of (b, c, d): F 0xCA, G 0xE4, H 0x96 and I 0x39. The zero masking
+ * rotation avoids GCC 12 warning about the undefined pass-through operand of the plain intrinsic.
+ */
+template<size_t t>
+TLS_PLAYGROUND_TARGET("avx512f")
+inline void md5_step_avx512(__m512i (&v)[4], const __m512i *w, const uint32_t *round_constants)
+{
+    constexpr size_t offset = (4 - t % 4) % 4;
+    constexpr int truth_tables[4]{ 0xCA, 0xE4, 0x96, 0x39 };
+    auto &a = v[offset];
+    const auto b = v[(offset + 1) % 4];
+    const auto f = _mm512_ternarylogic_epi32(b, v[(offset + 2) % 4], v[(offset + 3) % 4], truth_tables[t / 16]);
+    const auto sum = _mm512_add_epi32(_mm512_add_epi32(a, f), _mm512_add_epi32(w[md5_message_index(t)],
+            _mm512_set1_epi32(static_cast<int>(round_constants[t]))));
+    a = _mm512_add_epi32(b, _mm512_maskz_rol_epi32(0xFFFF, sum, md5_shift(t)));
+}
+
+template<size_t... steps>
+TLS_PLAYGROUND_TARGET("avx512f")
+inline void md5_steps_avx512(__m512i (&v)[4], const __m512i *w, const uint32_t *round_constants,
+        std::index_sequence<steps...>)
+{
+    (md5_step_avx512<steps>(v, w, round_constants), ...);
+}
+
+TLS_PLAYGROUND_TARGET("avx512f")
+void md5_compress_x16_avx512(uint32_t *state, const uint32_t *words, const uint32_t *round_constants)
+{
+    const auto *w = reinterpret_cast<const __m512i *>(words);
+    auto *s = reinterpret_cast<__m512i *>(state);
+    __m512i v[4]{ _mm512_load_si512(s), _mm512_load_si512(s + 1), _mm512_load_si512(s + 2),
+                  _mm512_load_si512(s + 3) };
+    md5_steps_avx512(v, w, round_constants, std::make_index_sequence<64>());
+    for (size_t i = 0; i < 4; ++i)
+    {
+        _mm512_store_si512(s + i, _mm512_add_epi32(_mm512_load_si512(s + i), v[i]));
+    }
+}
+
+#else
+
+void md5_compress_x4_sse2(uint32_t *, const uint32_t *, const uint32_t *)
+{
+    throw std::runtime_error("sse2 is not supported");
+}
+
+void md5_compress_x8_avx2(uint32_t *, const uint32_t *, const uint32_t *)
+{
+    throw std::runtime_error("avx2 is not supported");
+}
+
+void md5_compress_x16_avx512(uint32_t *, const uint32_t *, const uint32_t *)
+{
+    throw std::runtime_error("avx-512 is not supported");
+}
+
+#endif
@@ -0,0 +1,51 @@
+#ifndef TLS_PLAYGROUND_MD5_MULTI_BUFFER_HPP
+#define TLS_PLAYGROUND_MD5_MULTI_BUFFER_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Message word used by MD5 step t, every round of 16 steps walks the block in its own order.
+ */
+constexpr size_t md5_message_index(size_t t)
+{
+    switch (t / 16)
+    {
+    case 0:
+        return t;
+    case 1:
+        return (5 * t + 1) % 16;
+    case 2:
+        return (3 * t + 5) % 16;
+    default:
+        return (7 * t) % 16;
+    }
+}
+
+/**
+ * Left rotation of MD5 step t.
+ */
+constexpr int md5_shift(size_t t)
+{
+    constexpr int shifts[4][4]{
+            { 7, 12, 17, 22 },
+            { 5, 9, 14, 20 },
+            { 4, 11, 16, 23 },
+            { 6, 10, 15, 21 }
+    };
+    return shifts[t / 16][t % 4];
+}
+
+/**
+ * Multi-buffer MD5 compression: one block of every lane per call. State and message words are transposed,
+ * word i of lane l is at [i * lanes + l], and both arrays must be aligned to the vector size.
+ * Callers must check cpu_features(), on other architectures every function throws.
+ */
+
+void md5_compress_x4_sse2(uint32_t *state, const uint32_t *words, const uint32_t *round_constants);
+
+void md5_compress_x8_avx2(uint32_t *state, const uint32_t *words, const uint32_t *round_constants);
+
+void md5_compress_x16_avx512(uint32_t *state, const uint32_t *words, const uint32_t *round_constants);
+
+#endif //TLS_PLAYGROUND_MD5_MULTI_BUFFER_HPP
@@ -0,0 +1,255 @@
+#include <algorithm>
+#include <stdexcept>
+
+#include "montgomery.hpp"
+
+Limbs to_limbs(const BigNumber &value, size_t size)
+{
+    const auto bytes = value.data();
+    if (bytes.size() > size * 4)
+    {
+        throw std::runtime_error("value doesn't fit montgomery context");
+    }
+    Limbs result(size, 0);
+    for (size_t i = 0; i < bytes.size(); ++i)
+    {
+        result[i / 4] |= static_cast<uint32_t>(bytes[bytes.size() - 1 - i]) << (8 * (i % 4));
+    }
+    return result;
+}
+
+BigNumber from_limbs(const Limbs &value)
+{
+    std::vector<unsigned char> bytes(value.size() * 4);
+    for (size_t i = 0; i < bytes.size(); ++i)
+    {
+        bytes[bytes.size() - 1 - i] = (value[i / 4] >> (8 * (i % 4))) & 0xFF;
+    }
+    return BigNumber(std::move(bytes));
+}
+
+/**
+ * Replace value with value - modulus when (top, value) >= modulus. Branch free, so timing doesn't leak the result.
+ */
+void subtract_if_not_less(uint32_t *value, uint32_t top, const uint32_t *modulus, uint32_t *difference, size_t size)
+{
+    uint64_t borrow = 0;
+    for (size_t i = 0; i < size; ++i)
+    {
+        const uint64_t result = static_cast<uint64_t>(value[i]) - modulus[i] - borrow;
+        difference[i] = static_cast<uint32_t>(result);
+        borrow = (result >> 32) & 1;
+    }
+    const uint32_t keep_mask = 0u - static_cast<uint32_t>(borrow & ~top & 1);
+    for (size_t i = 0; i < size; ++i)
+    {
+        value[i] = (value[i] & keep_mask) | (difference[i] & ~keep_mask);
+    }
+}
+
+MontgomeryContext::MontgomeryContext(const BigNumber &modulus) : modulus(modulus)
+{
+    const auto bytes = modulus.data();
+    if (modulus.get_sign() == Sign::MINUS || bytes.empty() || (bytes.back() & 1) == 0)
+    {
+        throw std::runtime_error("montgomery modulus must be positive odd number");
+    }
+    modulus_limbs = to_limbs(modulus, (bytes.size() + 3) / 4);
+
+    // Newton iteration, each step doubles number of correct low bits: 3 -> 6 -> 12 -> 24 -> 48
+    uint32_t inverse = modulus_limbs[0];
+    for (int i = 0; i < 4; ++i)
+    {
+        inverse *= 2 - modulus_limbs[0] * inverse;
+    }
+    modulus_inverse = 0u - inverse;
+
+    // R^2 mod modulus by doubling 1 for 2 * 32 * size times
+    const auto size = modulus_limbs.size();
+    r_squared = Limbs(size, 0);
+    r_squared[0] = 1;
+    Limbs difference(size);
+    for (size_t i = 0; i < 64 * size; ++i)
+    {
+        uint32_t carry = 0;
+        for (auto &limb: r_squared)
+        {
+            const auto next_carry = limb >> 31;
+            limb = limb << 1 | carry;
+            carry = next_carry;
+        }
+        subtract_if_not_less(r_squared.data(), carry, modulus_limbs.data(), difference.data(), size);
+    }
+}
+
+size_t MontgomeryContext::size() const
+{
+    return modulus_limbs.size();
+}
+
+void MontgomeryContext::multiply(const uint32_t *first, const uint32_t *second, uint32_t *result,
+        uint32_t *scratch) const
+{
+    // CIOS: interleave multiplication and reduction, scratch holds size + 2 limbs
+    const auto size = modulus_limbs.size();
+    const auto *mod = modulus_limbs.data();
+    std::fill_n(scratch, size + 2, 0);
+    for (size_t i = 0; i < size; ++i)
+    {
+        uint64_t carry = 0;
+        for (size_t j = 0; j < size; ++j)
+        {
+            const uint64_t sum = scratch[j] + static_cast<uint64_t>(first[j]) * second[i] + carry;
+            scratch[j] = static_cast<uint32_t>(sum);
+            carry = sum >> 32;
+        }
+        uint64_t sum = scratch[size] + carry;
+        scratch[size] = static_cast<uint32_t>(sum);
+        scratch[size + 1] = static_cast<uint32_t>(sum >> 32);
+
+        const uint32_t m = scratch[0] * modulus_inverse;
+        sum = scratch[0] + static_cast<uint64_t>(m) * mod[0];
+        carry = sum >> 32;
+        for (size_t j = 1; j < size; ++j)
+        {
+            sum = scratch[j] + static_cast<uint64_t>(m) * mod[j] + carry;
+            scratch[j - 1] = static_cast<uint32_t>(sum);
+            carry = sum >> 32;
+        }
+        sum = scratch[size] + carry;
+        scratch[size - 1] = static_cast<uint32_t>(sum);
+        scratch[size] = scratch[size + 1] + static_cast<uint32_t>(sum >> 32);
+    }
+    subtract_if_not_less(scratch, scratch[size], mod, result, size);
+    std::copy_n(scratch, size, result);
+}
+
+void MontgomeryContext::multiply(const Limbs &first, const Limbs &second, Limbs &result) const
+{
+    if (first.size() != size() || second.size() != size())
+    {
+        throw std::runtime_error("montgomery operand size mismatch");
+    }
+    Limbs scratch(size() + 2);
+    result.resize(size());
+    multiply(first.data(), second.data(), result.data(), scratch.data());
+}
+
+Limbs MontgomeryContext::to_montgomery(const BigNumber &value) const
+{
+    if (value.get_sign() == Sign::MINUS)
+    {
+        throw std::runtime_error("negative number is not supported");
+    }
+    auto result = to_limbs(value < modulus ? value : value % modulus, size());
+    multiply(result, r_squared, result);
+    return result;
+}
+
+BigNumber MontgomeryContext::from_montgomery(const Limbs &value) const
+{
+    Limbs one(size(), 0);
+    one[0] = 1;
+    Limbs result{};
+    multiply(value, one, result);
+    return from_limbs(result);
+}
+
+BigNumber MontgomeryContext::power_modulus(const BigNumber &base, const BigNumber &exp) const
+{
+    const auto multiplier = to_montgomery(base);
+    auto result = to_montgomery(BigNumber({ 1 }));
+    Limbs scratch(size() + 2);
+    for (const auto byte: exp.data())
+    {
+        for (unsigned char mask = 0x80; mask != 0; mask >>= 1)
+        {
+            multiply(result.data(), result.data(), result.data(), scratch.data());
+            if ((byte & mask) != 0)
+            {
+                multiply(result.data(), multiplier.data(), result.data(), scratch.data());
+            }
+        }
+    }
+    return from_montgomery(result);
+}
+
+BigNumber MontgomeryContext::power_modulus_short(const BigNumber &base, uint32_t exp) const
+{
+    const auto multiplier = to_montgomery(base);
+    Limbs scratch(size() + 2);
+    if (exp == 0x10001)
+    {
+        auto result = multiplier;
+        for (int i = 0; i < 16; ++i)
+        {
+            multiply(result.data(), result.data(), result.data(), scratch.data());
+        }
+        multiply(result.data(), multiplier.data(), result.data(), scratch.data());
+        return from_montgomery(result);
+    }
+    if (exp == 3)
+    {
+        Limbs result(size());
+        multiply(multiplier.data(), multiplier.data(), result.data(), scratch.data());
+        multiply(result.data(), multiplier.data(), result.data(), scratch.data());
+        return from_montgomery(result);
+    }
+    if (exp == 0)
+    {
+        return from_montgomery(to_montgomery(BigNumber({ 1 })));
+    }
+    auto result = multiplier;
+    uint32_t mask = 0x80000000;
+    while ((exp & mask) == 0)
+    {
+        mask >>= 1;
+    }
+    for (mask >>= 1; mask != 0; mask >>= 1)
+    {
+        multiply(result.data(), result.data(), result.data(), scratch.data());
+        if ((exp & mask) != 0)
+        {
+            multiply(result.data(), multiplier.data(), result.data(), scratch.data());
+        }
+    }
+    return from_montgomery(result);
+}
+
+void MontgomeryContext::power_modulus_fixed_window(const Limbs &base, const Limbs &exp, Limbs &result) const
+{
+    if (base.size() != size())
+    {
+        throw std::runtime_error("montgomery operand size mismatch");
+    }
+    const auto width = size();
+    Limbs scratch(width + 2);
+    Limbs table(16 * width);
+    Limbs selected(width);
+    auto one = to_montgomery(BigNumber({ 1 }));
+    std::copy(one.begin(), one.end(), table.begin());
+    std::copy(base.begin(), base.end(), table.begin() + width);
+    for (size_t i = 2; i < 16; ++i)
+    {
+        multiply(table.data() + (i - 1) * width, base.data(), table.data() + i * width, scratch.data());
+    }
+    result = one;
+    for (size_t window = exp.size() * 8; window-- > 0;)
+    {
+        for (int i = 0; i < 4; ++i)
+        {
+            multiply(result.data(), result.data(), result.data(), scratch.data());
+        }
+        const uint32_t index = (exp[window / 8] >> (4 * (window % 8))) & 0x0F;
+        std::fill(selected.begin(), selected.end(), 0);
+        for (uint32_t entry = 0; entry < 16; ++entry)
+        {
+            const uint32_t mask = 0u - (((entry ^ index) - 1) >> 31);
+            for (size_t j = 0; j < width; ++j)
+            {
+                selected[j] |= table[entry * width + j] & mask;
+            }
+        }
+        multiply(result.data(), selected.data(), result.data(), scratch.data());
+    }
+}
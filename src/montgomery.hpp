@@ -0,0 +1,71 @@
+#ifndef TLS_PLAYGROUND_MONTGOMERY_HPP
+#define TLS_PLAYGROUND_MONTGOMERY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "math.hpp"
+
+/**
+ * Little endian 32-bit words, always padded to the modulus width.
+ */
+using Limbs = std::vector<uint32_t>;
+
+[[nodiscard]]
+Limbs to_limbs(const BigNumber &value, size_t size);
+
+[[nodiscard]]
+BigNumber from_limbs(const Limbs &value);
+
+/**
+ * Precomputed state for Montgomery multiplication with a fixed odd modulus.
+ * Construction is relatively expensive, so contexts are meant to be built once per key and reused.
+ */
+class MontgomeryContext
+{
+    BigNumber modulus;
+    Limbs modulus_limbs;
+    Limbs r_squared;
+    uint32_t modulus_inverse;
+
+    void multiply(const uint32_t *first, const uint32_t *second, uint32_t *result, uint32_t *scratch) const;
+
+public:
+    explicit MontgomeryContext(const BigNumber &modulus);
+
+    /**
+     * @return number of limbs used by every value of this context
+     */
+    [[nodiscard]]
+    size_t size() const;
+
+    [[nodiscard]]
+    Limbs to_montgomery(const BigNumber &value) const;
+
+    [[nodiscard]]
+    BigNumber from_montgomery(const Limbs &value) const;
+
+    /**
+     * Montgomery product: first * second / R mod modulus. Result may alias inputs.
+     */
+    void multiply(const Limbs &first, const Limbs &second, Limbs &result) const;
+
+    [[nodiscard]]
+    BigNumber power_modulus(const BigNumber &base, const BigNumber &exp) const;
+
+    /**
+     * Exponentiation with short public exponent. 3 and 65537 use dedicated square chains.
+     */
+    [[nodiscard]]
+    BigNumber power_modulus_short(const BigNumber &base, uint32_t exp) const;
+
+    /**
+     * Exponentiation for secret exponents. Works on montgomery form values and fixed width exponent,
+     * uses 4-bit windows over the whole exponent width and scans the complete window table for every lookup,
+     * so neither branches nor memory access depend on exponent bits.
+     */
+    void power_modulus_fixed_window(const Limbs &base, const Limbs &exp, Limbs &result) const;
+};
+
+#endif //TLS_PLAYGROUND_MONTGOMERY_HPP
@@ -1,7 +1,12 @@
 #include <algorithm>
+#include <cstdint>
 #include <iterator>
+#include <random>
+#include <stdexcept>
+#include <variant>
 #include <vector>
 
+#include "asn1.hpp"
 #include "rsa.hpp"
 
 BigNumber rsa_compute(const BigNumber &message, const BigNumber &exp, const BigNumber &modulus)
@@ -9,11 +14,178 @@ BigNumber rsa_compute(const BigNumber &message, const BigNumber &exp, const BigN
     return message.power_modulus(exp, modulus);
 }
 
+RsaPublicKey::RsaPublicKey(const BigNumber &modulus, const BigNumber &exponent)
+        : modulus(modulus), exponent(exponent), montgomery(modulus)
+{
+    if (exponent.get_sign() == Sign::PLUS && exponent.bit_length() <= 32)
+    {
+        for (const auto item: exponent.data())
+        {
+            short_exponent = short_exponent << 8 | item;
+        }
+    }
+}
+
+RsaPublicKey RsaPublicKey::parse(const std::vector<unsigned char> &public_key)
+{
+    const auto key_asn = parse_asn1(public_key);
+    if (!std::holds_alternative<std::vector<Asn1>>(key_asn.data))
+    {
+        throw std::runtime_error("malformed rsa public key");
+    }
+    const auto &modulus_exp = std::get<std::vector<Asn1>>(key_asn.data);
+    if (modulus_exp.size() != 2
+        || !std::holds_alternative<BigNumber>(modulus_exp.at(0).data)
+        || !std::holds_alternative<BigNumber>(modulus_exp.at(1).data))
+    {
+        throw std::runtime_error("malformed rsa public key structure");
+    }
+    return { std::get<BigNumber>(modulus_exp[0].data), std::get<BigNumber>(modulus_exp[1].data) };
+}
+
+BigNumber RsaPublicKey::compute(const BigNumber &message) const
+{
+    if (short_exponent != 0)
+    {
+        return montgomery.power_modulus_short(message, short_exponent);
+    }
+    return montgomery.power_modulus(message, exponent);
+}
+
+const BigNumber &RsaPublicKey::get_modulus() const
+{
+    return modulus;
+}
+
+const BigNumber &RsaPublicKey::get_exponent() const
+{
+    return exponent;
+}
+
+size_t RsaPublicKeyCache::KeyHash::operator()(const std::vector<unsigned char> &key) const
+{
+    // FNV-1a
+    uint64_t hash = 0xcbf29ce484222325;
+    for (const auto item: key)
+    {
+        hash = (hash ^ item) * 0x100000001b3;
+    }
+    return hash;
+}
+
+RsaPrivateKey::RsaPrivateKey(const BigNumber &modulus,
+        const BigNumber &private_exponent,
+        const BigNumber &public_exponent)
+        : modulus(modulus),
+          montgomery(modulus),
+          private_exponent(to_limbs(private_exponent, montgomery.size())),
+          public_exponent(public_exponent)
+{
+    reset_blinding();
+}
+
+void RsaPrivateKey::reset_blinding() const
+{
+    std::random_device random_device{};
+    std::uniform_int_distribution<unsigned int> distribution(0, 0xFF);
+    const auto one = BigNumber({ 1 });
+    while (true)
+    {
+        std::vector<unsigned char> random(modulus.data().size() - 1);
+        std::generate(random.begin(), random.end(), [&]()
+        {
+            return distribution(random_device);
+        });
+        const BigNumber r{ random };
+        if (r <= one)
+        {
+            continue;
+        }
+        const auto inverse = r.inverse_multiplicative(modulus);
+        if (r * inverse % modulus != one)
+        {
+            continue; // r shares factor with modulus
+        }
+        blinding = montgomery.to_montgomery(montgomery.power_modulus(r, public_exponent));
+        unblinding = montgomery.to_montgomery(inverse);
+        return;
+    }
+}
+
+BigNumber RsaPrivateKey::compute(const BigNumber &cypher) const
+{
+    auto value = montgomery.to_montgomery(cypher);
+    Limbs unblind{};
+    {
+        std::lock_guard<std::mutex> lock(blinding_mutex);
+        montgomery.multiply(value, blinding, value);
+        unblind = unblinding;
+        montgomery.multiply(blinding, blinding, blinding);
+        montgomery.multiply(unblinding, unblinding, unblinding);
+    }
+    Limbs result{};
+    montgomery.power_modulus_fixed_window(value, private_exponent, result);
+    montgomery.multiply(result, unblind, result);
+    return montgomery.from_montgomery(result);
+}
+
+const BigNumber &RsaPrivateKey::get_modulus() const
+{
+    return modulus;
+}
+
+RsaPublicKeyCache::RsaPublicKeyCache(size_t capacity) : capacity(capacity)
+{
+
+}
+
+std::shared_ptr<const RsaPublicKey> RsaPublicKeyCache::get(const std::vector<unsigned char> &public_key)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        const auto cached = index.find(public_key);
+        if (cached != index.end())
+        {
+            entries.splice(entries.begin(), entries, cached->second);
+            return cached->second->second;
+        }
+    }
+    // parse outside of the lock, so slow keys don't block lookups of other hosts
+    auto parsed = std::make_shared<const RsaPublicKey>(RsaPublicKey::parse(public_key));
+    std::lock_guard<std::mutex> lock(mutex);
+    const auto cached = index.find(public_key);
+    if (cached != index.end())
+    {
+        entries.splice(entries.begin(), entries, cached->second);
+        return cached->second->second;
+    }
+    entries.emplace_front(public_key, parsed);
+    index.emplace(public_key, entries.begin());
+    while (entries.size() > capacity)
+    {
+        index.erase(entries.back().first);
+        entries.pop_back();
+    }
+    return parsed;
+}
+
+size_t RsaPublicKeyCache::size()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return entries.size();
+}
+
+RsaPublicKeyCache &RsaPublicKeyCache::instance()
+{
+    static RsaPublicKeyCache cache{ 512 };
+    return cache;
+}
+
 std::vector<unsigned char> rsa_encrypt(
         const std::vector<unsigned char> &input,
-        const BigNumber &public_key,
-        const BigNumber &modulus)
+        const RsaPublicKey &public_key)
 {
+    const auto &modulus = public_key.get_modulus();
     if (modulus.bit_length() % 8 != 0)
     {
         throw std::runtime_error("modulus bit length must be multiple of 8");
@@ -33,8 +205,8 @@ std::vector<unsigned char> rsa_encrypt(
         {
             block.at(j) = j; // this padding should be random
         }
-        const auto cypher_block = rsa_compute(BigNumber(block), public_key, modulus)
-                .data();
+        const auto cypher_block = public_key.compute(BigNumber(block)).data();
+        output.insert(output.cend(), block.size() - cypher_block.size(), 0);
         output.insert(output.cend(), cypher_block.begin(), cypher_block.end());
         std::fill(block.begin(), block.end(), 0);
         i += payload_size;
@@ -42,10 +214,18 @@ std::vector<unsigned char> rsa_encrypt(
     return output;
 }
 
-std::vector<unsigned char> rsa_decrypt(
-        const std::vector<unsigned char> &cypher,
-        const BigNumber &private_key,
+std::vector<unsigned char> rsa_encrypt(
+        const std::vector<unsigned char> &input,
+        const BigNumber &public_key,
         const BigNumber &modulus)
+{
+    return rsa_encrypt(input, RsaPublicKey{ modulus, public_key });
+}
+
+std::vector<unsigned char> rsa_decrypt_blocks(
+        const std::vector<unsigned char> &cypher,
+        const BigNumber &modulus,
+        const auto compute)
 {
     if (modulus.bit_length() % 8 != 0)
     {
@@ -60,8 +240,9 @@ std::vector<unsigned char> rsa_decrypt(
     for (size_t i = 0; i < cypher.size(); i += cypher_block.size())
     {
         std::copy_n(cypher.begin() + i, cypher_block.size(), cypher_block.begin());
-        const auto decrypted_block = rsa_compute(BigNumber(cypher_block), private_key, modulus).data();
-        if (decrypted_block.at(1) != 2)
+        auto decrypted_block = compute(BigNumber(cypher_block)).data();
+        decrypted_block.insert(decrypted_block.begin(), cypher_block.size() - decrypted_block.size(), 0);
+        if (decrypted_block.at(0) != 0 || decrypted_block.at(1) != 2)
         {
             throw std::runtime_error("unexpected padding type");
         }
@@ -74,4 +255,29 @@ std::vector<unsigned char> rsa_decrypt(
         std::copy(payload_start, decrypted_block.end(), std::back_inserter(output));
     }
     return output;
-}
\ No newline at end of file
+}
+
+std::vector<unsigned char> rsa_decrypt(
+        const std::vector<unsigned char> &cypher,
+        const RsaPrivateKey &private_key)
+{
+    return rsa_decrypt_blocks(cypher, private_key.get_modulus(), [&](const BigNumber &block)
+    {
+        return private_key.compute(block);
+    });
+}
+
+std::vector<unsigned char> rsa_decrypt(
+        const std::vector<unsigned char> &cypher,
+        const BigNumber &private_key,
+        const BigNumber &modulus)
+{
+    const MontgomeryContext montgomery{ modulus };
+    const auto exp = to_limbs(private_key, montgomery.size());
+    return rsa_decrypt_blocks(cypher, modulus, [&](const BigNumber &block)
+    {
+        Limbs result{};
+        montgomery.power_modulus_fixed_window(montgomery.to_montgomery(block), exp, result);
+        return montgomery.from_montgomery(result);
+    });
+}
@@ -1,15 +1,130 @@
 #ifndef TLS_PLAYGROUND_RSA_HPP
 #define TLS_PLAYGROUND_RSA_HPP
 
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
 #include "math.hpp"
+#include "montgomery.hpp"
 
 BigNumber rsa_compute(const BigNumber &message, const BigNumber &exp, const BigNumber &modulus);
 
+class RsaPublicKey
+{
+    BigNumber modulus;
+    BigNumber exponent;
+    MontgomeryContext montgomery;
+    /**
+     * Exponent value when it fits 32 bits (practically always: 65537 or 3), zero otherwise.
+     */
+    uint32_t short_exponent{};
+
+public:
+    RsaPublicKey(const BigNumber &modulus, const BigNumber &exponent);
+
+    /**
+     * Parse PKCS#1 RSAPublicKey structure, i.e. key of x509 subject public key info.
+     */
+    [[nodiscard]]
+    static RsaPublicKey parse(const std::vector<unsigned char> &public_key);
+
+    [[nodiscard]]
+    BigNumber compute(const BigNumber &message) const;
+
+    [[nodiscard]]
+    const BigNumber &get_modulus() const;
+
+    [[nodiscard]]
+    const BigNumber &get_exponent() const;
+};
+
+/**
+ * Private key hardened against timing attacks: input is multiplicatively blinded and exponentiation uses
+ * fixed width limbs with constant-time window lookups.
+ */
+class RsaPrivateKey
+{
+    BigNumber modulus;
+    MontgomeryContext montgomery;
+    Limbs private_exponent;
+    BigNumber public_exponent;
+    /**
+     * Blinding pair in montgomery form: r^e and r^-1. Both are squared after every use,
+     * which keeps the pair valid without new inversion.
+     */
+    mutable Limbs blinding{};
+    mutable Limbs unblinding{};
+    mutable std::mutex blinding_mutex{};
+
+    void reset_blinding() const;
+
+public:
+    RsaPrivateKey(const BigNumber &modulus, const BigNumber &private_exponent, const BigNumber &public_exponent);
+
+    [[nodiscard]]
+    BigNumber compute(const BigNumber &cypher) const;
+
+    [[nodiscard]]
+    const BigNumber &get_modulus() const;
+};
+
+/**
+ * LRU cache of parsed public keys, keyed by PKCS#1 RSAPublicKey bytes. Thread safe.
+ */
+class RsaPublicKeyCache
+{
+    using Entry = std::pair<std::vector<unsigned char>, std::shared_ptr<const RsaPublicKey>>;
+
+    struct KeyHash
+    {
+        size_t operator()(const std::vector<unsigned char> &key) const;
+    };
+
+    size_t capacity;
+    /**
+     * Most recently used first.
+     */
+    std::list<Entry> entries{};
+    std::unordered_map<std::vector<unsigned char>, std::list<Entry>::iterator, KeyHash> index{};
+    std::mutex mutex{};
+
+public:
+    explicit RsaPublicKeyCache(size_t capacity);
+
+    [[nodiscard]]
+    std::shared_ptr<const RsaPublicKey> get(const std::vector<unsigned char> &public_key);
+
+    [[nodiscard]]
+    size_t size();
+
+    /**
+     * Process wide cache.
+     */
+    static RsaPublicKeyCache &instance();
+};
+
+std::vector<unsigned char> rsa_encrypt(
+        const std::vector<unsigned char> &input,
+        const RsaPublicKey &public_key);
+
 std::vector<unsigned char> rsa_encrypt(
         const std::vector<unsigned char> &input,
         const BigNumber &public_key,
         const BigNumber &modulus);
 
+std::vector<unsigned char> rsa_decrypt(
+        const std::vector<unsigned char> &cypher,
+        const RsaPrivateKey &private_key);
+
+/**
+ * Unblinded, public exponent is not known. Prefer RsaPrivateKey overload.
+ */
 std::vector<unsigned char> rsa_decrypt(
         const std::vector<unsigned char> &cypher,
         const BigNumber &private_key,
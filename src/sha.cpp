@@ -1,23 +1,39 @@
 #include <algorithm>
 #include <array>
+#include <bit>
 #include <cstdint>
+#include <utility>
+
+#include "block_hashing.hpp"
+#include "cpu_features.hpp"
+#include "sha256_multi_buffer.hpp"
+#include "sha512_avx2.hpp"
+#include "sha_ni.hpp"
 
 #include "sha.hpp"
 
-uint_fast32_t ch(uint_fast32_t x, uint_fast32_t y, uint_fast32_t z)
+template<typename Word>
+Word ch(Word x, Word y, Word z)
 {
     return (x & y) ^ (~x & z);
 }
 
-uint_fast32_t maj(uint_fast32_t x, uint_fast32_t y, uint_fast32_t z)
+template<typename Word>
+Word maj(Word x, Word y, Word z)
 {
     return (x & y) ^ (x & z) ^ (y & z);
 }
 
+uint64_t load_big_endian64(const unsigned char *bytes)
+{
+    return static_cast<uint64_t>(load_word32<std::endian::big>(bytes)) << 32 |
+           load_word32<std::endian::big>(bytes + 4);
+}
+
 namespace sha1
 {
 
-    const std::array<uint_fast32_t, 4> round_constants{
+    const std::array<uint32_t, 4> round_constants{
             0x5a827999,
             0x6ed9eba1,
             0x8f1bbcdc,
@@ -25,72 +41,80 @@ namespace sha1
     };
 
 
-    static uint_fast32_t parity(uint_fast32_t x, uint_fast32_t y, uint_fast32_t z)
+    static uint32_t parity(uint32_t x, uint32_t y, uint32_t z)
     {
         return x ^ y ^ z;
     }
 
-    void block_hash(const std::array<unsigned char, 64> &block, std::array<uint_fast32_t, 5> &hash)
+    /**
+     * Round t of the fully unrolled compression. Working variables rotate through the array instead of being
+     * moved, message schedule is a ring of the last 16 words. Everything indexed by t is resolved at compile time.
+     */
+    template<size_t t>
+    inline void round(std::array<uint32_t, 5> &v, std::array<uint32_t, 16> &w)
     {
-        std::array<uint_fast32_t, 80> W{};
-        uint_fast32_t a, b, c, d, e;
-        for (size_t t = 0; t < W.size(); t++)
+        constexpr size_t offset = 5 - t % 5;
+        const auto a = v[offset % 5];
+        auto &b = v[(offset + 1) % 5];
+        const auto c = v[(offset + 2) % 5];
+        const auto d = v[(offset + 3) % 5];
+        auto &e = v[(offset + 4) % 5];
+        if constexpr (t >= 16)
         {
-            if (t < 16)
-            {
-                W[t] = ((block[(t * 4)] << 24) |
-                        (block[(t * 4) + 1] << 16) |
-                        (block[(t * 4) + 2] << 8) |
-                        (block[(t * 4) + 3])) & 0xFFFFFFFF;
-            }
-            else
-            {
-                W[t] = W[t - 3] ^
-                       W[t - 8] ^
-                       W[t - 14] ^
-                       W[t - 16];
-                // 32 bit rotl
-                W[t] = (W[t] << 1) | ((W[t] & 0x80000000) >> 31);
-            }
+            w[t % 16] = std::rotl(w[(t + 13) % 16] ^ w[(t + 8) % 16] ^ w[(t + 2) % 16] ^ w[t % 16], 1);
         }
-        a = hash[0];
-        b = hash[1];
-        c = hash[2];
-        d = hash[3];
-        e = hash[4];
-        for (size_t t = 0; t < W.size(); t++)
+        uint32_t f;
+        if constexpr (t < 20)
         {
-            auto T = (((a << 5) | ((a & 0xFFFFFFFF) >> 27)) + e + round_constants.at(t / 20) + W[t]) & 0xFFFFFFFF;
-            if (t <= 19)
-            {
-                T += ch(b, c, d);
-            }
-            else if (t <= 39)
-            {
-                T += parity(b, c, d);
-            }
-            else if (t <= 59)
+            f = ch(b, c, d);
+        }
+        else if constexpr (t >= 40 && t < 60)
+        {
+            f = maj(b, c, d);
+        }
+        else
+        {
+            f = parity(b, c, d);
+        }
+        e += std::rotl(a, 5) + f + round_constants[t / 20] + w[t % 16];
+        b = std::rotl(b, 30);
+    }
+
+    template<size_t... rounds>
+    inline void all_rounds(std::array<uint32_t, 5> &v, std::array<uint32_t, 16> &w, std::index_sequence<rounds...>)
+    {
+        (round<rounds>(v, w), ...);
+    }
+
+    void compress_portable(std::array<uint32_t, 5> &state, const unsigned char *blocks, size_t count)
+    {
+        std::array<uint32_t, 16> w{};
+        for (size_t block = 0; block < count; ++block)
+        {
+            for (size_t i = 0; i < w.size(); ++i)
             {
-                T += maj(b, c, d);
+                w[i] = load_word32<std::endian::big>(blocks + 64 * block + 4 * i);
             }
-            else
+            auto v = state;
+            all_rounds(v, w, std::make_index_sequence<80>());
+            for (size_t i = 0; i < state.size(); ++i)
             {
-                T += parity(b, c, d);
+                state[i] += v[i];
             }
-            e = d;
-            d = c;
-            c = ((b << 30) | ((b & 0xFFFFFFFF) >> 2)) & 0xFFFFFFFF;
-            b = a;
-            a = T;
         }
-        hash[0] += a;
-        hash[1] += b;
-        hash[2] += c;
-        hash[3] += d;
-        hash[4] += e;
     }
 
-    const std::array<uint_fast32_t, 5> initial_hash{
+    void compress(std::array<uint32_t, 5> &state, const unsigned char *blocks, size_t count)
+    {
+        if (cpu_features().sha)
+        {
+            sha_ni_sha1_compress(state.data(), blocks, count);
+            return;
+        }
+        compress_portable(state, blocks, count);
+    }
+
+    const std::array<uint32_t, 5> initial_hash{
             0x67452301,
             0xefcdab89,
             0x98badcfe,
@@ -99,9 +123,9 @@ namespace sha1
     };
 };
 
-consteval std::array<uint_fast32_t, 8> compute_sha256_initial_hash()
+consteval std::array<uint32_t, 8> compute_sha256_initial_hash()
 {
-    std::array<uint_fast32_t, 8> hash{
+    std::array<uint32_t, 8> hash{
             0x67e6096a,
             0x85ae67bb,
             0x72f36e3c,
@@ -111,7 +135,7 @@ consteval std::array<uint_fast32_t, 8> compute_sha256_initial_hash()
             0xabd9831f,
             0x19cde05b
     };
-    for (unsigned long &i: hash)
+    for (auto &i: hash)
     {
         i = (i & 0xFF) << 24
             | (i & 0xFF00) << 8
@@ -121,29 +145,30 @@ consteval std::array<uint_fast32_t, 8> compute_sha256_initial_hash()
     return hash;
 }
 
-struct sha256
+namespace sha256
 {
-    uint_fast32_t rotr(uint_fast32_t x, uint_fast32_t n)
+
+    uint32_t big_sigma0(uint32_t x)
     {
-        return (((x & 0xFFFFFFFF) >> n) | (x << (32 - n))) & 0xFFFFFFFF;
+        return std::rotr(x, 2) ^ std::rotr(x, 13) ^ std::rotr(x, 22);
     }
 
-    uint_fast32_t shr(uint_fast32_t x, uint_fast32_t n)
+    uint32_t big_sigma1(uint32_t x)
     {
-        return (x & 0xFFFFFFFF) >> n;
+        return std::rotr(x, 6) ^ std::rotr(x, 11) ^ std::rotr(x, 25);
     }
 
-    uint_fast32_t sigma_rot(uint_fast32_t x, int i)
+    uint32_t small_sigma0(uint32_t x)
     {
-        return rotr(x, i ? 6 : 2) ^ rotr(x, i ? 11 : 13) ^ rotr(x, i ? 25 : 22);
+        return std::rotr(x, 7) ^ std::rotr(x, 18) ^ (x >> 3);
     }
 
-    uint_fast32_t sigma_shr(uint_fast32_t x, int i)
+    uint32_t small_sigma1(uint32_t x)
     {
-        return rotr(x, i ? 17 : 7) ^ rotr(x, i ? 19 : 18) ^ shr(x, i ? 10 : 3);
+        return std::rotr(x, 17) ^ std::rotr(x, 19) ^ (x >> 10);
     }
 
-    constexpr static const std::array<uint_fast32_t, 64> k{
+    constexpr std::array<uint32_t, 64> k{
             0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1,
             0x923f82a4, 0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
             0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786,
@@ -157,187 +182,306 @@ struct sha256
             0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
     };
 
-    void block_hash(const std::array<unsigned char, 64> &block, std::array<uint_fast32_t, 8> &hash)
+    /**
+     * Round t of the fully unrolled compression, same variable rotation and schedule ring as sha1::round.
+     */
+    template<size_t t>
+    inline void round(std::array<uint32_t, 8> &v, std::array<uint32_t, 16> &w)
+    {
+        constexpr size_t offset = 8 - t % 8;
+        const auto a = v[offset % 8];
+        const auto b = v[(offset + 1) % 8];
+        const auto c = v[(offset + 2) % 8];
+        auto &d = v[(offset + 3) % 8];
+        const auto e = v[(offset + 4) % 8];
+        const auto f = v[(offset + 5) % 8];
+        const auto g = v[(offset + 6) % 8];
+        auto &h = v[(offset + 7) % 8];
+        if constexpr (t >= 16)
+        {
+            w[t % 16] += small_sigma1(w[(t + 14) % 16]) + w[(t + 9) % 16] + small_sigma0(w[(t + 1) % 16]);
+        }
+        const auto t1 = h + big_sigma1(e) + ch(e, f, g) + k[t] + w[t % 16];
+        d += t1;
+        h = t1 + big_sigma0(a) + maj(a, b, c);
+    }
+
+    template<size_t... rounds>
+    inline void all_rounds(std::array<uint32_t, 8> &v, std::array<uint32_t, 16> &w, std::index_sequence<rounds...>)
     {
-        std::array<uint_fast32_t, 64> W{};
-        uint_fast32_t a, b, c, d, e, f, g, h;
-        uint_fast32_t T1, T2;
-        int t, i;
+        (round<rounds>(v, w), ...);
+    }
 
-        for (t = 0; t < 64; t++)
+    void compress_portable(std::array<uint32_t, 8> &state, const unsigned char *blocks, size_t count)
+    {
+        std::array<uint32_t, 16> w{};
+        for (size_t block = 0; block < count; ++block)
         {
-            if (t <= 15)
+            for (size_t i = 0; i < w.size(); ++i)
             {
-                W[t] = (block[(t * 4)] << 24) |
-                       (block[(t * 4) + 1] << 16) |
-                       (block[(t * 4) + 2] << 8) |
-                       (block[(t * 4) + 3]);
+                w[i] = load_word32<std::endian::big>(blocks + 64 * block + 4 * i);
             }
-            else
+            auto v = state;
+            all_rounds(v, w, std::make_index_sequence<64>());
+            for (size_t i = 0; i < state.size(); ++i)
             {
-                W[t] = (sigma_shr(W[t - 2], 1) +
-                        W[t - 7] +
-                        sigma_shr(W[t - 15], 0) +
-                        W[t - 16]) & 0xFFFFFFFF;
+                state[i] += v[i];
             }
         }
-        a = hash[0];
-        b = hash[1];
-        c = hash[2];
-        d = hash[3];
-        e = hash[4];
-        f = hash[5];
-        g = hash[6];
-        h = hash[7];
-        for (t = 0; t < 64; t++)
+    }
+
+    void compress(std::array<uint32_t, 8> &state, const unsigned char *blocks, size_t count)
+    {
+        if (cpu_features().sha)
         {
-            T1 = (h + sigma_rot(e, 1) + ch(e, f, g) + k[t] + W[t]) & 0xFFFFFFFF;
-            T2 = (sigma_rot(a, 0) + maj(a, b, c)) & 0xFFFFFFFF;
-            h = g;
-            g = f;
-            f = e;
-            e = d + T1;
-            d = c;
-            c = b;
-            b = a;
-            a = T1 + T2;
+            sha_ni_sha256_compress(state.data(), blocks, count);
+            return;
         }
-        hash[0] = a + hash[0];
-        hash[1] = b + hash[1];
-        hash[2] = c + hash[2];
-        hash[3] = d + hash[3];
-        hash[4] = e + hash[4];
-        hash[5] = f + hash[5];
-        hash[6] = g + hash[6];
-        hash[7] = h + hash[7];
+        compress_portable(state, blocks, count);
     }
 
-    const std::array<uint_fast32_t, 8> initial_hash = compute_sha256_initial_hash();
+    const std::array<uint32_t, 8> initial_hash = compute_sha256_initial_hash();
 };
 
-template<uint hash_size, class SHA>
-std::array<unsigned char, hash_size> sha_hash(SHA sha, const std::vector<unsigned char> &input)
+namespace sha512
 {
-    std::array<uint_fast32_t, hash_size / 4> hash = sha.initial_hash;
-    std::array<unsigned char, 64> block{};
-    for (size_t i = 0; i <= input.size(); i += block.size())
+
+    uint64_t big_sigma0(uint64_t x)
+    {
+        return std::rotr(x, 28) ^ std::rotr(x, 34) ^ std::rotr(x, 39);
+    }
+
+    uint64_t big_sigma1(uint64_t x)
     {
-        const auto payload_size = std::min(input.size() - i, block.size());
-        if (payload_size == block.size())
+        return std::rotr(x, 14) ^ std::rotr(x, 18) ^ std::rotr(x, 41);
+    }
+
+    uint64_t small_sigma0(uint64_t x)
+    {
+        return std::rotr(x, 1) ^ std::rotr(x, 8) ^ (x >> 7);
+    }
+
+    uint64_t small_sigma1(uint64_t x)
+    {
+        return std::rotr(x, 19) ^ std::rotr(x, 61) ^ (x >> 6);
+    }
+
+    constexpr std::array<uint64_t, 80> k{
+            0x428a2f98d728ae22, 0x7137449123ef65cd, 0xb5c0fbcfec4d3b2f,
+            0xe9b5dba58189dbbc, 0x3956c25bf348b538, 0x59f111f1b605d019,
+            0x923f82a4af194f9b, 0xab1c5ed5da6d8118, 0xd807aa98a3030242,
+            0x12835b0145706fbe, 0x243185be4ee4b28c, 0x550c7dc3d5ffb4e2,
+            0x72be5d74f27b896f, 0x80deb1fe3b1696b1, 0x9bdc06a725c71235,
+            0xc19bf174cf692694, 0xe49b69c19ef14ad2, 0xefbe4786384f25e3,
+            0x0fc19dc68b8cd5b5, 0x240ca1cc77ac9c65, 0x2de92c6f592b0275,
+            0x4a7484aa6ea6e483, 0x5cb0a9dcbd41fbd4, 0x76f988da831153b5,
+            0x983e5152ee66dfab, 0xa831c66d2db43210, 0xb00327c898fb213f,
+            0xbf597fc7beef0ee4, 0xc6e00bf33da88fc2, 0xd5a79147930aa725,
+            0x06ca6351e003826f, 0x142929670a0e6e70, 0x27b70a8546d22ffc,
+            0x2e1b21385c26c926, 0x4d2c6dfc5ac42aed, 0x53380d139d95b3df,
+            0x650a73548baf63de, 0x766a0abb3c77b2a8, 0x81c2c92e47edaee6,
+            0x92722c851482353b, 0xa2bfe8a14cf10364, 0xa81a664bbc423001,
+            0xc24b8b70d0f89791, 0xc76c51a30654be30, 0xd192e819d6ef5218,
+            0xd69906245565a910, 0xf40e35855771202a, 0x106aa07032bbd1b8,
+            0x19a4c116b8d2d0c8, 0x1e376c085141ab53, 0x2748774cdf8eeb99,
+            0x34b0bcb5e19b48a8, 0x391c0cb3c5c95a63, 0x4ed8aa4ae3418acb,
+            0x5b9cca4f7763e373, 0x682e6ff3d6b2b8a3, 0x748f82ee5defb2fc,
+            0x78a5636f43172f60, 0x84c87814a1f0ab72, 0x8cc702081a6439ec,
+            0x90befffa23631e28, 0xa4506cebde82bde9, 0xbef9a3f7b2c67915,
+            0xc67178f2e372532b, 0xca273eceea26619c, 0xd186b8c721c0c207,
+            0xeada7dd6cde0eb1e, 0xf57d4f7fee6ed178, 0x06f067aa72176fba,
+            0x0a637dc5a2c898a6, 0x113f9804bef90dae, 0x1b710b35131c471b,
+            0x28db77f523047d84, 0x32caab7b40c72493, 0x3c9ebe0a15c9bebc,
+            0x431d67c49c100d4c, 0x4cc5d4becb3e42b6, 0x597f299cfc657e2a,
+            0x5fcb6fab3ad6faec, 0x6c44198c4a475817
+    };
+
+    /**
+     * Round t with message word and round constant already summed, same variable rotation as sha256::round.
+     */
+    template<size_t t>
+    inline void round(std::array<uint64_t, 8> &v, uint64_t word_and_constant)
+    {
+        constexpr size_t offset = 8 - t % 8;
+        const auto a = v[offset % 8];
+        const auto b = v[(offset + 1) % 8];
+        const auto c = v[(offset + 2) % 8];
+        auto &d = v[(offset + 3) % 8];
+        const auto e = v[(offset + 4) % 8];
+        const auto f = v[(offset + 5) % 8];
+        const auto g = v[(offset + 6) % 8];
+        auto &h = v[(offset + 7) % 8];
+        const auto t1 = h + big_sigma1(e) + ch(e, f, g) + word_and_constant;
+        d += t1;
+        h = t1 + big_sigma0(a) + maj(a, b, c);
+    }
+
+    template<size_t t>
+    inline uint64_t schedule(std::array<uint64_t, 16> &w)
+    {
+        if constexpr (t >= 16)
         {
-            std::copy_n(input.begin() + i, payload_size, block.begin());
-            sha.block_hash(block, hash);
+            w[t % 16] += small_sigma1(w[(t + 14) % 16]) + w[(t + 9) % 16] + small_sigma0(w[(t + 1) % 16]);
         }
-        else if (payload_size <= block.size() - 9)
+        return w[t % 16];
+    }
+
+    template<size_t... rounds>
+    inline void all_rounds(std::array<uint64_t, 8> &v, std::array<uint64_t, 16> &w, std::index_sequence<rounds...>)
+    {
+        (round<rounds>(v, schedule<rounds>(w) + k[rounds]), ...);
+    }
+
+    template<size_t... rounds>
+    inline void all_rounds(std::array<uint64_t, 8> &v, const std::array<uint64_t, 80> &scheduled,
+            std::index_sequence<rounds...>)
+    {
+        (round<rounds>(v, scheduled[rounds]), ...);
+    }
+
+    void compress_portable(std::array<uint64_t, 8> &state, const unsigned char *blocks, size_t count)
+    {
+        std::array<uint64_t, 16> w{};
+        for (size_t block = 0; block < count; ++block)
         {
-            std::fill(block.begin(), block.end(), 0);
-            std::copy_n(input.begin() + i, payload_size, block.begin());
-            block[payload_size] = 0x80;
-            block[block.size() - 8] = (input.size() * 8 & 0xFF00000000000000) >> 56;
-            block[block.size() - 7] = (input.size() * 8 & 0x00FF000000000000) >> 48;
-            block[block.size() - 6] = (input.size() * 8 & 0x0000FF0000000000) >> 40;
-            block[block.size() - 5] = (input.size() * 8 & 0x000000FF00000000) >> 32;
-            block[block.size() - 4] = (input.size() * 8 & 0xFF000000) >> 24;
-            block[block.size() - 3] = (input.size() * 8 & 0x00FF0000) >> 16;
-            block[block.size() - 2] = (input.size() * 8 & 0x0000FF00) >> 8;
-            block[block.size() - 1] = (input.size() * 8 & 0x000000FF);
-            sha.block_hash(block, hash);
+            for (size_t i = 0; i < w.size(); ++i)
+            {
+                w[i] = load_big_endian64(blocks + 128 * block + 8 * i);
+            }
+            auto v = state;
+            all_rounds(v, w, std::make_index_sequence<80>());
+            for (size_t i = 0; i < state.size(); ++i)
+            {
+                state[i] += v[i];
+            }
         }
-        else
+    }
+
+    /**
+     * Message schedule runs ahead in vector registers, the rounds only add the precomputed words.
+     */
+    void compress_avx2(std::array<uint64_t, 8> &state, const unsigned char *blocks, size_t count)
+    {
+        alignas(32) std::array<uint64_t, 80> scheduled{};
+        for (size_t block = 0; block < count; ++block)
         {
-            std::fill(block.begin(), block.end(), 0);
-            std::copy_n(input.begin() + i, payload_size, block.begin());
-            block[payload_size] = 0x80;
-            sha.block_hash(block, hash);
-            std::fill(block.begin(), block.end(), 0);
-            block[block.size() - 8] = (input.size() * 8 & 0xFF00000000000000) >> 56;
-            block[block.size() - 7] = (input.size() * 8 & 0x00FF000000000000) >> 48;
-            block[block.size() - 6] = (input.size() * 8 & 0x0000FF0000000000) >> 40;
-            block[block.size() - 5] = (input.size() * 8 & 0x000000FF00000000) >> 32;
-            block[block.size() - 4] = (input.size() * 8 & 0xFF000000) >> 24;
-            block[block.size() - 3] = (input.size() * 8 & 0x00FF0000) >> 16;
-            block[block.size() - 2] = (input.size() * 8 & 0x0000FF00) >> 8;
-            block[block.size() - 1] = (input.size() * 8 & 0x000000FF);
-            sha.block_hash(block, hash);
+            sha512_avx2_schedule(blocks + 128 * block, k.data(), scheduled.data());
+            auto v = state;
+            all_rounds(v, scheduled, std::make_index_sequence<80>());
+            for (size_t i = 0; i < state.size(); ++i)
+            {
+                state[i] += v[i];
+            }
         }
     }
-    std::array<unsigned char, hash_size> result{};
-    for (size_t i = 0; i < result.size(); ++i)
+
+    void compress(std::array<uint64_t, 8> &state, const unsigned char *blocks, size_t count)
     {
-        result[i] = (hash[i / 4] >> ((3 - (i % 4)) * 8)) & 0xFF;
+        if (cpu_features().avx2)
+        {
+            compress_avx2(state, blocks, count);
+            return;
+        }
+        compress_portable(state, blocks, count);
     }
-    return result;
-}
+};
 
-std::array<unsigned char, 32> sha256_hash(const std::vector<unsigned char> &input)
+std::array<unsigned char, 32> sha256_hash_message(std::span<const unsigned char> input)
 {
-    return sha_hash<32>(sha256{}, input);
+    auto state = sha256::initial_hash;
+    const auto full_blocks = input.size() / 64;
+    sha256::compress(state, input.data(), full_blocks);
+    std::array<unsigned char, 128> padding{};
+    const auto padding_blocks = pad_final_blocks<std::endian::big>(input.data() + 64 * full_blocks,
+            input.size() % 64, input.size(), padding);
+    sha256::compress(state, padding.data(), padding_blocks);
+    return store_hash<std::endian::big, 32>(state);
 }
 
-Sha1Hashing::Sha1Hashing() : state(sha1::initial_hash)
+std::array<unsigned char, 32> sha256_hash(const std::vector<unsigned char> &input)
 {
-
+    return sha256_hash_message(input);
 }
 
-void Sha1Hashing::append(const std::vector<unsigned char> &input)
+std::vector<std::array<unsigned char, 32>> sha256_hash_many(std::span<const std::span<const unsigned char>> messages)
 {
-    auto remains = input.size();
-    auto input_iter = input.begin();
-    while (remains > 0)
+    std::vector<std::array<unsigned char, 32>> result(messages.size());
+    // one SHA extensions stream is faster than 8 AVX2 lanes, but 16 AVX-512 lanes beat it
+    if (TLS_PLAYGROUND_X86 && cpu_features().avx512)
     {
-        auto copy = std::min(block_buffer.size() - buffer_pos, remains);
-        std::copy_n(input_iter, copy, block_buffer.begin() + buffer_pos);
-        buffer_pos += copy;
-        remains -= copy;
-        input_iter += copy;
-        if (buffer_pos == block_buffer.size())
-        {
-            sha1::block_hash(block_buffer, state);
-            buffer_pos = 0;
-        }
+        hash_lanes<16, std::endian::big>(messages, result, sha256::initial_hash, sha256::k.data(),
+                &sha256_compress_x16_avx512);
     }
-    input_size += input.size();
-}
-
-std::array<unsigned char, 20> Sha1Hashing::close()
-{
-    if (buffer_pos <= block_buffer.size() - 9)
+    else if (!TLS_PLAYGROUND_X86 || cpu_features().sha)
     {
-        std::fill(block_buffer.begin() + buffer_pos, block_buffer.end() - 8, 0);
-        block_buffer[buffer_pos] = 0x80;
-        block_buffer[block_buffer.size() - 8] = (input_size * 8 & 0xFF00000000000000) >> 56;
-        block_buffer[block_buffer.size() - 7] = (input_size * 8 & 0x00FF000000000000) >> 48;
-        block_buffer[block_buffer.size() - 6] = (input_size * 8 & 0x0000FF0000000000) >> 40;
-        block_buffer[block_buffer.size() - 5] = (input_size * 8 & 0x000000FF00000000) >> 32;
-        block_buffer[block_buffer.size() - 4] = (input_size * 8 & 0xFF000000) >> 24;
-        block_buffer[block_buffer.size() - 3] = (input_size * 8 & 0x00FF0000) >> 16;
-        block_buffer[block_buffer.size() - 2] = (input_size * 8 & 0x0000FF00) >> 8;
-        block_buffer[block_buffer.size() - 1] = (input_size * 8 & 0x000000FF);
-        sha1::block_hash(block_buffer, state);
+        std::ranges::transform(messages, result.begin(), [](const auto message)
+        {
+            return sha256_hash_message(message);
+        });
     }
-    else
+    else if (cpu_features().avx2)
     {
-        std::fill(block_buffer.begin() + buffer_pos, block_buffer.end(), 0);
-        block_buffer[buffer_pos] = 0x80;
-        sha1::block_hash(block_buffer, state);
-        std::fill(block_buffer.begin(), block_buffer.end() - 8, 0);
-        block_buffer[block_buffer.size() - 8] = (input_size * 8 & 0xFF00000000000000) >> 56;
-        block_buffer[block_buffer.size() - 7] = (input_size * 8 & 0x00FF000000000000) >> 48;
-        block_buffer[block_buffer.size() - 6] = (input_size * 8 & 0x0000FF0000000000) >> 40;
-        block_buffer[block_buffer.size() - 5] = (input_size * 8 & 0x000000FF00000000) >> 32;
-        block_buffer[block_buffer.size() - 4] = (input_size * 8 & 0xFF000000) >> 24;
-        block_buffer[block_buffer.size() - 3] = (input_size * 8 & 0x00FF0000) >> 16;
-        block_buffer[block_buffer.size() - 2] = (input_size * 8 & 0x0000FF00) >> 8;
-        block_buffer[block_buffer.size() - 1] = (input_size * 8 & 0x000000FF);
-        sha1::block_hash(block_buffer, state);
+        hash_lanes<8, std::endian::big>(messages, result, sha256::initial_hash, sha256::k.data(),
+                &sha256_compress_x8_avx2);
     }
-    std::array<unsigned char, 20> result{};
-    for (size_t i = 0; i < result.size(); ++i)
+    else
     {
-        result[i] = (state[i / 4] >> ((3 - (i % 4)) * 8)) & 0xFF;
+        hash_lanes<4, std::endian::big>(messages, result, sha256::initial_hash, sha256::k.data(),
+                &sha256_compress_x4_sse2);
     }
-    input_size = 0;
-    buffer_pos = 0;
-    state = sha1::initial_hash;
     return result;
 }
+
+const std::array<uint32_t, 5> Sha1::initial_hash = sha1::initial_hash;
+
+void Sha1::compress(std::array<uint32_t, 5> &state, const unsigned char *blocks, size_t count)
+{
+    sha1::compress(state, blocks, count);
+}
+
+const std::array<uint32_t, 8> Sha256::initial_hash = sha256::initial_hash;
+
+void Sha256::compress(std::array<uint32_t, 8> &state, const unsigned char *blocks, size_t count)
+{
+    sha256::compress(state, blocks, count);
+}
+
+void Sha512::compress(std::array<uint64_t, 8> &state, const unsigned char *blocks, size_t count)
+{
+    sha512::compress(state, blocks, count);
+}
+
+const std::array<uint64_t, 8> Sha512::initial_hash{
+        0x6a09e667f3bcc908, 0xbb67ae8584caa73b, 0x3c6ef372fe94f82b, 0xa54ff53a5f1d36f1,
+        0x510e527fade682d1, 0x9b05688c2b3e6c1f, 0x1f83d9abfb41bd6b, 0x5be0cd19137e2179
+};
+
+const std::array<uint64_t, 8> Sha384::initial_hash{
+        0xcbbb9d5dc1059ed8, 0x629a292a367cd507, 0x9159015a3070dd17, 0x152fecd8f70e5939,
+        0x67332667ffc00b31, 0x8eb44a8768581511, 0xdb0c2e0d64f98fa7, 0x47b5481dbefa4fa4
+};
+
+const std::array<uint64_t, 8> Sha512_256::initial_hash{
+        0x22312194fc2bf72c, 0x9f555fa3c84c64c2, 0x2393b86b6f53b151, 0x963877195940eabd,
+        0x96283ee2a88effe3, 0xbe5e1e2553863992, 0x2b0199fc2c85b8aa, 0x0eb72ddc81c52ca2
+};
+
+template class BlockHashing<Sha1>;
+template class BlockHashing<Sha256>;
+template class BlockHashing<Sha384>;
+template class BlockHashing<Sha512>;
+template class BlockHashing<Sha512_256>;
+
+std::array<unsigned char, 48> sha384_hash(std::span<const unsigned char> input)
+{
+    Sha384Hashing hashing{};
+    hashing.append(input);
+    return hashing.close();
+}
+
+std::array<unsigned char, 64> sha512_hash(std::span<const unsigned char> input)
+{
+    Sha512Hashing hashing{};
+    hashing.append(input);
+    return hashing.close();
+}
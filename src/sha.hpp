@@ -2,24 +2,92 @@
 #define TLS_PLAYGROUND_SHA_HPP
 
 #include <array>
+#include <bit>
 #include <cstddef>
 #include <cstdint>
+#include <span>
 #include <vector>
 
+#include "block_hashing.hpp"
+
 std::array<unsigned char, 32> sha256_hash(const std::vector<unsigned char> &input);
 
-class Sha1Hashing
+/**
+ * Hashes independent messages in SIMD lanes, 16 with AVX-512, 8 with AVX2 and 4 with SSE2. Lanes take the next
+ * message as soon as their current one is finished, so lengths may differ freely. With SHA extensions and no
+ * AVX-512 messages are hashed one after another, which is faster than AVX2 lanes.
+ * @return digests in the order of messages
+ */
+std::vector<std::array<unsigned char, 32>> sha256_hash_many(std::span<const std::span<const unsigned char>> messages);
+
+struct Sha1
+{
+    using Word = uint32_t;
+    static constexpr std::endian byte_order = std::endian::big;
+    static constexpr size_t state_words = 5;
+    static constexpr size_t block_size = 64;
+    static constexpr size_t digest_size = 20;
+    static const std::array<Word, state_words> initial_hash;
+
+    static void compress(std::array<Word, state_words> &state, const unsigned char *blocks, size_t count);
+};
+
+struct Sha256
 {
-    std::array<uint_fast32_t, 5> state;
-    std::array<unsigned char, 64> block_buffer{};
-    size_t buffer_pos{};
-    size_t input_size{};
-public:
-    Sha1Hashing();
+    using Word = uint32_t;
+    static constexpr std::endian byte_order = std::endian::big;
+    static constexpr size_t state_words = 8;
+    static constexpr size_t block_size = 64;
+    static constexpr size_t digest_size = 32;
+    static const std::array<Word, state_words> initial_hash;
 
-    void append(const std::vector<unsigned char> &input);
+    static void compress(std::array<Word, state_words> &state, const unsigned char *blocks, size_t count);
+};
 
-    std::array<unsigned char, 20> close();
+struct Sha512
+{
+    using Word = uint64_t;
+    static constexpr std::endian byte_order = std::endian::big;
+    static constexpr size_t state_words = 8;
+    static constexpr size_t block_size = 128;
+    static constexpr size_t digest_size = 64;
+    static const std::array<Word, state_words> initial_hash;
+
+    static void compress(std::array<Word, state_words> &state, const unsigned char *blocks, size_t count);
 };
 
+/**
+ * SHA-512 compression with its own initial hash, truncated to 48 bytes.
+ */
+struct Sha384 : Sha512
+{
+    static constexpr size_t digest_size = 48;
+    static const std::array<Word, state_words> initial_hash;
+};
+
+/**
+ * SHA-512/256: SHA-512 compression with its own initial hash, truncated to 32 bytes.
+ */
+struct Sha512_256 : Sha512
+{
+    static constexpr size_t digest_size = 32;
+    static const std::array<Word, state_words> initial_hash;
+};
+
+extern template class BlockHashing<Sha1>;
+extern template class BlockHashing<Sha256>;
+extern template class BlockHashing<Sha384>;
+extern template class BlockHashing<Sha512>;
+extern template class BlockHashing<Sha512_256>;
+
+using Sha1Hashing = BlockHashing<Sha1>;
+using Sha256Hashing = BlockHashing<Sha256>;
+using Sha384Hashing = BlockHashing<Sha384>;
+using Sha512Hashing = BlockHashing<Sha512>;
+using Sha512_256Hashing = BlockHashing<Sha512_256>;
+
+std::array<unsigned char, 48> sha384_hash(std::span<const unsigned char> input);
+
+std::array<unsigned char, 64> sha512_hash(std::span<const unsigned char> input);
+
 #endif //TLS_PLAYGROUND_SHA_HPP
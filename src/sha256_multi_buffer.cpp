@@ -0,0 +1,214 @@
+#include <stdexcept>
+
+#include "cpu_features.hpp"
+
+#include "sha256_multi_buffer.hpp"
+
+#if TLS_PLAYGROUND_X86
+
+#include <immintrin.h>
+
+template<int bits>
+TLS_PLAYGROUND_TARGET("sse2")
+inline __m128i rotr_sse2(__m128i x)
+{
+    return _mm_or_si128(_mm_srli_epi32(x, bits), _mm_slli_epi32(x, 32 - bits));
+}
+
+TLS_PLAYGROUND_TARGET("sse2")
+void sha256_compress_x4_sse2(uint32_t *state, const uint32_t *words, const uint32_t *round_constants)
+{
+    __m128i w[16];
+    for (size_t i = 0; i < 16; ++i)
+    {
+        w[i] = _mm_load_si128(reinterpret_cast<const __m128i *>(words) + i);
+    }
+    __m128i v[8];
+    for (size_t i = 0; i < 8; ++i)
+    {
+        v[i] = _mm_load_si128(reinterpret_cast<const __m128i *>(state) + i);
+    }
+    auto [a, b, c, d, e, f, g, h] = v;
+    for (size_t t = 0; t < 64; ++t)
+    {
+        auto &word = w[t % 16];
+        if (t >= 16)
+        {
+            const auto &w2 = w[(t + 14) % 16];
+            const auto &w15 = w[(t + 1) % 16];
+            const auto sigma1 = _mm_xor_si128(_mm_xor_si128(rotr_sse2<17>(w2), rotr_sse2<19>(w2)),
+                    _mm_srli_epi32(w2, 10));
+            const auto sigma0 = _mm_xor_si128(_mm_xor_si128(rotr_sse2<7>(w15), rotr_sse2<18>(w15)),
+                    _mm_srli_epi32(w15, 3));
+            word = _mm_add_epi32(_mm_add_epi32(word, sigma1), _mm_add_epi32(w[(t + 9) % 16], sigma0));
+        }
+        const auto big_sigma1 = _mm_xor_si128(_mm_xor_si128(rotr_sse2<6>(e), rotr_sse2<11>(e)), rotr_sse2<25>(e));
+        const auto ch = _mm_xor_si128(_mm_and_si128(e, f), _mm_andnot_si128(e, g));
+        const auto t1 = _mm_add_epi32(_mm_add_epi32(_mm_add_epi32(h, big_sigma1), _mm_add_epi32(ch, word)),
+                _mm_set1_epi32(static_cast<int>(round_constants[t])));
+        const auto big_sigma0 = _mm_xor_si128(_mm_xor_si128(rotr_sse2<2>(a), rotr_sse2<13>(a)), rotr_sse2<22>(a));
+        const auto maj = _mm_or_si128(_mm_and_si128(a, b), _mm_and_si128(c, _mm_or_si128(a, b)));
+        h = g;
+        g = f;
+        f = e;
+        e = _mm_add_epi32(d, t1);
+        d = c;
+        c = b;
+        b = a;
+        a = _mm_add_epi32(t1, _mm_add_epi32(big_sigma0, maj));
+    }
+    const __m128i result[8]{ a, b, c, d, e, f, g, h };
+    for (size_t i = 0; i < 8; ++i)
+    {
+        _mm_store_si128(reinterpret_cast<__m128i *>(state) + i, _mm_add_epi32(v[i], result[i]));
+    }
+}
+
+template<int bits>
+TLS_PLAYGROUND_TARGET("avx2")
+inline __m256i rotr_avx2(__m256i x)
+{
+    return _mm256_or_si256(_mm256_srli_epi32(x, bits), _mm256_slli_epi32(x, 32 - bits));
+}
+
+TLS_PLAYGROUND_TARGET("avx2")
+void sha256_compress_x8_avx2(uint32_t *state, const uint32_t *words, const uint32_t *round_constants)
+{
+    __m256i w[16];
+    for (size_t i = 0; i < 16; ++i)
+    {
+        w[i] = _mm256_load_si256(reinterpret_cast<const __m256i *>(words) + i);
+    }
+    __m256i v[8];
+    for (size_t i = 0; i < 8; ++i)
+    {
+        v[i] = _mm256_load_si256(reinterpret_cast<const __m256i *>(state) + i);
+    }
+    auto [a, b, c, d, e, f, g, h] = v;
+    for (size_t t = 0; t < 64; ++t)
+    {
+        auto &word = w[t % 16];
+        if (t >= 16)
+        {
+            const auto &w2 = w[(t + 14) % 16];
+            const auto &w15 = w[(t + 1) % 16];
+            const auto sigma1 = _mm256_xor_si256(_mm256_xor_si256(rotr_avx2<17>(w2), rotr_avx2<19>(w2)),
+                    _mm256_srli_epi32(w2, 10));
+            const auto sigma0 = _mm256_xor_si256(_mm256_xor_si256(rotr_avx2<7>(w15), rotr_avx2<18>(w15)),
+                    _mm256_srli_epi32(w15, 3));
+            word = _mm256_add_epi32(_mm256_add_epi32(word, sigma1), _mm256_add_epi32(w[(t + 9) % 16], sigma0));
+        }
+        const auto big_sigma1 = _mm256_xor_si256(_mm256_xor_si256(rotr_avx2<6>(e), rotr_avx2<11>(e)),
+                rotr_avx2<25>(e));
+        const auto ch = _mm256_xor_si256(_mm256_and_si256(e, f), _mm256_andnot_si256(e, g));
+        const auto t1 = _mm256_add_epi32(_mm256_add_epi32(_mm256_add_epi32(h, big_sigma1), _mm256_add_epi32(ch, word)),
+                _mm256_set1_epi32(static_cast<int>(round_constants[t])));
+        const auto big_sigma0 = _mm256_xor_si256(_mm256_xor_si256(rotr_avx2<2>(a), rotr_avx2<13>(a)),
+                rotr_avx2<22>(a));
+        const auto maj = _mm256_or_si256(_mm256_and_si256(a, b), _mm256_and_si256(c, _mm256_or_si256(a, b)));
+        h = g;
+        g = f;
+        f = e;
+        e = _mm256_add_epi32(d, t1);
+        d = c;
+        c = b;
+        b = a;
+        a = _mm256_add_epi32(t1, _mm256_add_epi32(big_sigma0, maj));
+    }
+    const __m256i result[8]{ a, b, c, d, e, f, g, h };
+    for (size_t i = 0; i < 8; ++i)
+    {
+        _mm256_store_si256(reinterpret_cast<__m256i *>(state) + i, _mm256_add_epi32(v[i], result[i]));
+    }
+}
+
+/**
+ * Zero masking forms with every lane selected compile to the plain instructions, the plain intrinsics make
+ * GCC 12 warn about their undefined pass-through operand.
+ */
+template<int bits>
+TLS_PLAYGROUND_TARGET("avx512f")
+inline __m512i rotr_avx512(__m512i x)
+{
+    return _mm512_maskz_ror_epi32(0xFFFF, x, bits);
+}
+
+template<int bits>
+TLS_PLAYGROUND_TARGET("avx512f")
+inline __m512i shr_avx512(__m512i x)
+{
+    return _mm512_maskz_srli_epi32(0xFFFF, x, bits);
+}
+
+/**
+ * AVX-512 has native rotations and three input logic, ch is 0xCA and maj is 0xE8 as truth tables of (x, y, z).
+ */
+TLS_PLAYGROUND_TARGET("avx512f")
+void sha256_compress_x16_avx512(uint32_t *state, const uint32_t *words, const uint32_t *round_constants)
+{
+    __m512i w[16];
+    for (size_t i = 0; i < 16; ++i)
+    {
+        w[i] = _mm512_load_si512(reinterpret_cast<const __m512i *>(words) + i);
+    }
+    __m512i v[8];
+    for (size_t i = 0; i < 8; ++i)
+    {
+        v[i] = _mm512_load_si512(reinterpret_cast<const __m512i *>(state) + i);
+    }
+    auto [a, b, c, d, e, f, g, h] = v;
+    for (size_t t = 0; t < 64; ++t)
+    {
+        auto &word = w[t % 16];
+        if (t >= 16)
+        {
+            const auto &w2 = w[(t + 14) % 16];
+            const auto &w15 = w[(t + 1) % 16];
+            const auto sigma1 = _mm512_ternarylogic_epi32(rotr_avx512<17>(w2), rotr_avx512<19>(w2),
+                    shr_avx512<10>(w2), 0x96);
+            const auto sigma0 = _mm512_ternarylogic_epi32(rotr_avx512<7>(w15), rotr_avx512<18>(w15),
+                    shr_avx512<3>(w15), 0x96);
+            word = _mm512_add_epi32(_mm512_add_epi32(word, sigma1), _mm512_add_epi32(w[(t + 9) % 16], sigma0));
+        }
+        const auto big_sigma1 = _mm512_ternarylogic_epi32(rotr_avx512<6>(e), rotr_avx512<11>(e),
+                rotr_avx512<25>(e), 0x96);
+        const auto ch = _mm512_ternarylogic_epi32(e, f, g, 0xCA);
+        const auto t1 = _mm512_add_epi32(_mm512_add_epi32(_mm512_add_epi32(h, big_sigma1), _mm512_add_epi32(ch, word)),
+                _mm512_set1_epi32(static_cast<int>(round_constants[t])));
+        const auto big_sigma0 = _mm512_ternarylogic_epi32(rotr_avx512<2>(a), rotr_avx512<13>(a),
+                rotr_avx512<22>(a), 0x96);
+        const auto maj = _mm512_ternarylogic_epi32(a, b, c, 0xE8);
+        h = g;
+        g = f;
+        f = e;
+        e = _mm512_add_epi32(d, t1);
+        d = c;
+        c = b;
+        b = a;
+        a = _mm512_add_epi32(t1, _mm512_add_epi32(big_sigma0, maj));
+    }
+    const __m512i result[8]{ a, b, c, d, e, f, g, h };
+    for (size_t i = 0; i < 8; ++i)
+    {
+        _mm512_store_si512(reinterpret_cast<__m512i *>(state) + i, _mm512_add_epi32(v[i], result[i]));
+    }
+}
+
+#else
+
+void sha256_compress_x4_sse2(uint32_t *, const uint32_t *, const uint32_t *)
+{
+    throw std::runtime_error("sse2 is not supported");
+}
+
+void sha256_compress_x8_avx2(uint32_t *, const uint32_t *, const uint32_t *)
+{
+    throw std::runtime_error("avx2 is not supported");
+}
+
+void sha256_compress_x16_avx512(uint32_t *, const uint32_t *, const uint32_t *)
+{
+    throw std::runtime_error("avx-512 is not supported");
+}
+
+#endif
@@ -0,0 +1,19 @@
+#ifndef TLS_PLAYGROUND_SHA256_MULTI_BUFFER_HPP
+#define TLS_PLAYGROUND_SHA256_MULTI_BUFFER_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Multi-buffer SHA-256 compression: one block of every lane per call. State and message words are transposed,
+ * word i of lane l is at [i * lanes + l], and both arrays must be aligned to the vector size.
+ * Callers must check cpu_features(), on other architectures every function throws.
+ */
+
+void sha256_compress_x4_sse2(uint32_t *state, const uint32_t *words, const uint32_t *round_constants);
+
+void sha256_compress_x8_avx2(uint32_t *state, const uint32_t *words, const uint32_t *round_constants);
+
+void sha256_compress_x16_avx512(uint32_t *state, const uint32_t *words, const uint32_t *round_constants);
+
+#endif //TLS_PLAYGROUND_SHA256_MULTI_BUFFER_HPP
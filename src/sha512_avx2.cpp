@@ -0,0 +1,55 @@
+#include <stdexcept>
+
+#include "cpu_features.hpp"
+
+#include "sha512_avx2.hpp"
+
+#if TLS_PLAYGROUND_X86
+
+#include <immintrin.h>
+
+template<int bits>
+TLS_PLAYGROUND_TARGET("avx2")
+inline __m128i rotr64(__m128i x)
+{
+    return _mm_or_si128(_mm_srli_epi64(x, bits), _mm_slli_epi64(x, 64 - bits));
+}
+
+TLS_PLAYGROUND_TARGET("avx2")
+void sha512_avx2_schedule(const unsigned char *block, const uint64_t *round_constants, uint64_t *schedule)
+{
+    const auto byte_order = _mm256_set_epi64x(0x08090a0b0c0d0e0fLL, 0x0001020304050607LL, 0x08090a0b0c0d0e0fLL,
+            0x0001020304050607LL);
+    for (size_t i = 0; i < 16; i += 4)
+    {
+        const auto words = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(block + 8 * i));
+        _mm256_store_si256(reinterpret_cast<__m256i *>(schedule + i), _mm256_shuffle_epi8(words, byte_order));
+    }
+    // word t depends on word t - 2, so two words per step is the widest dependency free width
+    for (size_t t = 16; t < 80; t += 2)
+    {
+        const auto w2 = _mm_load_si128(reinterpret_cast<const __m128i *>(schedule + t - 2));
+        const auto w7 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(schedule + t - 7));
+        const auto w15 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(schedule + t - 15));
+        const auto w16 = _mm_load_si128(reinterpret_cast<const __m128i *>(schedule + t - 16));
+        const auto sigma1 = _mm_xor_si128(_mm_xor_si128(rotr64<19>(w2), rotr64<61>(w2)), _mm_srli_epi64(w2, 6));
+        const auto sigma0 = _mm_xor_si128(_mm_xor_si128(rotr64<1>(w15), rotr64<8>(w15)), _mm_srli_epi64(w15, 7));
+        _mm_store_si128(reinterpret_cast<__m128i *>(schedule + t),
+                _mm_add_epi64(_mm_add_epi64(w16, sigma0), _mm_add_epi64(w7, sigma1)));
+    }
+    for (size_t t = 0; t < 80; t += 4)
+    {
+        auto *words = reinterpret_cast<__m256i *>(schedule + t);
+        const auto constants = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(round_constants + t));
+        _mm256_store_si256(words, _mm256_add_epi64(_mm256_load_si256(words), constants));
+    }
+}
+
+#else
+
+void sha512_avx2_schedule(const unsigned char *, const uint64_t *, uint64_t *)
+{
+    throw std::runtime_error("avx2 is not supported");
+}
+
+#endif
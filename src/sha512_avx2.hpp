@@ -0,0 +1,14 @@
+#ifndef TLS_PLAYGROUND_SHA512_AVX2_HPP
+#define TLS_PLAYGROUND_SHA512_AVX2_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * SHA-512 message schedule of one 128 byte block with AVX2: schedule receives all 80 message words with their
+ * round constants already added and must be aligned to 32 bytes. Callers must check cpu_features().avx2,
+ * on other architectures the function throws.
+ */
+void sha512_avx2_schedule(const unsigned char *block, const uint64_t *round_constants, uint64_t *schedule);
+
+#endif //TLS_PLAYGROUND_SHA512_AVX2_HPP
@@ -0,0 +1,163 @@
+#include <stdexcept>
+#include <utility>
+
+#include "cpu_features.hpp"
+
+#include "sha_ni.hpp"
+
+#if TLS_PLAYGROUND_X86
+
+#include <immintrin.h>
+
+alignas(16) const uint32_t sha256_ni_round_constants[64]{
+        0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+        0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+        0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+        0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+        0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+        0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+        0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+        0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+/**
+ * Four SHA-1 rounds of group 0..19. Message words live in a ring of 4 registers: group g uses message[g % 4]
+ * and schedules words of groups g + 1 and later, e alternates between two registers.
+ */
+template<size_t group>
+TLS_PLAYGROUND_TARGET("sha,sse4.1")
+inline void sha1_group(__m128i &abcd, __m128i (&e)[2], __m128i (&message)[4])
+{
+    auto &current = message[group % 4];
+    auto &round_e = e[group % 2];
+    if constexpr (group == 0)
+    {
+        round_e = _mm_add_epi32(round_e, current);
+    }
+    else
+    {
+        round_e = _mm_sha1nexte_epu32(round_e, current);
+    }
+    e[(group + 1) % 2] = abcd;
+    if constexpr (group >= 3 && group <= 18)
+    {
+        message[(group + 1) % 4] = _mm_sha1msg2_epu32(message[(group + 1) % 4], current);
+    }
+    abcd = _mm_sha1rnds4_epu32(abcd, round_e, group / 5);
+    if constexpr (group >= 1 && group <= 16)
+    {
+        message[(group + 3) % 4] = _mm_sha1msg1_epu32(message[(group + 3) % 4], current);
+    }
+    if constexpr (group >= 2 && group <= 17)
+    {
+        message[(group + 2) % 4] = _mm_xor_si128(message[(group + 2) % 4], current);
+    }
+}
+
+template<size_t... groups>
+TLS_PLAYGROUND_TARGET("sha,sse4.1")
+inline void sha1_groups(__m128i &abcd, __m128i (&e)[2], __m128i (&message)[4], std::index_sequence<groups...>)
+{
+    (sha1_group<groups>(abcd, e, message), ...);
+}
+
+TLS_PLAYGROUND_TARGET("sha,sse4.1")
+void sha_ni_sha1_compress(uint32_t *state, const unsigned char *blocks, size_t count)
+{
+    const auto byte_order = _mm_set_epi64x(0x0001020304050607ULL, 0x08090a0b0c0d0e0fULL);
+    auto abcd = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(state)), 0x1B);
+    auto state_e = _mm_set_epi32(static_cast<int>(state[4]), 0, 0, 0);
+    for (size_t block = 0; block < count; ++block)
+    {
+        const auto *input = reinterpret_cast<const __m128i *>(blocks + 64 * block);
+        __m128i message[4];
+        for (size_t i = 0; i < 4; ++i)
+        {
+            message[i] = _mm_shuffle_epi8(_mm_loadu_si128(input + i), byte_order);
+        }
+        const auto saved_abcd = abcd;
+        __m128i e[2]{ state_e, {} };
+        sha1_groups(abcd, e, message, std::make_index_sequence<20>());
+        // e[0] holds a before the last group, sha1nexte turns it into the final e
+        state_e = _mm_sha1nexte_epu32(e[0], state_e);
+        abcd = _mm_add_epi32(abcd, saved_abcd);
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(state), _mm_shuffle_epi32(abcd, 0x1B));
+    state[4] = static_cast<uint32_t>(_mm_extract_epi32(state_e, 3));
+}
+
+/**
+ * Next four schedule words from the previous sixteen, oldest register first.
+ */
+TLS_PLAYGROUND_TARGET("sha,sse4.1")
+inline __m128i sha256_schedule(__m128i first, __m128i second, __m128i third, __m128i fourth)
+{
+    const auto partial = _mm_add_epi32(_mm_sha256msg1_epu32(first, second), _mm_alignr_epi8(fourth, third, 4));
+    return _mm_sha256msg2_epu32(partial, fourth);
+}
+
+TLS_PLAYGROUND_TARGET("sha,sse4.1")
+inline void sha256_rounds(__m128i &abef, __m128i &cdgh, __m128i message, size_t group)
+{
+    auto words = _mm_add_epi32(message,
+            _mm_load_si128(reinterpret_cast<const __m128i *>(sha256_ni_round_constants + 4 * group)));
+    cdgh = _mm_sha256rnds2_epu32(cdgh, abef, words);
+    words = _mm_shuffle_epi32(words, 0x0E);
+    abef = _mm_sha256rnds2_epu32(abef, cdgh, words);
+}
+
+TLS_PLAYGROUND_TARGET("sha,sse4.1")
+void sha_ni_sha256_compress(uint32_t *state, const unsigned char *blocks, size_t count)
+{
+    const auto byte_order = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+    // rounds instructions keep the state as (a, b, e, f) and (c, d, g, h), highest lane first
+    const auto dcba = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(state)), 0xB1);
+    const auto efgh = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(state + 4)), 0x1B);
+    auto abef = _mm_alignr_epi8(dcba, efgh, 8);
+    auto cdgh = _mm_blend_epi16(efgh, dcba, 0xF0);
+    for (size_t block = 0; block < count; ++block)
+    {
+        const auto *input = reinterpret_cast<const __m128i *>(blocks + 64 * block);
+        auto message0 = _mm_shuffle_epi8(_mm_loadu_si128(input), byte_order);
+        auto message1 = _mm_shuffle_epi8(_mm_loadu_si128(input + 1), byte_order);
+        auto message2 = _mm_shuffle_epi8(_mm_loadu_si128(input + 2), byte_order);
+        auto message3 = _mm_shuffle_epi8(_mm_loadu_si128(input + 3), byte_order);
+        const auto saved_abef = abef;
+        const auto saved_cdgh = cdgh;
+        for (size_t group = 0; group < 12; group += 4)
+        {
+            sha256_rounds(abef, cdgh, message0, group);
+            message0 = sha256_schedule(message0, message1, message2, message3);
+            sha256_rounds(abef, cdgh, message1, group + 1);
+            message1 = sha256_schedule(message1, message2, message3, message0);
+            sha256_rounds(abef, cdgh, message2, group + 2);
+            message2 = sha256_schedule(message2, message3, message0, message1);
+            sha256_rounds(abef, cdgh, message3, group + 3);
+            message3 = sha256_schedule(message3, message0, message1, message2);
+        }
+        sha256_rounds(abef, cdgh, message0, 12);
+        sha256_rounds(abef, cdgh, message1, 13);
+        sha256_rounds(abef, cdgh, message2, 14);
+        sha256_rounds(abef, cdgh, message3, 15);
+        abef = _mm_add_epi32(abef, saved_abef);
+        cdgh = _mm_add_epi32(cdgh, saved_cdgh);
+    }
+    const auto feba = _mm_shuffle_epi32(abef, 0x1B);
+    const auto dchg = _mm_shuffle_epi32(cdgh, 0xB1);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(state), _mm_blend_epi16(feba, dchg, 0xF0));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(state + 4), _mm_alignr_epi8(dchg, feba, 8));
+}
+
+#else
+
+void sha_ni_sha1_compress(uint32_t *, const unsigned char *, size_t)
+{
+    throw std::runtime_error("sha extensions are not supported");
+}
+
+void sha_ni_sha256_compress(uint32_t *, const unsigned char *, size_t)
+{
+    throw std::runtime_error("sha extensions are not supported");
+}
+
+#endif
@@ -0,0 +1,16 @@
+#ifndef TLS_PLAYGROUND_SHA_NI_HPP
+#define TLS_PLAYGROUND_SHA_NI_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * SHA extensions backend. State words are in the order of the standard (a, b, c, ...), blocks are consecutive
+ * 64 byte message blocks. Callers must check cpu_features().sha, on other architectures every function throws.
+ */
+
+void sha_ni_sha1_compress(uint32_t *state, const unsigned char *blocks, size_t count);
+
+void sha_ni_sha256_compress(uint32_t *state, const unsigned char *blocks, size_t count);
+
+#endif //TLS_PLAYGROUND_SHA_NI_HPP
@@ -1,25 +1,32 @@
 #include <algorithm>
+#include <span>
 #include <string>
 
 #include "hmac.hpp"
 #include "tls_prf.hpp"
 
 
-void prf_hash(const std::vector<unsigned char> &secret, const std::vector<unsigned char> &seed, auto hmac_func,
+/**
+ * P_hash of the TLS 1.0 PRF. The key is the same for every HMAC, so it is hashed once for the whole output.
+ */
+template<typename Mac>
+void prf_hash(std::span<const unsigned char> secret, std::span<const unsigned char> seed,
         std::vector<unsigned char> &out)
 {
     size_t pos = 0;
-    auto pre_hash = hmac_func(seed, secret);
-    std::vector<unsigned char> buffer(pre_hash.size() + seed.size());
+    Mac hmac(secret);
+    hmac.update(seed);
+    auto pre_hash = hmac.final();
     while (pos < out.size())
     {
-        std::copy(pre_hash.begin(), pre_hash.end(), buffer.begin());
-        std::copy(seed.begin(), seed.end(), buffer.begin() + pre_hash.size());
-        const auto out_chunk = hmac_func(buffer, secret);
+        hmac.update(pre_hash);
+        hmac.update(seed);
+        const auto out_chunk = hmac.final();
         const auto copy = std::min(out.size() - pos, out_chunk.size());
         std::copy_n(out_chunk.begin(), copy, out.begin() + pos);
         pos += copy;
-        pre_hash = hmac_func({ pre_hash.begin(), pre_hash.end() }, secret);
+        hmac.update(pre_hash);
+        pre_hash = hmac.final();
     }
 }
 
@@ -28,9 +35,10 @@ void prf(const std::vector<unsigned char> &secret,
         const std::vector<unsigned char> &seed,
         std::vector<unsigned char> &out)
 {
-    prf_hash({ secret.begin(), secret.begin() + secret.size() / 2 }, seed, &hmac_md5, out);
+    const auto half = secret.size() / 2;
+    prf_hash<HmacMd5>(std::span(secret).first(half), seed, out);
     std::vector<unsigned char> sha_out(out.size());
-    prf_hash({ secret.begin() + secret.size() / 2, secret.end() }, seed, &hmac_sha1, sha_out);
+    prf_hash<HmacSha1>(std::span(secret).subspan(half), seed, sha_out);
     for (size_t i = 0; i < out.size(); ++i)
     {
         out[i] ^= sha_out.at(i);
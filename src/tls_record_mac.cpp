@@ -1,26 +1,36 @@
 #include <algorithm>
 #include <iterator>
+#include <span>
 #include <stdexcept>
 
-#include "hmac.hpp"
-
 #include "tls_record_mac.hpp"
 
-TlsRecordMac::TlsRecordMac(const std::vector<unsigned char> &secret) : secret(secret)
+TlsRecordMac::TlsRecordMac(const std::vector<unsigned char> &secret) : hmac(secret)
 {
 
 }
 
-void TlsRecordMac::append_mac(TlsRecord &record)
+std::array<unsigned char, 20> TlsRecordMac::compute_mac(const TlsRecord &record, size_t payload_size)
 {
-    std::vector<unsigned char> buffer{};
+    std::array<unsigned char, 13> header{};
     for (int i = 0; i < 8; ++i)
     {
-        buffer.push_back(sequence_number >> (8 * (7 - i)) & 0xFF);
+        header[i] = sequence_number >> (8 * (7 - i)) & 0xFF;
     }
-    record.write_to(std::back_inserter(buffer));
-    const auto mac = hmac_sha1(buffer, secret);
-    std::copy(mac.begin(), mac.end(), std::back_inserter(record.payload));
+    header[8] = static_cast<unsigned char>(record.content_type);
+    header[9] = record.protocol_version.major;
+    header[10] = record.protocol_version.minor;
+    header[11] = (payload_size >> 8) & 0xFF;
+    header[12] = payload_size & 0xFF;
+    hmac.update(header);
+    hmac.update(std::span(record.payload).first(payload_size));
+    return hmac.final();
+}
+
+void TlsRecordMac::append_mac(TlsRecord &record)
+{
+    const auto mac = compute_mac(record, record.payload.size());
+    record.payload.insert(record.payload.end(), mac.begin(), mac.end());
     ++sequence_number;
 }
 
@@ -30,25 +40,13 @@ void TlsRecordMac::verify_and_clear_mac(TlsRecord &record)
     {
         throw std::runtime_error("tls error: bad record mac length");
     }
-    std::array<unsigned char, 20> mac{};
-    std::copy(record.payload.end() - 20, record.payload.end(), mac.begin());
-
-    std::vector<unsigned char> buffer{};
-    for (int i = 0; i < 8; ++i)
-    {
-        buffer.push_back(sequence_number >> (8 * (7 - i)) & 0xFF);
-    }
-    buffer.push_back(static_cast<char>(record.content_type));
-    buffer.push_back(record.protocol_version.major);
-    buffer.push_back(record.protocol_version.minor);
-    buffer.push_back(static_cast<char>(((record.payload.size() - 20) >> 8) & 0xFF));
-    buffer.push_back(static_cast<char>(((record.payload.size() - 20) >> 0) & 0xFF));
-    std::copy(record.payload.begin(), record.payload.end() - 20, std::back_inserter(buffer));
-    if (hmac_sha1(buffer, secret) != mac)
+    const auto payload_size = record.payload.size() - 20;
+    const auto mac = compute_mac(record, payload_size);
+    if (!std::equal(mac.begin(), mac.end(), record.payload.begin() + payload_size))
     {
         throw std::runtime_error("tls error: bad record mac signature");
     }
-    record.payload.resize(record.payload.size() - 20);
+    record.payload.resize(payload_size);
     ++sequence_number;
 }
 
@@ -63,13 +61,3 @@ std::vector<char> TlsRecord::serialise() const
     std::copy(payload.begin(), payload.end(), std::back_inserter(result));
     return result;
 }
-
-void TlsRecord::write_to(auto begin) const
-{
-    *begin++ = static_cast<char>(content_type);
-    *begin++ = protocol_version.major;
-    *begin++ = protocol_version.minor;
-    *begin++ = static_cast<char>((payload.size() >> 8) & 0xFF);
-    *begin++ = static_cast<char>((payload.size() >> 0) & 0xFF);
-    std::copy(payload.begin(), payload.end(), begin);
-}
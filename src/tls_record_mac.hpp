@@ -1,9 +1,12 @@
 #ifndef TLS_PLAYGROUND_TLS_RECORD_MAC_HPP
 #define TLS_PLAYGROUND_TLS_RECORD_MAC_HPP
 
+#include <array>
 #include <cstdint>
 #include <vector>
 
+#include "hmac.hpp"
+
 struct ProtocolVersion
 {
     char major, minor;
@@ -29,14 +32,17 @@ struct TlsRecord
 
     [[nodiscard]]
     std::vector<char> serialise() const;
-
-    void write_to(auto begin) const;
 };
 
 class TlsRecordMac
 {
     uint64_t sequence_number{};
-    std::vector<unsigned char> secret;
+    HmacSha1 hmac;
+
+    /**
+     * MAC over sequence number, record header with the given payload length and payload, without copying it.
+     */
+    std::array<unsigned char, 20> compute_mac(const TlsRecord &record, size_t payload_size);
 public:
     explicit TlsRecordMac(const std::vector<unsigned char> &secret);
 
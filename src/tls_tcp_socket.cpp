@@ -2,10 +2,8 @@
 #include <array>
 #include <chrono>
 #include <iostream>
-#include <variant>
 
 #include "aes.hpp"
-#include "asn1.hpp"
 #include "rsa.hpp"
 #include "sha.hpp"
 #include "tls_prf.hpp"
@@ -205,21 +203,8 @@ HandshakeMessage build_key_exchange_payload(
     {
         throw std::runtime_error("tls error: unexpected server public key algorithm");
     }
-    const auto key_asn = parse_asn1(certificate.tbs_certificate.subject_public_key.key);
-    if (!std::holds_alternative<std::vector<Asn1>>(key_asn.data))
-    {
-        throw std::runtime_error("tls error: malformed public key");
-    }
-    const auto modulus_exp = std::get<std::vector<Asn1>>(key_asn.data);
-    if (modulus_exp.size() != 2
-        || !std::holds_alternative<BigNumber>(modulus_exp.at(0).data)
-        || !std::holds_alternative<BigNumber>(modulus_exp.at(1).data))
-    {
-        throw std::runtime_error("tls error: malformed public key structure");
-    }
-    const auto premaster_encrypted = rsa_encrypt({ premaster_key.begin(), premaster_key.end() },
-            std::get<BigNumber>(modulus_exp[1].data),
-            std::get<BigNumber>(modulus_exp[0].data));
+    const auto public_key = RsaPublicKeyCache::instance().get(certificate.tbs_certificate.subject_public_key.key);
+    const auto premaster_encrypted = rsa_encrypt({ premaster_key.begin(), premaster_key.end() }, *public_key);
     return HandshakeClientKeyExchangePayload{ premaster_encrypted }.to_handshake_message();
 }
 
@@ -227,39 +212,90 @@ struct CipherKeys
 {
     std::vector<unsigned char> client_mac_secret;
     std::vector<unsigned char> server_mac_secret;
-    std::array<unsigned char, 16> client_key;
-    std::array<unsigned char, 16> server_key;
-    std::array<unsigned char, 16> client_iv;
-    std::array<unsigned char, 16> server_iv;
+    std::vector<unsigned char> client_key;
+    std::vector<unsigned char> server_key;
+    std::vector<unsigned char> client_iv;
+    std::vector<unsigned char> server_iv;
 };
 
+/**
+ * Key material sizes of the supported suites, MAC is always HMAC-SHA1.
+ */
+struct CipherKeySizes
+{
+    size_t key_size;
+    size_t iv_size;
+};
+
+CipherKeySizes cipher_key_sizes(CipherSuiteType type)
+{
+    switch (type)
+    {
+    case CipherSuiteType::TLS_RSA_WITH_AES_128_CBC_SHA:
+        return { 16, 16 };
+    case CipherSuiteType::TLS_RSA_WITH_3DES_EDE_CBC_SHA:
+        return { 24, 8 };
+    case CipherSuiteType::TLS_RSA_WITH_DES_CBC_SHA:
+        return { 8, 8 };
+    default:
+        throw std::runtime_error("tls error: unexpected cipher suite requested");
+    }
+}
+
 CipherKeys compute_cipher_keys(
         const std::vector<unsigned char> &master_secret,
         const std::array<unsigned char, 32> &client_random,
-        const std::array<unsigned char, 32> server_random)
+        const std::array<unsigned char, 32> server_random,
+        CipherKeySizes sizes)
 {
-    int key_size = 20 * 2 + 16 * 2 + 16 * 2;
+    const size_t mac_size = 20;
+    const size_t key_size = mac_size * 2 + sizes.key_size * 2 + sizes.iv_size * 2;
     const auto keys = compute_key_expansion(master_secret, client_random, server_random, key_size);
-    std::vector<unsigned char> client_mac_secret(20);
-    std::copy_n(keys.begin(), client_mac_secret.size(), client_mac_secret.begin());
-    std::vector<unsigned char> server_mac_secret(20);
-    std::copy_n(keys.begin() + 20, server_mac_secret.size(), server_mac_secret.begin());
-    std::array<unsigned char, 16> client_key{};
-    std::copy_n(keys.begin() + 40, client_key.size(), client_key.begin());
-    std::array<unsigned char, 16> server_key{};
-    std::copy_n(keys.begin() + 56, server_key.size(), server_key.begin());
-    std::array<unsigned char, 16> client_iv{};
-    std::copy_n(keys.begin() + 72, client_iv.size(), client_iv.begin());
-    std::array<unsigned char, 16> server_iv{};
-    std::copy_n(keys.begin() + 88, server_iv.size(), server_iv.begin());
-    return {
-            client_mac_secret,
-            server_mac_secret,
-            client_key,
-            server_key,
-            client_iv,
-            server_iv,
+    auto position = keys.begin();
+    const auto take = [&position](size_t size)
+    {
+        std::vector<unsigned char> result(position, position + static_cast<std::ptrdiff_t>(size));
+        position += static_cast<std::ptrdiff_t>(size);
+        return result;
     };
+    // take() consumes the key block in the order fixed by RFC 2246 6.3
+    CipherKeys result{};
+    result.client_mac_secret = take(mac_size);
+    result.server_mac_secret = take(mac_size);
+    result.client_key = take(sizes.key_size);
+    result.server_key = take(sizes.key_size);
+    result.client_iv = take(sizes.iv_size);
+    result.server_iv = take(sizes.iv_size);
+    return result;
+}
+
+template<size_t size>
+std::array<unsigned char, size> to_array(const std::vector<unsigned char> &bytes)
+{
+    if (bytes.size() != size)
+    {
+        throw std::runtime_error("tls error: unexpected key material size");
+    }
+    std::array<unsigned char, size> result{};
+    std::copy_n(bytes.begin(), size, result.begin());
+    return result;
+}
+
+std::unique_ptr<CipherSuite> make_cipher_suite(CipherSuiteType type,
+        const std::vector<unsigned char> &key,
+        const std::vector<unsigned char> &iv)
+{
+    switch (type)
+    {
+    case CipherSuiteType::TLS_RSA_WITH_AES_128_CBC_SHA:
+        return std::make_unique<Aes128CipherSuite>(to_array<16>(iv), to_array<16>(key));
+    case CipherSuiteType::TLS_RSA_WITH_3DES_EDE_CBC_SHA:
+        return std::make_unique<TripleDesCipherSuite>(to_array<8>(iv), to_array<24>(key));
+    case CipherSuiteType::TLS_RSA_WITH_DES_CBC_SHA:
+        return std::make_unique<DesCipherSuite>(to_array<8>(iv), to_array<8>(key));
+    default:
+        throw std::runtime_error("tls error: unexpected cipher suite requested");
+    }
 }
 
 std::vector<HandshakeMessage> parse_server_handshake(const TlsRecord &record, HandshakeHashing &handshake_hashing)
@@ -343,76 +379,69 @@ void TlsTcpSocket::connect(const Uri &uri)
         {
             throw std::runtime_error("tls error: malformed server hello");
         }
-        switch (hello_reply.server_hello.cipher_suite_type)
-        {
-        case CipherSuiteType::TLS_RSA_WITH_AES_128_CBC_SHA:
+        const auto cipher_suite_type = hello_reply.server_hello.cipher_suite_type;
+        const auto key_sizes = cipher_key_sizes(cipher_suite_type);
+        std::array<unsigned char, 48> premaster_secret{ 3, 1, 33 };
+
+        send_tls_record({
+                TlsRecordType::Handshake,
+                tls1_0_version,
+                build_key_exchange_payload(hello_reply.certificate_chain.at(0), premaster_secret).serialise()
+        });
+        send_tls_record({
+                TlsRecordType::ChangeCipherSpec,
+                tls1_0_version,
+                { 1 }
+        });
+
+        const auto master_secret = compute_master_secret(premaster_secret, client_hello.random_bytes,
+                hello_reply.server_hello.random);
+        const auto cipher_keys = compute_cipher_keys(master_secret, client_hello.random_bytes,
+                hello_reply.server_hello.random, key_sizes);
+
+        send_record_mac = TlsRecordMac{ cipher_keys.client_mac_secret };
+        send_cipher_suite = make_cipher_suite(cipher_suite_type, cipher_keys.client_key, cipher_keys.client_iv);
+
+        const auto client_finished_message = HandshakeMessage{
+                HandshakeMessageType::Finished,
+                handshake_hashing.compute_finished_hash(master_secret, "client finished")
+        };
+
+        send_tls_record({
+                TlsRecordType::Handshake,
+                tls1_0_version,
+                client_finished_message.serialise()
+        });
+
+        auto record = read_tls_record();
+        if (record.content_type == TlsRecordType::ChangeCipherSpec)
         {
-            std::array<unsigned char, 48> premaster_secret{ 3, 1, 33 };
-
-            send_tls_record({
-                    TlsRecordType::Handshake,
-                    tls1_0_version,
-                    build_key_exchange_payload(hello_reply.certificate_chain.at(0), premaster_secret).serialise()
-            });
-            send_tls_record({
-                    TlsRecordType::ChangeCipherSpec,
-                    tls1_0_version,
-                    { 1 }
-            });
-
-            const auto master_secret = compute_master_secret(premaster_secret, client_hello.random_bytes,
-                    hello_reply.server_hello.random);
-            const auto cipher_keys = compute_cipher_keys(master_secret, client_hello.random_bytes,
-                    hello_reply.server_hello.random);
-
-            send_record_mac = TlsRecordMac{ cipher_keys.client_mac_secret };
-            send_cipher_suite = std::make_unique<Aes128CipherSuite>(cipher_keys.client_iv, cipher_keys.client_key);
-
-            const auto client_finished_message = HandshakeMessage{
-                    HandshakeMessageType::Finished,
-                    handshake_hashing.compute_finished_hash(master_secret, "client finished")
-            };
-
-            send_tls_record({
-                    TlsRecordType::Handshake,
-                    tls1_0_version,
-                    client_finished_message.serialise()
-            });
-
-            auto record = read_tls_record();
-            if (record.content_type == TlsRecordType::ChangeCipherSpec)
+            if (record.payload != std::vector<unsigned char>{ 1 })
             {
-                if (record.payload != std::vector<unsigned char>{ 1 })
-                {
-                    throw std::runtime_error("tls error: unexpected server change cipher message");
-                }
+                throw std::runtime_error("tls error: unexpected server change cipher message");
             }
-            else
-            {
-                throw std::runtime_error("tls error: server change cipher expected");
-            }
-            receive_record_mac = TlsRecordMac{ cipher_keys.server_mac_secret };
-            receive_cipher_suite = std::make_unique<Aes128CipherSuite>(cipher_keys.server_iv, cipher_keys.server_key);
-            record = read_tls_record();
-            const auto expected_mac = handshake_hashing.compute_finished_hash(master_secret, "server finished");
-            const auto server_finished = parse_server_handshake(record, handshake_hashing);
-            if (server_finished.size() != 1 || server_finished[0].type != HandshakeMessageType::Finished)
-            {
-                throw std::runtime_error("tls error: server finished expected");
-            }
-            if (record.payload.size() != 4 + expected_mac.size() ||
-                static_cast<HandshakeMessageType>(record.payload[0]) != HandshakeMessageType::Finished)
-            {
-                throw std::runtime_error("tls error: malformed server finished message");
-            }
-            if (expected_mac != server_finished[0].payload)
-            {
-                throw std::runtime_error("tls error: verify data missmatch");
-            }
-            break;
         }
-        default:
-            throw std::runtime_error("tls error: unexpected cipher suite requested");
+        else
+        {
+            throw std::runtime_error("tls error: server change cipher expected");
+        }
+        receive_record_mac = TlsRecordMac{ cipher_keys.server_mac_secret };
+        receive_cipher_suite = make_cipher_suite(cipher_suite_type, cipher_keys.server_key, cipher_keys.server_iv);
+        record = read_tls_record();
+        const auto expected_mac = handshake_hashing.compute_finished_hash(master_secret, "server finished");
+        const auto server_finished = parse_server_handshake(record, handshake_hashing);
+        if (server_finished.size() != 1 || server_finished[0].type != HandshakeMessageType::Finished)
+        {
+            throw std::runtime_error("tls error: server finished expected");
+        }
+        if (record.payload.size() != 4 + expected_mac.size() ||
+            static_cast<HandshakeMessageType>(record.payload[0]) != HandshakeMessageType::Finished)
+        {
+            throw std::runtime_error("tls error: malformed server finished message");
+        }
+        if (expected_mac != server_finished[0].payload)
+        {
+            throw std::runtime_error("tls error: verify data missmatch");
         }
     }
     catch (const std::runtime_error &e)
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <array>
 
 #include <catch2/catch_test_macros.hpp>
@@ -5,6 +6,7 @@
 
 #include "utils.hpp"
 #include "aes.hpp"
+#include "cpu_features.hpp"
 
 TEST_CASE("aes128_cbc")
 {
@@ -69,3 +71,259 @@ TEST_CASE("aes256_cbc")
 
     REQUIRE(aes256_cbc_decrypt(aes256_cbc_encrypt(task, iv, key), iv, key) == task);
 }
+
+
+TEST_CASE("aes known answer")
+{
+    // FIPS-197 appendix C, single block with zero iv
+    const std::vector<unsigned char> input{ 0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77,
+                                            0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff };
+    const std::array<unsigned char, 16> iv{};
+    std::array<unsigned char, 32> key{};
+    for (size_t i = 0; i < key.size(); ++i)
+    {
+        key[i] = i;
+    }
+    std::array<unsigned char, 16> key128{};
+    std::array<unsigned char, 24> key192{};
+    std::copy_n(key.begin(), key128.size(), key128.begin());
+    std::copy_n(key.begin(), key192.size(), key192.begin());
+
+    const auto result128 = aes128_cbc_encrypt(input, iv, key128);
+    REQUIRE(hexStr(result128.begin(), result128.end()) == "69c4e0d86a7b0430d8cdb78070b4c55a");
+    REQUIRE(aes128_cbc_decrypt(result128, iv, key128) == input);
+    const auto result192 = aes192_cbc_encrypt(input, iv, key192);
+    REQUIRE(hexStr(result192.begin(), result192.end()) == "dda97ca4864cdfe06eaf70a0ec0d7191");
+    REQUIRE(aes192_cbc_decrypt(result192, iv, key192) == input);
+    const auto result256 = aes256_cbc_encrypt(input, iv, key);
+    REQUIRE(hexStr(result256.begin(), result256.end()) == "8ea2b7ca516745bfeafc49904b496089");
+    REQUIRE(aes256_cbc_decrypt(result256, iv, key) == input);
+}
+
+TEST_CASE("aes hardware and portable implementations agree")
+{
+    const CpuFeaturesGuard guard;
+    std::vector<unsigned char> input(16 * 33);
+    for (size_t i = 0; i < input.size(); ++i)
+    {
+        input[i] = (i * 7 + 3) & 0xFF;
+    }
+    const std::array<unsigned char, 16> iv{ 0x63, 0x7c, 0x77, 0x7b, 0xf2, 0x6b, 0x6f, 0xc5,
+                                            0x30, 0x01, 0x67, 0x2b, 0xfe, 0xd7, 0xab, 0x76 };
+    std::array<unsigned char, 32> key{};
+    for (size_t i = 0; i < key.size(); ++i)
+    {
+        key[i] = (i * 13 + 5) & 0xFF;
+    }
+    std::array<unsigned char, 24> key192{};
+    std::copy_n(key.begin(), key192.size(), key192.begin());
+
+    const auto hardware128 = aes128_cbc_encrypt(input, iv, iv);
+    const auto hardware192 = aes192_cbc_encrypt(input, iv, key192);
+    const auto hardware256 = aes256_cbc_encrypt(input, iv, key);
+    cpu_features().aes = false;
+    const auto portable128 = aes128_cbc_encrypt(input, iv, iv);
+    const auto portable192 = aes192_cbc_encrypt(input, iv, key192);
+    const auto portable256 = aes256_cbc_encrypt(input, iv, key);
+    const auto decrypted256 = aes256_cbc_decrypt(hardware256, iv, key);
+
+    REQUIRE(hardware128 == portable128);
+    REQUIRE(hardware192 == portable192);
+    REQUIRE(hardware256 == portable256);
+    REQUIRE(decrypted256 == input);
+    REQUIRE(aes128_cbc_decrypt(portable128, iv, iv) == input);
+    REQUIRE(aes192_cbc_decrypt(portable192, iv, key192) == input);
+}
+
+TEST_CASE("aes key reuse")
+{
+    const std::array<unsigned char, 16> iv{ 0x02, 0xf0, 0x73, 0x49, 0xdd, 0x84, 0x4e, 0xf8, 0x2f, 0x4a, 0xea, 0xb4,
+                                            0x73, 0x4a, 0xce, 0x34 };
+    const std::array<unsigned char, 16> raw_key{ 0xd6, 0x91, 0xb0, 0x1f, 0xd8, 0x5f, 0xa1, 0x93, 0x5c, 0xc6, 0x35,
+                                                 0x88, 0x06, 0x50, 0x29, 0x1c };
+    const AesKey<128> key(raw_key);
+    for (size_t size = 16; size <= 64; size += 16)
+    {
+        const std::vector<unsigned char> input(size, static_cast<unsigned char>(size));
+        const auto result = aes_cbc_encrypt(input, iv, key);
+        REQUIRE(result == aes128_cbc_encrypt(input, iv, raw_key));
+        REQUIRE(aes_cbc_decrypt(result, iv, key) == input);
+    }
+}
+
+TEST_CASE("aes cbc decrypt large buffer")
+{
+    std::vector<unsigned char> input(16 * 65537 + 16 * 5);
+    for (size_t i = 0; i < input.size(); ++i)
+    {
+        input[i] = (i * 31 + (i >> 8)) & 0xFF;
+    }
+    const std::array<unsigned char, 16> iv{ 0x63, 0x7c, 0x77, 0x7b, 0xf2, 0x6b, 0x6f, 0xc5,
+                                            0x30, 0x01, 0x67, 0x2b, 0xfe, 0xd7, 0xab, 0x76 };
+    const AesKey<256> key(std::array<unsigned char, 32>{ 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16 });
+    const auto cypher_data = aes_cbc_encrypt(input, iv, key);
+    const CpuFeaturesGuard guard;
+    const auto single = aes_cbc_decrypt(cypher_data, iv, key);
+    const auto parallel = aes_cbc_decrypt(cypher_data, iv, key, 4);
+    cpu_features().aes = false;
+    const auto portable = aes_cbc_decrypt(cypher_data, iv, key, 3);
+
+    REQUIRE(single == input);
+    REQUIRE(parallel == input);
+    REQUIRE(portable == input);
+}
+
+TEST_CASE("aes cbc encrypt many")
+{
+    const auto hardware_aes = GENERATE(false, true);
+    const CpuFeaturesGuard guard;
+    cpu_features().aes = cpu_features().aes && hardware_aes;
+
+    std::vector<AesKey<128>> keys;
+    std::vector<std::vector<unsigned char>> buffers;
+    std::vector<AesCbcJob<128>> jobs;
+    std::vector<std::vector<unsigned char>> expected;
+    std::vector<std::array<unsigned char, 16>> ivs;
+    keys.reserve(11);
+    buffers.reserve(11);
+    for (size_t i = 0; i < 11; ++i)
+    {
+        std::array<unsigned char, 16> key{};
+        std::array<unsigned char, 16> iv{};
+        for (size_t j = 0; j < 16; ++j)
+        {
+            key[j] = (i * 17 + j) & 0xFF;
+            iv[j] = (i * 5 + j * 3) & 0xFF;
+        }
+        keys.emplace_back(key);
+        // different lengths, including empty one, so lanes finish at different steps
+        buffers.emplace_back(16 * ((i * 7) % 12), static_cast<unsigned char>(i));
+        expected.push_back(aes128_cbc_encrypt(buffers.back(), iv, key));
+        ivs.push_back(expected.back().empty() ? iv : std::array<unsigned char, 16>{});
+        if (!expected.back().empty())
+        {
+            std::copy_n(expected.back().end() - 16, 16, ivs.back().begin());
+        }
+        jobs.push_back({ &keys.back(), iv, buffers.back() });
+    }
+    aes_cbc_encrypt_many(jobs);
+
+    for (size_t i = 0; i < jobs.size(); ++i)
+    {
+        REQUIRE(buffers[i] == expected[i]);
+        REQUIRE(jobs[i].iv == ivs[i]);
+    }
+}
+
+TEST_CASE("aes ctr")
+{
+    const auto hardware_aes = GENERATE(false, true);
+    const CpuFeaturesGuard guard;
+    cpu_features().aes = cpu_features().aes && hardware_aes;
+
+    // NIST SP 800-38A F.5.1, counter wraps its low byte in the third block
+    const AesKey<128> key(std::array<unsigned char, 16>{ 0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6,
+                                                         0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c });
+    const std::array<unsigned char, 16> counter{ 0xf0, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7,
+                                                 0xf8, 0xf9, 0xfa, 0xfb, 0xfc, 0xfd, 0xfe, 0xff };
+    const std::vector<unsigned char> input{
+            0x6b, 0xc1, 0xbe, 0xe2, 0x2e, 0x40, 0x9f, 0x96, 0xe9, 0x3d, 0x7e, 0x11, 0x73, 0x93, 0x17, 0x2a,
+            0xae, 0x2d, 0x8a, 0x57, 0x1e, 0x03, 0xac, 0x9c, 0x9e, 0xb7, 0x6f, 0xac, 0x45, 0xaf, 0x8e, 0x51,
+            0x30, 0xc8, 0x1c, 0x46, 0xa3, 0x5c, 0xe4, 0x11, 0xe5, 0xfb, 0xc1, 0x19, 0x1a, 0x0a, 0x52, 0xef,
+            0xf6, 0x9f, 0x24, 0x45, 0xdf, 0x4f, 0x9b, 0x17, 0xad, 0x2b, 0x41, 0x7b, 0xe6, 0x6c, 0x37, 0x10 };
+    const auto result = aes_ctr_crypt(input, counter, key);
+    REQUIRE(hexStr(result.begin(), result.end()) ==
+            "874d6191b620e3261bef6864990db6ce9806f66b7970fdff8617187bb9fffdff"
+            "5ae4df3edbd5d35e5b4f09020db03eab1e031dda2fbe03d1792170a0f3009cee");
+    REQUIRE(aes_ctr_crypt(result, counter, key) == input);
+
+    // seek into the middle of the stream, including offsets inside a block
+    for (size_t offset: { 5, 16, 21, 40 })
+    {
+        const std::vector<unsigned char> tail(input.begin() + offset, input.end());
+        const auto part = aes_ctr_crypt(tail, counter, key, offset);
+        REQUIRE(std::equal(part.begin(), part.end(), result.begin() + offset));
+    }
+
+    std::vector<unsigned char> large(16 * 65536 + 7);
+    for (size_t i = 0; i < large.size(); ++i)
+    {
+        large[i] = (i * 31 + (i >> 8)) & 0xFF;
+    }
+    REQUIRE(aes_ctr_crypt(large, counter, key, 3, 4) == aes_ctr_crypt(large, counter, key, 3));
+}
+
+TEST_CASE("aes in place")
+{
+    std::vector<unsigned char> input(16 * 70000);
+    for (size_t i = 0; i < input.size(); ++i)
+    {
+        input[i] = (i * 11 + (i >> 10)) & 0xFF;
+    }
+    const std::array<unsigned char, 16> iv{ 0x63, 0x7c, 0x77, 0x7b, 0xf2, 0x6b, 0x6f, 0xc5,
+                                            0x30, 0x01, 0x67, 0x2b, 0xfe, 0xd7, 0xab, 0x76 };
+    const AesKey<192> key(std::array<unsigned char, 24>{ 9, 8, 7, 6, 5, 4, 3, 2, 1 });
+    const auto expected = aes_cbc_encrypt(input, iv, key);
+
+    auto buffer = input;
+    aes_cbc_encrypt(std::span(buffer), std::span(buffer), iv, key);
+    REQUIRE(buffer == expected);
+    aes_cbc_decrypt(std::span(buffer), std::span(buffer), iv, key, 4);
+    REQUIRE(buffer == input);
+    aes_ctr_crypt(std::span(buffer), std::span(buffer), iv, key, 0, 4);
+    REQUIRE(buffer == aes_ctr_crypt(input, iv, key));
+
+    std::vector<unsigned char> small(32);
+    REQUIRE_THROWS_AS(aes_cbc_encrypt(std::span(input), std::span(small), iv, key), std::runtime_error);
+}
+
+TEST_CASE("aes bitsliced fallback")
+{
+    const CpuFeaturesGuard guard;
+    cpu_features().aes = false;
+
+    std::vector<unsigned char> input(16 * 37);
+    for (size_t i = 0; i < input.size(); ++i)
+    {
+        input[i] = (i * 29 + (i >> 4)) & 0xFF;
+    }
+    const std::array<unsigned char, 16> iv{ 0xf0, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7,
+                                            0xf8, 0xf9, 0xfa, 0xfb, 0xfc, 0xfd, 0xfe, 0xff };
+    std::array<unsigned char, 32> key{};
+    for (size_t i = 0; i < key.size(); ++i)
+    {
+        key[i] = (i * 17 + 1) & 0xFF;
+    }
+    std::array<unsigned char, 16> key128{};
+    std::array<unsigned char, 24> key192{};
+    std::copy_n(key.begin(), key128.size(), key128.begin());
+    std::copy_n(key.begin(), key192.size(), key192.begin());
+
+    const AesKey<128> table128(key128);
+    const AesKey<192> table192(key192);
+    const AesKey<256> table256(key);
+    const auto encrypted128 = aes_cbc_encrypt(input, iv, table128);
+    const auto encrypted192 = aes_cbc_encrypt(input, iv, table192);
+    const auto encrypted256 = aes_cbc_encrypt(input, iv, table256);
+    const auto stream256 = aes_ctr_crypt(input, iv, table256, 9);
+
+    aes_fallback() = AesFallback::Bitsliced;
+    const AesKey<128> bitsliced128(key128);
+    const AesKey<192> bitsliced192(key192);
+    const AesKey<256> bitsliced256(key);
+    REQUIRE(bitsliced128.get_encrypt_key() == table128.get_encrypt_key());
+    REQUIRE(bitsliced128.get_decrypt_key() == table128.get_decrypt_key());
+    REQUIRE(bitsliced192.get_decrypt_key() == table192.get_decrypt_key());
+    REQUIRE(bitsliced256.get_decrypt_key() == table256.get_decrypt_key());
+    REQUIRE(aes_cbc_encrypt(input, iv, bitsliced128) == encrypted128);
+    REQUIRE(aes_cbc_encrypt(input, iv, bitsliced192) == encrypted192);
+    REQUIRE(aes_cbc_encrypt(input, iv, bitsliced256) == encrypted256);
+    REQUIRE(aes_cbc_decrypt(encrypted128, iv, bitsliced128) == input);
+    REQUIRE(aes_cbc_decrypt(encrypted192, iv, bitsliced192) == input);
+    REQUIRE(aes_cbc_decrypt(encrypted256, iv, bitsliced256, 3) == input);
+    REQUIRE(aes_ctr_crypt(input, iv, bitsliced256, 9) == stream256);
+
+    auto buffer = encrypted192;
+    aes_cbc_decrypt(std::span(buffer), std::span(buffer), iv, bitsliced192);
+    REQUIRE(buffer == input);
+}
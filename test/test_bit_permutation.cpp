@@ -0,0 +1,80 @@
+#include <algorithm>
+#include <array>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include "bit_permutation.hpp"
+#include "des.hpp"
+
+constexpr std::array<unsigned int, 64> initial_permute_table{
+        58, 50, 42, 34, 26, 18, 10, 2,
+        60, 52, 44, 36, 28, 20, 12, 4,
+        62, 54, 46, 38, 30, 22, 14, 6,
+        64, 56, 48, 40, 32, 24, 16, 8,
+        57, 49, 41, 33, 25, 17, 9, 1,
+        59, 51, 43, 35, 27, 19, 11, 3,
+        61, 53, 45, 37, 29, 21, 13, 5,
+        63, 55, 47, 39, 31, 23, 15, 7
+};
+
+constexpr std::array<unsigned int, 64> final_permute_table{
+        40, 8, 48, 16, 56, 24, 64, 32,
+        39, 7, 47, 15, 55, 23, 63, 31,
+        38, 6, 46, 14, 54, 22, 62, 30,
+        37, 5, 45, 13, 53, 21, 61, 29,
+        36, 4, 44, 12, 52, 20, 60, 28,
+        35, 3, 43, 11, 51, 19, 59, 27,
+        34, 2, 42, 10, 50, 18, 58, 26,
+        33, 1, 41, 9, 49, 17, 57, 25
+};
+
+constexpr std::array<unsigned int, 48> expansion_table{
+        32, 1, 2, 3, 4, 5, 4, 5, 6, 7, 8, 9,
+        8, 9, 10, 11, 12, 13, 12, 13, 14, 15, 16, 17,
+        16, 17, 18, 19, 20, 21, 20, 21, 22, 23, 24, 25,
+        24, 25, 26, 27, 28, 29, 28, 29, 30, 31, 32, 1
+};
+
+constexpr BytePermutation<8, 64> initial_permutation(initial_permute_table);
+constexpr BytePermutation<8, 64> final_permutation(final_permute_table);
+constexpr BytePermutation<4, 48> expansion(expansion_table);
+
+template<size_t len>
+uint64_t to_word(const std::array<unsigned char, len> &bytes)
+{
+    uint64_t result = 0;
+    for (const auto byte: bytes)
+    {
+        result = result << 8 | byte;
+    }
+    return result;
+}
+
+TEST_CASE("byte permutation matches bitwise permute")
+{
+    auto input = GENERATE(
+            std::array<unsigned char, 8>{ 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+            std::array<unsigned char, 8>{ 0x01, 0x23, 0x45, 0x67, 0x89, 0xab, 0xcd, 0xef },
+            std::array<unsigned char, 8>{ 0x50, 0x50, 0x50, 0x50, 0x50, 0x50, 0x50, 0x50 },
+            std::array<unsigned char, 8>{ 0xfe, 0xdc, 0xba, 0x98, 0x76, 0x54, 0x32, 0x10 }
+    );
+    std::array<unsigned char, 8> permuted{};
+    permute(permuted, input, initial_permute_table);
+    REQUIRE(initial_permutation(input) == to_word(permuted));
+    REQUIRE(initial_permutation(to_word(input)) == to_word(permuted));
+    REQUIRE(final_permutation(initial_permutation(input)) == to_word(input));
+
+    std::array<unsigned char, 4> half{};
+    std::copy_n(input.begin() + 4, half.size(), half.begin());
+    std::array<unsigned char, 6> expanded{};
+    permute(expanded, half, expansion_table);
+    REQUIRE(expansion(half) == to_word(expanded));
+}
+
+TEST_CASE("byte permutation at compile time")
+{
+    static_assert(initial_permutation(uint64_t{ 0x4040404040404040 }) == 0xFF00000000000000);
+    static_assert(expansion(uint64_t{ 0x80000001 }) == 0xC00000000003);
+    REQUIRE(initial_permutation(uint64_t{ 0x5050505050505050 }) == 0xFFFF000000000000);
+}
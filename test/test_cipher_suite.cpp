@@ -0,0 +1,81 @@
+#include <array>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "cipher_suite.hpp"
+
+TEST_CASE("aes128 cipher suite")
+{
+    const std::array<unsigned char, 16> iv{ 0x02, 0xf0, 0x73, 0x49, 0xdd, 0x84, 0x4e, 0xf8, 0x2f, 0x4a, 0xea, 0xb4,
+                                            0x73, 0x4a, 0xce, 0x34 };
+    const std::array<unsigned char, 16> key{ 0xd6, 0x91, 0xb0, 0x1f, 0xd8, 0x5f, 0xa1, 0x93, 0x5c, 0xc6, 0x35, 0x88,
+                                             0x06, 0x50, 0x29, 0x1c };
+    Aes128CipherSuite sender(iv, key);
+    Aes128CipherSuite receiver(iv, key);
+    // records chain through iv, so every record has to survive the round trip in order
+    for (size_t size: { 0, 1, 15, 16, 17, 100 })
+    {
+        std::vector<unsigned char> payload(size);
+        for (size_t i = 0; i < size; ++i)
+        {
+            payload[i] = (i * 3 + size) & 0xFF;
+        }
+        TlsRecord record{ TlsRecordType::ApplicationData, tls1_0_version, payload };
+        sender.encrypt(record);
+        REQUIRE(record.payload.size() % 16 == 0);
+        REQUIRE(record.payload.size() > size);
+        receiver.decrypt(record);
+        REQUIRE(record.payload == payload);
+    }
+
+    TlsRecord malformed{ TlsRecordType::ApplicationData, tls1_0_version, std::vector<unsigned char>(15) };
+    REQUIRE_THROWS_AS(receiver.decrypt(malformed), std::runtime_error);
+}
+
+template<typename Suite, size_t key_size>
+void check_des_suite_round_trip(const std::array<unsigned char, key_size> &key)
+{
+    const std::array<unsigned char, 8> iv{ 0x12, 0x34, 0x56, 0x78, 0x90, 0xab, 0xcd, 0xef };
+    Suite sender(iv, key);
+    Suite receiver(iv, key);
+    for (size_t size: { 0, 1, 7, 8, 9, 100 })
+    {
+        std::vector<unsigned char> payload(size);
+        for (size_t i = 0; i < size; ++i)
+        {
+            payload[i] = (i * 5 + size) & 0xFF;
+        }
+        TlsRecord record{ TlsRecordType::ApplicationData, tls1_0_version, payload };
+        sender.encrypt(record);
+        REQUIRE(record.payload.size() % 8 == 0);
+        REQUIRE(record.payload.size() > size);
+        receiver.decrypt(record);
+        REQUIRE(record.payload == payload);
+    }
+
+    TlsRecord malformed{ TlsRecordType::ApplicationData, tls1_0_version, std::vector<unsigned char>(12) };
+    REQUIRE_THROWS_AS(receiver.decrypt(malformed), std::runtime_error);
+}
+
+TEST_CASE("des cipher suites")
+{
+    const std::array<unsigned char, 24> triple_key{ 0x01, 0x23, 0x45, 0x67, 0x89, 0xab, 0xcd, 0xef, 0x23, 0x45, 0x67,
+                                                    0x89, 0xab, 0xcd, 0xef, 0x01, 0x45, 0x67, 0x89, 0xab, 0xcd, 0xef,
+                                                    0x01, 0x23 };
+    const std::array<unsigned char, 8> single_key{ 0x13, 0x34, 0x57, 0x79, 0x9b, 0xbc, 0xdf, 0xf1 };
+    check_des_suite_round_trip<TripleDesCipherSuite>(triple_key);
+    check_des_suite_round_trip<DesCipherSuite>(single_key);
+
+    // first record is plain CBC over payload and TLS padding, the second one chains from its last block
+    const std::array<unsigned char, 8> iv{ 1, 2, 3, 4, 5, 6, 7, 8 };
+    TripleDesCipherSuite suite(iv, triple_key);
+    TlsRecord first{ TlsRecordType::ApplicationData, tls1_0_version, { 'h', 'e', 'l', 'l', 'o' } };
+    TlsRecord second = first;
+    suite.encrypt(first);
+    suite.encrypt(second);
+    std::vector<unsigned char> plain{ 'h', 'e', 'l', 'l', 'o', 2, 2, 2, 'h', 'e', 'l', 'l', 'o', 2, 2, 2 };
+    std::vector<unsigned char> expected(plain.size());
+    des3_cbc_encrypt(plain, expected, triple_key, iv);
+    REQUIRE(first.payload == std::vector<unsigned char>(expected.begin(), expected.begin() + 8));
+    REQUIRE(second.payload == std::vector<unsigned char>(expected.begin() + 8, expected.end()));
+}
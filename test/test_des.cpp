@@ -1,9 +1,11 @@
+#include <string>
 #include <tuple>
 #include <vector>
 
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/generators/catch_generators.hpp>
 
+#include "utils.hpp"
 #include "des.hpp"
 
 
@@ -143,4 +145,159 @@ TEST_CASE("des3_cbc_pkcs5")
     const std::vector<unsigned char> encrypted = des3_cbc_pkcs5_encrypt(task, key, iv);
     const std::vector<unsigned char> decrypted = des3_cbc_pkcs5_decrypt(encrypted, key, iv);
     REQUIRE(decrypted == task);
-}
\ No newline at end of file
+}
+
+TEST_CASE("des known answer")
+{
+    const std::string text = "abcdefghijklmnopqrstuvwxyz012345";
+    const std::vector<unsigned char> input(text.begin(), text.end());
+    const auto iv = std::array<unsigned char, 8>{ 0xa, 0xb, 0xc, 0xd, 0xe, 0xf, 0x1a, 0x1b };
+
+    std::vector<unsigned char> block{ 0x01, 0x23, 0x45, 0x67, 0x89, 0xab, 0xcd, 0xef };
+    const auto ecb_key = std::array<unsigned char, 8>{ 0x13, 0x34, 0x57, 0x79, 0x9b, 0xbc, 0xdf, 0xf1 };
+    des_ecb_encrypt(std::span(block), std::span(block), ecb_key);
+    REQUIRE(hexStr(block.begin(), block.end()) == "85e813540f0ab405");
+    des_ecb_decrypt(std::span(block), std::span(block), ecb_key);
+    REQUIRE(hexStr(block.begin(), block.end()) == "0123456789abcdef");
+
+    auto buffer = input;
+    const auto key = std::array<unsigned char, 8>{ 1, 2, 3, 4, 5, 6, 7, 8 };
+    des_cbc_encrypt(std::span(buffer), std::span(buffer), key, iv);
+    REQUIRE(hexStr(buffer.begin(), buffer.end()) ==
+            "e8383803e3472e9703a3995635733a68cfd75689a9d8c43f2082cca685ff072b");
+    des_cbc_decrypt(std::span(buffer), std::span(buffer), key, iv);
+    REQUIRE(buffer == input);
+
+    const auto key3 = std::array<unsigned char, 24>{ 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18,
+                                                     19, 20, 21, 22, 23, 24 };
+    des3_cbc_encrypt(std::span(buffer), std::span(buffer), key3, iv);
+    REQUIRE(hexStr(buffer.begin(), buffer.end()) ==
+            "c02d3adbf2e8751c9de92f2a83363d94847731c634673f750a1cbab98238a63b");
+    des3_cbc_decrypt(std::span(buffer), std::span(buffer), key3, iv);
+    REQUIRE(buffer == input);
+
+    REQUIRE_THROWS_AS(des_cbc_encrypt(std::span(input).first(7), std::span(buffer).first(7), key, iv),
+            std::runtime_error);
+}
+
+TEST_CASE("des bitsliced ecb")
+{
+    std::vector<unsigned char> block{ 0x01, 0x23, 0x45, 0x67, 0x89, 0xab, 0xcd, 0xef };
+    const DesKey ecb_key(std::array<unsigned char, 8>{ 0x13, 0x34, 0x57, 0x79, 0x9b, 0xbc, 0xdf, 0xf1 });
+    des_ecb_encrypt_bitsliced(std::span(block), std::span(block), ecb_key);
+    REQUIRE(hexStr(block.begin(), block.end()) == "85e813540f0ab405");
+    des_ecb_decrypt_bitsliced(std::span(block), std::span(block), ecb_key);
+    REQUIRE(hexStr(block.begin(), block.end()) == "0123456789abcdef");
+
+    // more than one batch, the last one partial
+    std::vector<unsigned char> input(8 * 150);
+    for (size_t i = 0; i < input.size(); ++i)
+    {
+        input[i] = (i * 13 + (i >> 6)) & 0xFF;
+    }
+    const DesKey key(std::array<unsigned char, 8>{ 1, 2, 3, 4, 5, 6, 7, 8 });
+    const TripleDesKey key3(std::array<unsigned char, 24>{ 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17,
+                                                           18, 19, 20, 21, 22, 23, 24 });
+    std::vector<unsigned char> expected(input.size());
+    std::vector<unsigned char> result(input.size());
+    des_ecb_encrypt(std::span(input), std::span(expected), key);
+    des_ecb_encrypt_bitsliced(std::span(input), std::span(result), key);
+    REQUIRE(result == expected);
+    des_ecb_decrypt_bitsliced(std::span(result), std::span(result), key);
+    REQUIRE(result == input);
+
+    des3_ecb_encrypt_bitsliced(std::span(input), std::span(result), key3);
+    des3_ecb_decrypt_bitsliced(std::span(result), std::span(expected), key3);
+    REQUIRE(expected == input);
+    // first block against 3DES CBC with zero iv
+    std::vector<unsigned char> first(input.begin(), input.begin() + 8);
+    des3_cbc_encrypt(std::span(first), std::span(first), key3, {});
+    REQUIRE(std::equal(first.begin(), first.end(), result.begin()));
+
+    REQUIRE_THROWS_AS(des_ecb_encrypt_bitsliced(std::span(input).first(7), std::span(result).first(7), key),
+            std::runtime_error);
+}
+
+TEST_CASE("des cbc many")
+{
+    // more jobs than lanes, different lengths and keys, some empty
+    std::vector<std::vector<unsigned char>> inputs;
+    std::vector<TripleDesKey> keys;
+    std::vector<DesKey> single_keys;
+    std::vector<std::array<unsigned char, 8>> ivs;
+    for (size_t i = 0; i < 70; ++i)
+    {
+        auto &input = inputs.emplace_back(8 * ((i * 7) % 23));
+        for (size_t j = 0; j < input.size(); ++j)
+        {
+            input[j] = (i * 31 + j * 3) & 0xFF;
+        }
+        std::array<unsigned char, 24> key{};
+        for (size_t j = 0; j < key.size(); ++j)
+        {
+            key[j] = (i + 5 * j) & 0xFF;
+        }
+        keys.emplace_back(key);
+        std::array<unsigned char, 8> single_key{};
+        std::copy_n(key.begin() + 8, single_key.size(), single_key.begin());
+        single_keys.emplace_back(single_key);
+        ivs.push_back({ static_cast<unsigned char>(i), 1, 2, 3, 4, 5, 6, 7 });
+    }
+
+    auto buffers = inputs;
+    auto buffers3 = inputs;
+    std::vector<DesCbcJob<DesKey>> jobs;
+    std::vector<DesCbcJob<TripleDesKey>> jobs3;
+    for (size_t i = 0; i < inputs.size(); ++i)
+    {
+        jobs.push_back({ &single_keys[i], ivs[i], std::span(buffers[i]) });
+        jobs3.push_back({ &keys[i], ivs[i], std::span(buffers3[i]) });
+    }
+    des_cbc_encrypt_many(jobs);
+    des3_cbc_encrypt_many(jobs3);
+    for (size_t i = 0; i < inputs.size(); ++i)
+    {
+        std::vector<unsigned char> expected(inputs[i].size());
+        des_cbc_encrypt(std::span(inputs[i]), std::span(expected), single_keys[i], ivs[i]);
+        REQUIRE(buffers[i] == expected);
+        des3_cbc_encrypt(std::span(inputs[i]), std::span(expected), keys[i], ivs[i]);
+        REQUIRE(buffers3[i] == expected);
+        if (!expected.empty())
+        {
+            REQUIRE(std::equal(jobs3[i].iv.begin(), jobs3[i].iv.end(), expected.end() - 8));
+        }
+        jobs[i].iv = ivs[i];
+        jobs3[i].iv = ivs[i];
+    }
+
+    des_cbc_decrypt_many(jobs);
+    des3_cbc_decrypt_many(jobs3);
+    REQUIRE(buffers == inputs);
+    REQUIRE(buffers3 == inputs);
+}
+
+TEST_CASE("des key reuse")
+{
+    const DesKey key(std::array<unsigned char, 8>{ 0x13, 0x34, 0x57, 0x79, 0x9b, 0xbc, 0xdf, 0xf1 });
+    const std::array<unsigned char, 8> input{ 0x01, 0x23, 0x45, 0x67, 0x89, 0xab, 0xcd, 0xef };
+    std::array<unsigned char, 8> output{};
+    des_encrypt_block(input, output, key);
+    REQUIRE(hexStr(output.begin(), output.end()) == "85e813540f0ab405");
+    des_decrypt_block(output, output, key);
+    REQUIRE(output == input);
+
+    const std::string text = "abcdefghijklmnopqrstuvwxyz012345";
+    const std::vector<unsigned char> record(text.begin(), text.end());
+    const auto iv = std::array<unsigned char, 8>{ 0xa, 0xb, 0xc, 0xd, 0xe, 0xf, 0x1a, 0x1b };
+    const TripleDesKey key3(std::array<unsigned char, 24>{ 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17,
+                                                           18, 19, 20, 21, 22, 23, 24 });
+    for (int i = 0; i < 2; ++i)
+    {
+        auto buffer = record;
+        des3_cbc_encrypt(std::span(buffer), std::span(buffer), key3, iv);
+        REQUIRE(hexStr(buffer.begin(), buffer.end()) ==
+                "c02d3adbf2e8751c9de92f2a83363d94847731c634673f750a1cbab98238a63b");
+        des3_cbc_decrypt(std::span(buffer), std::span(buffer), key3, iv);
+        REQUIRE(buffer == record);
+    }
+}
@@ -0,0 +1,145 @@
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "file_hashing.hpp"
+#include "md5.hpp"
+#include "sha.hpp"
+
+/**
+ * Path in the temp directory that no other test run uses, process id plus a per process counter.
+ */
+std::filesystem::path unique_temp_path()
+{
+    static std::atomic<unsigned> counter{};
+    return std::filesystem::temp_directory_path() /
+           ("tls_playground_" + std::to_string(getpid()) + "_" + std::to_string(counter++) + ".bin");
+}
+
+/**
+ * File with given content, removed again when the test leaves its scope, also after a failed REQUIRE.
+ */
+class TemporaryFile
+{
+    std::filesystem::path path = unique_temp_path();
+public:
+    explicit TemporaryFile(const std::vector<unsigned char> &data)
+    {
+        std::ofstream file(path, std::ios::binary);
+        file.write(reinterpret_cast<const char *>(data.data()), static_cast<std::streamsize>(data.size()));
+    }
+
+    TemporaryFile(const TemporaryFile &) = delete;
+
+    TemporaryFile &operator=(const TemporaryFile &) = delete;
+
+    ~TemporaryFile()
+    {
+        std::error_code error;
+        std::filesystem::remove(path, error);
+    }
+
+    [[nodiscard]]
+    const std::filesystem::path &get_path() const
+    {
+        return path;
+    }
+};
+
+/**
+ * Named pipe in the temp directory, removed again when the test leaves its scope.
+ */
+class TemporaryFifo
+{
+    std::filesystem::path path = unique_temp_path();
+public:
+    TemporaryFifo()
+    {
+        if (::mkfifo(path.c_str(), 0600) != 0)
+        {
+            throw std::runtime_error("mkfifo failed");
+        }
+    }
+
+    TemporaryFifo(const TemporaryFifo &) = delete;
+
+    TemporaryFifo &operator=(const TemporaryFifo &) = delete;
+
+    ~TemporaryFifo()
+    {
+        std::error_code error;
+        std::filesystem::remove(path, error);
+    }
+
+    [[nodiscard]]
+    const std::filesystem::path &get_path() const
+    {
+        return path;
+    }
+};
+
+TEST_CASE("hash file")
+{
+    // regular files are memory mapped, the size is not block aligned
+    std::vector<unsigned char> data((1 << 20) + 1000);
+    for (size_t i = 0; i < data.size(); ++i)
+    {
+        data[i] = (i * 31 + i / 1000) & 0xFF;
+    }
+    const TemporaryFile file(data);
+    const auto &path = file.get_path();
+    const auto expected_sha256 = sha256_hash(data);
+    const auto expected_md5 = md5_hash(data);
+    REQUIRE(hash_file(path, HashAlgorithm::Sha256) == std::vector(expected_sha256.begin(), expected_sha256.end()));
+    REQUIRE(hash_file(path, HashAlgorithm::Md5) == std::vector(expected_md5.begin(), expected_md5.end()));
+    REQUIRE(hash_file(path, parse_hash_algorithm("sha512")).size() == 64);
+    REQUIRE_THROWS_AS(parse_hash_algorithm("sha3"), std::runtime_error);
+
+    // empty files can't be mapped and go through the read pipeline
+    const TemporaryFile empty_file({});
+    const auto &empty_path = empty_file.get_path();
+    const auto expected_empty = sha256_hash({});
+    REQUIRE(hash_file(empty_path, HashAlgorithm::Sha256) ==
+            std::vector(expected_empty.begin(), expected_empty.end()));
+
+    const auto missing_path = unique_temp_path();
+    REQUIRE_THROWS_AS(hash_file(missing_path, HashAlgorithm::Sha1), std::runtime_error);
+
+    const auto results = hash_files({ path, missing_path, empty_path, path }, HashAlgorithm::Sha256, 3);
+    REQUIRE(results.size() == 4);
+    REQUIRE(results[0].path == path);
+    REQUIRE(results[0].error.empty());
+    REQUIRE(results[0].digest == std::vector(expected_sha256.begin(), expected_sha256.end()));
+    REQUIRE(!results[1].error.empty());
+    REQUIRE(results[2].digest == std::vector(expected_empty.begin(), expected_empty.end()));
+    REQUIRE(results[3].digest == results[0].digest);
+}
+
+TEST_CASE("hash streamed file")
+{
+    // pipes are read through the pipeline: two full chunks and a partial one
+    std::vector<unsigned char> data((2 << 20) + 1000);
+    for (size_t i = 0; i < data.size(); ++i)
+    {
+        data[i] = (i * 17 + i / 4096) & 0xFF;
+    }
+    const TemporaryFifo fifo;
+    std::jthread writer([&fifo, &data]()
+    {
+        std::ofstream pipe(fifo.get_path(), std::ios::binary);
+        pipe.write(reinterpret_cast<const char *>(data.data()), static_cast<std::streamsize>(data.size()));
+    });
+    const auto digest = hash_file(fifo.get_path(), HashAlgorithm::Sha256);
+    const auto expected = sha256_hash(data);
+    REQUIRE(digest == std::vector(expected.begin(), expected.end()));
+}
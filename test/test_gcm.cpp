@@ -0,0 +1,119 @@
+#include <array>
+#include <stdexcept>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include "utils.hpp"
+#include "aes.hpp"
+#include "cpu_features.hpp"
+#include "gcm.hpp"
+
+TEST_CASE("aes gcm")
+{
+    const auto hardware = GENERATE(false, true);
+    const CpuFeaturesGuard guard;
+    cpu_features().aes = cpu_features().aes && hardware;
+    cpu_features().pclmul = cpu_features().pclmul && hardware;
+
+    SECTION("zero key")
+    {
+        // test cases 1 and 2 of the GCM specification
+        const AesGcm<128> gcm(std::array<unsigned char, 16>{});
+        const auto empty = gcm.encrypt({}, {}, {});
+        REQUIRE(hexStr(empty.begin(), empty.end()) == "58e2fccefa7e3061367f1d57a4e7455a");
+        const auto block = gcm.encrypt(std::vector<unsigned char>(16), {}, {});
+        REQUIRE(hexStr(block.begin(), block.end()) ==
+                "0388dace60b6a392f328c2b971b2fe78ab6e47d42cec13bdf53a67b21257bddf");
+        REQUIRE(gcm.decrypt(block, {}, {}) == std::vector<unsigned char>(16));
+    }
+
+    SECTION("additional data")
+    {
+        // test cases 3 and 4 of the GCM specification
+        const AesGcm<128> gcm(std::array<unsigned char, 16>{ 0xfe, 0xff, 0xe9, 0x92, 0x86, 0x65, 0x73, 0x1c,
+                                                             0x6d, 0x6a, 0x8f, 0x94, 0x67, 0x30, 0x83, 0x08 });
+        const std::array<unsigned char, 12> iv{ 0xca, 0xfe, 0xba, 0xbe, 0xfa, 0xce, 0xdb, 0xad,
+                                                0xde, 0xca, 0xf8, 0x88 };
+        auto input = from_hex("d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a72"
+                              "1c3c0c95956809532fcf0e2449a6b525b16aedf5aa0de657ba637b391aafd255");
+        const auto full = gcm.encrypt(input, iv, {});
+        REQUIRE(hexStr(full.begin(), full.end()) ==
+                "42831ec2217774244b7221b784d0d49ce3aa212f2c02a4e035c17e2329aca12e"
+                "21d514b25466931c7d8f6a5aac84aa051ba30b396a0aac973d58e091473f5985"
+                "4d5c2af327cd64a62cf35abd2ba6fab4");
+
+        input.resize(60);
+        const auto additional_data = from_hex("feedfacedeadbeeffeedfacedeadbeefabaddad2");
+        const auto partial = gcm.encrypt(input, iv, additional_data);
+        REQUIRE(hexStr(partial.begin(), partial.end()) ==
+                "42831ec2217774244b7221b784d0d49ce3aa212f2c02a4e035c17e2329aca12e"
+                "21d514b25466931c7d8f6a5aac84aa051ba30b396a0aac973d58e091"
+                "5bc94fbc3221a5db94fae95ae7121a47");
+        REQUIRE(gcm.decrypt(partial, iv, additional_data) == input);
+
+        auto tampered = partial;
+        tampered[3] ^= 1;
+        REQUIRE_THROWS_AS(gcm.decrypt(tampered, iv, additional_data), std::runtime_error);
+        REQUIRE_THROWS_AS(gcm.decrypt(partial, iv, {}), std::runtime_error);
+    }
+}
+
+TEST_CASE("aes gcm hardware and portable implementations agree")
+{
+    std::vector<unsigned char> input(10000);
+    for (size_t i = 0; i < input.size(); ++i)
+    {
+        input[i] = (i * 7 + (i >> 9)) & 0xFF;
+    }
+    const std::vector<unsigned char> additional_data(input.begin(), input.begin() + 77);
+    const std::array<unsigned char, 12> iv{ 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12 };
+    const std::array<unsigned char, 32> key{ 0xfe, 0xff, 0xe9, 0x92, 0x86, 0x65, 0x73, 0x1c };
+    const AesGcm<256> gcm(key);
+
+    const auto result = gcm.encrypt(input, iv, additional_data);
+    const CpuFeaturesGuard guard;
+    cpu_features().aes = false;
+    cpu_features().pclmul = false;
+    const auto portable = AesGcm<256>(key).encrypt(input, iv, additional_data);
+
+    REQUIRE(result == portable);
+    REQUIRE(gcm.decrypt(result, iv, additional_data) == input);
+}
+
+TEST_CASE("aes gcm bitsliced fallback")
+{
+    const CpuFeaturesGuard guard;
+    cpu_features().aes = false;
+    cpu_features().pclmul = false;
+    aes_fallback() = AesFallback::Bitsliced;
+
+    // test case 2 of the GCM specification
+    const AesGcm<128> zero_key_gcm(std::array<unsigned char, 16>{});
+    const auto block = zero_key_gcm.encrypt(std::vector<unsigned char>(16), {}, {});
+    REQUIRE(hexStr(block.begin(), block.end()) ==
+            "0388dace60b6a392f328c2b971b2fe78ab6e47d42cec13bdf53a67b21257bddf");
+
+    // test cases 3 and 4, several counter blocks and a partial last one
+    const AesGcm<128> gcm(std::array<unsigned char, 16>{ 0xfe, 0xff, 0xe9, 0x92, 0x86, 0x65, 0x73, 0x1c,
+                                                         0x6d, 0x6a, 0x8f, 0x94, 0x67, 0x30, 0x83, 0x08 });
+    const std::array<unsigned char, 12> iv{ 0xca, 0xfe, 0xba, 0xbe, 0xfa, 0xce, 0xdb, 0xad,
+                                            0xde, 0xca, 0xf8, 0x88 };
+    auto input = from_hex("d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a72"
+                          "1c3c0c95956809532fcf0e2449a6b525b16aedf5aa0de657ba637b391aafd255");
+    const auto full = gcm.encrypt(input, iv, {});
+    REQUIRE(hexStr(full.begin(), full.end()) ==
+            "42831ec2217774244b7221b784d0d49ce3aa212f2c02a4e035c17e2329aca12e"
+            "21d514b25466931c7d8f6a5aac84aa051ba30b396a0aac973d58e091473f5985"
+            "4d5c2af327cd64a62cf35abd2ba6fab4");
+    REQUIRE(gcm.decrypt(full, iv, {}) == input);
+
+    input.resize(60);
+    const auto additional_data = from_hex("feedfacedeadbeeffeedfacedeadbeefabaddad2");
+    const auto partial = gcm.encrypt(input, iv, additional_data);
+    REQUIRE(hexStr(partial.begin(), partial.end()) ==
+            "42831ec2217774244b7221b784d0d49ce3aa212f2c02a4e035c17e2329aca12e"
+            "21d514b25466931c7d8f6a5aac84aa051ba30b396a0aac973d58e091"
+            "5bc94fbc3221a5db94fae95ae7121a47");
+    REQUIRE(gcm.decrypt(partial, iv, additional_data) == input);
+}
@@ -1,7 +1,11 @@
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/generators/catch_generators.hpp>
 
+#include <algorithm>
+#include <span>
+#include <string>
 #include <utility>
+#include <vector>
 
 #include "utils.hpp"
 #include "hmac.hpp"
@@ -30,4 +34,37 @@ TEST_CASE("hmac_md5")
     CAPTURE(std::get<0>(task));
     const auto result = hmac_md5(std::get<0>(task), std::get<1>(task));
     REQUIRE(hexStr(result.begin(), result.end()) == std::get<2>(task));
-}
\ No newline at end of file
+}
+
+TEST_CASE("hmac context")
+{
+    // RFC 4231 test case 6, key longer than a block
+    const std::vector<unsigned char> long_key(131, 0xaa);
+    const std::string message = "Test Using Larger Than Block-Size Key - Hash Key First";
+    const std::vector<unsigned char> input(message.begin(), message.end());
+    HmacSha256 hmac_sha256_context(long_key);
+    for (size_t chunk: { 1, 7, 64 })
+    {
+        CAPTURE(chunk);
+        for (size_t i = 0; i < input.size(); i += chunk)
+        {
+            hmac_sha256_context.update(std::span(input).subspan(i, std::min(chunk, input.size() - i)));
+        }
+        // final starts the next message with the same key
+        const auto result = hmac_sha256_context.final();
+        REQUIRE(hexStr(result.begin(), result.end()) ==
+                "60e431591ee0b67f0d8a26aacbf5b77f8e0bc6213728c5140546040f0ee37f54");
+    }
+
+    // RFC 2202 test case 1
+    const std::vector<unsigned char> hi_there{ 'H', 'i', ' ', 'T', 'h', 'e', 'r', 'e' };
+    HmacSha1 hmac_sha1_context(std::vector<unsigned char>(20, 0x0b));
+    hmac_sha1_context.update(hi_there);
+    const auto sha1_result = hmac_sha1_context.final();
+    REQUIRE(hexStr(sha1_result.begin(), sha1_result.end()) == "b617318655057264e28bc0b6fb378c8ef146be00");
+
+    HmacMd5 hmac_md5_context(std::vector<unsigned char>(16, 0x0b));
+    hmac_md5_context.update(hi_there);
+    const auto md5_result = hmac_md5_context.final();
+    REQUIRE(hexStr(md5_result.begin(), md5_result.end()) == "9294727a3638bb1c13f48ef8158bfc9d");
+}
@@ -2,7 +2,9 @@
 #include <catch2/generators/catch_generators.hpp>
 
 #include <utility>
+#include <vector>
 
+#include "cpu_features.hpp"
 #include "utils.hpp"
 #include "md5.hpp"
 
@@ -25,4 +27,26 @@ TEST_CASE("md5_hash")
     CAPTURE(task.first);
     const auto result = md5_hash(task.first);
     REQUIRE(hexStr(result.begin(), result.end()) == task.second);
-}
\ No newline at end of file
+}
+
+TEST_CASE("md5 hashing")
+{
+    check_chunked_appends<Md5Hashing>(from_hex("c8f8db7fd1c5c14438e9dfd79fd8b644"));
+}
+
+TEST_CASE("md5 hash many")
+{
+    const CpuFeaturesGuard guard;
+    const auto hardware = cpu_features();
+    // avx-512 lanes, avx2 lanes, sse2 lanes
+    for (int backend = 0; backend < 3; ++backend)
+    {
+        CAPTURE(backend);
+        cpu_features().avx512 = hardware.avx512 && backend == 0;
+        cpu_features().avx2 = hardware.avx2 && backend <= 1;
+        check_hash_many(&md5_hash_many, [](const auto &input)
+        {
+            return md5_hash(input);
+        });
+    }
+}
@@ -0,0 +1,58 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <tuple>
+
+#include "montgomery.hpp"
+
+TEST_CASE("montgomery roundtrip")
+{
+    auto task = GENERATE(
+            std::make_pair(std::vector<unsigned char>{ 0x0D, 0x09 }, std::vector<unsigned char>{ 0x02, 0xB0 }),
+            std::make_pair(std::vector<unsigned char>{ 0xFF, 0xFF, 0xFF, 0xFF, 0xFF },
+                    std::vector<unsigned char>{ 0x12, 0x34, 0x56, 0x78, 0x9A }),
+            std::make_pair(std::vector<unsigned char>{ 0x0D, 0x09 }, std::vector<unsigned char>{})
+    );
+    CAPTURE(task.first, task.second);
+    const MontgomeryContext context{ BigNumber{ task.first }};
+    REQUIRE(context.from_montgomery(context.to_montgomery(BigNumber{ task.second })) == BigNumber{ task.second });
+}
+
+TEST_CASE("montgomery power_modulus")
+{
+    auto task = GENERATE(
+            std::make_tuple(std::vector<unsigned char>{ 0x02, 0xB0 }, std::vector<unsigned char>{ 0x4F },
+                    std::vector<unsigned char>{ 0x0D, 0x09 }),
+            std::make_tuple(std::vector<unsigned char>{ 0x7F, 0x12, 0x00, 0xA5, 0x33 },
+                    std::vector<unsigned char>{ 0x01, 0x00, 0x01 },
+                    std::vector<unsigned char>{ 0xC4, 0xF8, 0xE9, 0xE1, 0x5D, 0xCA, 0xDF, 0x2B, 0x97 }),
+            std::make_tuple(std::vector<unsigned char>{ 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF },
+                    std::vector<unsigned char>{ 0x8A, 0x7E, 0x79, 0xF3 },
+                    std::vector<unsigned char>{ 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xC5 }),
+            std::make_tuple(std::vector<unsigned char>{ 0x03 }, std::vector<unsigned char>{},
+                    std::vector<unsigned char>{ 0x0D, 0x09 })
+    );
+    CAPTURE(std::get<0>(task), std::get<1>(task), std::get<2>(task));
+    const BigNumber base{ std::get<0>(task) };
+    const BigNumber exp{ std::get<1>(task) };
+    const BigNumber modulus{ std::get<2>(task) };
+    const MontgomeryContext context{ modulus };
+    REQUIRE(context.power_modulus(base, exp) == base.power_modulus(exp, modulus));
+}
+
+TEST_CASE("montgomery even modulus")
+{
+    REQUIRE_THROWS(MontgomeryContext{ BigNumber{{ 0x0D, 0x08 }}});
+}
+
+TEST_CASE("montgomery power_modulus_short")
+{
+    auto exp = GENERATE(0u, 1u, 2u, 3u, 17u, 0x10001u, 0xFFFFFFFFu);
+    CAPTURE(exp);
+    const BigNumber base{{ 0x7F, 0x12, 0x00, 0xA5, 0x33 }};
+    const BigNumber modulus{{ 0xC4, 0xF8, 0xE9, 0xE1, 0x5D, 0xCA, 0xDF, 0x2B, 0x97 }};
+    const MontgomeryContext context{ modulus };
+    const BigNumber big_exp{{ static_cast<unsigned char>(exp >> 24), static_cast<unsigned char>(exp >> 16),
+                              static_cast<unsigned char>(exp >> 8), static_cast<unsigned char>(exp) }};
+    REQUIRE(context.power_modulus_short(base, exp) == base.power_modulus(big_exp, modulus));
+}
@@ -2,6 +2,8 @@
 #include <catch2/generators/catch_generators.hpp>
 
 #include "rsa.hpp"
+#include "utils.hpp"
+#include "x509.hpp"
 
 TEST_CASE("compute")
 {
@@ -48,4 +50,44 @@ TEST_CASE("encrypt_decrypt")
     CAPTURE(task);
     const auto cypher = rsa_encrypt(task, BigNumber{ public_key }, BigNumber{ modulus });
     REQUIRE(rsa_decrypt(cypher, BigNumber{ private_key }, BigNumber{ modulus }) == task);
-}
\ No newline at end of file
+}
+
+TEST_CASE("rsa public key")
+{
+    const RsaPublicKey key{ BigNumber{ modulus }, BigNumber{ public_key }};
+    const std::vector<unsigned char> task{ 'a', 'b', 'c' };
+    const auto cypher = rsa_encrypt(task, key);
+    REQUIRE(cypher == rsa_encrypt(task, BigNumber{ public_key }, BigNumber{ modulus }));
+    REQUIRE(rsa_decrypt(cypher, BigNumber{ private_key }, BigNumber{ modulus }) == task);
+}
+
+TEST_CASE("rsa public key cache")
+{
+    const auto file_data = read_file("resources/google.der");
+    const auto certificate = parse_certificate({ file_data.begin(), file_data.end() });
+    const auto &key_bytes = certificate.tbs_certificate.subject_public_key.key;
+    RsaPublicKeyCache cache{ 1 };
+    const auto key = cache.get(key_bytes);
+    REQUIRE(cache.get(key_bytes) == key);
+    REQUIRE(key->get_exponent() == BigNumber({ 0x01, 0x00, 0x01 }));
+    REQUIRE(key->get_modulus().bit_length() == 2048);
+
+    const auto file_data2 = read_file("resources/cert.der");
+    const auto certificate2 = parse_certificate({ file_data2.begin(), file_data2.end() });
+    const auto other_key = cache.get(certificate2.tbs_certificate.subject_public_key.key);
+    REQUIRE(other_key != key);
+    REQUIRE(cache.size() == 1);
+    REQUIRE(cache.get(key_bytes) != key);
+}
+
+TEST_CASE("rsa private key")
+{
+    const RsaPrivateKey key{ BigNumber{ modulus }, BigNumber{ private_key }, BigNumber{ public_key }};
+    const std::vector<unsigned char> task(100, 'a');
+    const auto cypher = rsa_encrypt(task, BigNumber{ public_key }, BigNumber{ modulus });
+    for (int i = 0; i < 3; ++i)
+    {
+        // blinding pair changes with every use
+        REQUIRE(rsa_decrypt(cypher, key) == task);
+    }
+}
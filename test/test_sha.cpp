@@ -1,8 +1,10 @@
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/generators/catch_generators.hpp>
 
+#include <algorithm>
 #include <utility>
 
+#include "cpu_features.hpp"
 #include "utils.hpp"
 #include "sha.hpp"
 
@@ -44,4 +46,153 @@ TEST_CASE("sha256_hash")
     CAPTURE(task.first);
     const auto result = sha256_hash(task.first);
     REQUIRE(hexStr(result.begin(), result.end()) == task.second);
-}
\ No newline at end of file
+}
+
+TEST_CASE("sha portable and sha extensions")
+{
+    // lengths around the padding boundaries and a multi block bulk input
+    const CpuFeaturesGuard guard;
+    const auto hardware_sha = cpu_features().sha;
+    for (size_t size: { 0, 1, 55, 56, 63, 64, 65, 119, 120, 1000 })
+    {
+        std::vector<unsigned char> input(size);
+        for (size_t i = 0; i < size; ++i)
+        {
+            input[i] = (i * 13 + size) & 0xFF;
+        }
+        CAPTURE(size);
+        cpu_features().sha = false;
+        const auto portable_sha256 = sha256_hash(input);
+        Sha1Hashing portable_sha1{};
+        portable_sha1.append(input);
+        const auto portable_sha1_hash = portable_sha1.close();
+        cpu_features().sha = hardware_sha;
+        REQUIRE(sha256_hash(input) == portable_sha256);
+        Sha1Hashing sha1{};
+        sha1.append(std::vector<unsigned char>(input.begin(), input.begin() + size / 3));
+        sha1.append(std::vector<unsigned char>(input.begin() + size / 3, input.end()));
+        REQUIRE(sha1.close() == portable_sha1_hash);
+    }
+
+    cpu_features().sha = false;
+    const auto million_a = std::vector<unsigned char>(1000000, 'a');
+    const auto portable = sha256_hash(million_a);
+    REQUIRE(hexStr(portable.begin(), portable.end()) ==
+            "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0");
+}
+
+TEST_CASE("sha256 hash many")
+{
+    const CpuFeaturesGuard guard;
+    const auto hardware = cpu_features();
+    // avx-512 lanes, sha extensions, avx2 lanes, sse2 lanes
+    for (int backend = 0; backend < 4; ++backend)
+    {
+        CAPTURE(backend);
+        cpu_features().avx512 = hardware.avx512 && backend == 0;
+        cpu_features().sha = hardware.sha && backend <= 1;
+        cpu_features().avx2 = hardware.avx2 && backend <= 2;
+        check_hash_many(&sha256_hash_many, [](const auto &input)
+        {
+            return sha256_hash(input);
+        });
+    }
+}
+
+TEST_CASE("sha256 hashing")
+{
+    check_chunked_appends<Sha256Hashing>(sha256_hash(make_hashing_input()));
+}
+
+TEST_CASE("sha midstate")
+{
+    const std::vector<unsigned char> prefix(128, 0x36);
+    const std::vector<unsigned char> first{ 'f', 'i', 'r', 's', 't' };
+    const std::vector<unsigned char> second(200, 's');
+
+    Sha256Hashing hashing{};
+    hashing.append(prefix);
+    const auto midstate = hashing.get_midstate();
+    for (const auto &suffix: { first, second })
+    {
+        Sha256Hashing resumed(midstate);
+        resumed.append(suffix);
+        auto message = prefix;
+        message.insert(message.end(), suffix.begin(), suffix.end());
+        REQUIRE(resumed.close() == sha256_hash(message));
+    }
+
+    Sha1Hashing sha1{};
+    sha1.append(prefix);
+    Sha1Hashing resumed_sha1(sha1.get_midstate());
+    resumed_sha1.append(first);
+    sha1.append(first);
+    REQUIRE(resumed_sha1.close() == sha1.close());
+
+    hashing.append(first);
+    REQUIRE_THROWS_AS(hashing.get_midstate(), std::runtime_error);
+    REQUIRE_THROWS_AS(Sha256Hashing({ midstate.state, 100 }), std::runtime_error);
+}
+
+TEST_CASE("sha512 family")
+{
+    const auto input = GENERATE(range(size_t{ 0 }, size_t{ 5 }));
+    const std::vector<std::vector<unsigned char>> messages{
+            {},
+            { 'a', 'b', 'c' },
+            std::vector<unsigned char>(111, 'a'),
+            std::vector<unsigned char>(112, 'a'),
+            std::vector<unsigned char>(1000, 'a')
+    };
+    const std::vector<std::array<std::string, 3>> expected{
+            {
+                    "38b060a751ac96384cd9327eb1b1e36a21fdb71114be07434c0cc7bf63f6e1da274edebfe76f65fbd51ad2f14898b95b",
+                    "cf83e1357eefb8bdf1542850d66d8007d620e4050b5715dc83f4a921d36ce9ce"
+                    "47d0d13c5d85f2b0ff8318d2877eec2f63b931bd47417a81a538327af927da3e",
+                    "c672b8d1ef56ed28ab87c3622c5114069bdd3ad7b8f9737498d0c01ecef0967a"
+            },
+            {
+                    "cb00753f45a35e8bb5a03d699ac65007272c32ab0eded1631a8b605a43ff5bed8086072ba1e7cc2358baeca134c825a7",
+                    "ddaf35a193617abacc417349ae20413112e6fa4e89a97ea20a9eeee64b55d39a"
+                    "2192992a274fc1a836ba3c23a3feebbd454d4423643ce80e2a9ac94fa54ca49f",
+                    "53048e2681941ef99b2e29b76b4c7dabe4c2d0c634fc6d46e0e2f13107e7af23"
+            },
+            {
+                    "3c37955051cb5c3026f94d551d5b5e2ac38d572ae4e07172085fed81f8466b8f90dc23a8ffcdea0b8d8e58e8fdacc80a",
+                    "fa9121c7b32b9e01733d034cfc78cbf67f926c7ed83e82200ef86818196921760"
+                    "b4beff48404df811b953828274461673c68d04e297b0eb7b2b4d60fc6b566a2",
+                    "0239e429f98d0ed61ee8e2a7c30afe98c1c3a80ce5dff62a107e9c538f7632ce"
+            },
+            {
+                    "187d4e07cb306103c69967bf544d0dfbe9042577599c73c330abc0cb64c61236d5ed565ee19119d8c31779a38f791fcd",
+                    "c01d080efd492776a1c43bd23dd99d0a2e626d481e16782e75d54c2503b5dc32"
+                    "bd05f0f1ba33e568b88fd2d970929b719ecbb152f58f130a407c8830604b70ca",
+                    "9216b5303edb66504570bee90e48ea5beaa5e9fe9f760bbd3e0460559fc005f6"
+            },
+            {
+                    "f54480689c6b0b11d0303285d9a81b21a93bca6ba5a1b4472765dca4da45ee328082d469c650cd3b61b16d3266ab8ced",
+                    "67ba5535a46e3f86dbfbed8cbbaf0125c76ed549ff8b0b9e03e0c88cf90fa634"
+                    "fa7b12b47d77b694de488ace8d9a65967dc96df599727d3292a8d9d447709c97",
+                    "40eb4a70d4d69815407a9e272f0101cd67e3d11262a4a0bfc087712749c7fb53"
+            }
+    };
+
+    const auto &message = messages[input];
+    CAPTURE(message.size());
+    const CpuFeaturesGuard guard;
+    const auto hardware_avx2 = cpu_features().avx2;
+    for (const bool avx2: { false, hardware_avx2 })
+    {
+        cpu_features().avx2 = avx2;
+        const auto sha384 = sha384_hash(message);
+        const auto sha512 = sha512_hash(message);
+        Sha512_256Hashing sha512_256{};
+        // split appends, so buffered and direct block paths both run
+        sha512_256.append(std::span(message).first(message.size() / 3));
+        sha512_256.append(std::span(message).subspan(message.size() / 3));
+        const auto truncated = sha512_256.close();
+        REQUIRE(hexStr(sha384.begin(), sha384.end()) == expected[input][0]);
+        REQUIRE(hexStr(sha512.begin(), sha512.end()) == expected[input][1]);
+        REQUIRE(hexStr(truncated.begin(), truncated.end()) == expected[input][2]);
+    }
+}
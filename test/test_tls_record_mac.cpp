@@ -0,0 +1,31 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <stdexcept>
+#include <vector>
+
+#include "utils.hpp"
+#include "tls_record_mac.hpp"
+
+TEST_CASE("tls record mac")
+{
+    const std::vector<unsigned char> secret(20, 0x0b);
+    TlsRecordMac send_mac(secret);
+    TlsRecordMac receive_mac(secret);
+    const std::vector<unsigned char> payload{ 'h', 'e', 'l', 'l', 'o' };
+
+    // hmac-sha1 over sequence number, type, version, length and payload
+    TlsRecord record{ TlsRecordType::ApplicationData, tls1_0_version, payload };
+    send_mac.append_mac(record);
+    REQUIRE(hexStr(record.payload.begin() + 5, record.payload.end()) == "79b99d1939262442b0e0c16bcdaebd7712b589ef");
+    receive_mac.verify_and_clear_mac(record);
+    REQUIRE(record.payload == payload);
+
+    // next sequence number changes the mac
+    send_mac.append_mac(record);
+    REQUIRE(hexStr(record.payload.begin() + 5, record.payload.end()) == "d351a2ab4e8c618befd963aa090a0c22db17fb77");
+    record.payload[0] ^= 1;
+    REQUIRE_THROWS_AS(receive_mac.verify_and_clear_mac(record), std::runtime_error);
+
+    TlsRecord short_record{ TlsRecordType::ApplicationData, tls1_0_version, payload };
+    REQUIRE_THROWS_AS(receive_mac.verify_and_clear_mac(short_record), std::runtime_error);
+}
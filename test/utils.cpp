@@ -1,4 +1,5 @@
 #include <fstream>
+#include <utility>
 
 #include "utils.hpp"
 
@@ -17,4 +18,39 @@ std::vector<char> read_file(const std::string &name)
         throw std::runtime_error("Failed to read " + name);
     }
     return result;
-}
\ No newline at end of file
+}
+
+std::vector<unsigned char> from_hex(const std::string &hex)
+{
+    std::vector<unsigned char> result;
+    for (size_t i = 0; i + 1 < hex.size(); i += 2)
+    {
+        result.push_back(static_cast<unsigned char>(std::stoi(hex.substr(i, 2), nullptr, 16)));
+    }
+    return result;
+}
+
+std::vector<unsigned char> make_hashing_input()
+{
+    std::vector<unsigned char> input(1000);
+    for (size_t i = 0; i < input.size(); ++i)
+    {
+        input[i] = (i * 11) & 0xFF;
+    }
+    return input;
+}
+
+std::vector<std::vector<unsigned char>> make_lane_inputs()
+{
+    std::vector<std::vector<unsigned char>> inputs;
+    for (size_t i = 0; i < 70; ++i)
+    {
+        std::vector<unsigned char> input((i * 37) % 300);
+        for (size_t j = 0; j < input.size(); ++j)
+        {
+            input[j] = (i + j * 7) & 0xFF;
+        }
+        inputs.push_back(std::move(input));
+    }
+    return inputs;
+}
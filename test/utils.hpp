@@ -1,11 +1,18 @@
 #ifndef TLS_PLAYGROUND_UTILS_HPP
 #define TLS_PLAYGROUND_UTILS_HPP
 
+#include <algorithm>
 #include <iomanip>
+#include <span>
 #include <sstream>
 #include <string>
 #include <vector>
 
+#include <catch2/catch_test_macros.hpp>
+
+#include "aes.hpp"
+#include "cpu_features.hpp"
+
 template<class InputIt>
 std::string hexStr(InputIt first, InputIt last)
 {
@@ -22,4 +29,81 @@ std::string hexStr(InputIt first, InputIt last)
 
 std::vector<char> read_file(const std::string &name);
 
+std::vector<unsigned char> from_hex(const std::string &hex);
+
+/**
+ * 1000 bytes, enough for several blocks of every hash and not block aligned.
+ */
+std::vector<unsigned char> make_hashing_input();
+
+/**
+ * Messages of uneven lengths, more of them than lanes, so multi-buffer lanes finish and refill at different steps.
+ */
+std::vector<std::vector<unsigned char>> make_lane_inputs();
+
+/**
+ * Appends make_hashing_input() in chunks smaller than, equal to and larger than a block, so both the buffered and
+ * the direct block path run. Every close must give expected, also after close started over.
+ */
+template<typename Hashing>
+void check_chunked_appends(std::span<const unsigned char> expected)
+{
+    const auto input = make_hashing_input();
+    for (size_t chunk: { 1, 7, 64, 100, 1000 })
+    {
+        CAPTURE(chunk);
+        Hashing hashing{};
+        for (size_t i = 0; i < input.size(); i += chunk)
+        {
+            hashing.append(std::span(input).subspan(i, std::min(chunk, input.size() - i)));
+        }
+        const auto result = hashing.close();
+        REQUIRE(std::ranges::equal(result, expected));
+        hashing.append(input);
+        const auto repeated = hashing.close();
+        REQUIRE(std::ranges::equal(repeated, expected));
+    }
+}
+
+/**
+ * Compares a multi-buffer hash with the single message one on make_lane_inputs() and on no messages at all.
+ */
+void check_hash_many(const auto &hash_many, const auto &hash_one)
+{
+    const auto inputs = make_lane_inputs();
+    const std::vector<std::span<const unsigned char>> messages(inputs.begin(), inputs.end());
+    const auto result = hash_many(messages);
+    REQUIRE(result.size() == inputs.size());
+    for (size_t i = 0; i < inputs.size(); ++i)
+    {
+        REQUIRE(result[i] == hash_one(inputs[i]));
+    }
+    REQUIRE(hash_many(std::span<const std::span<const unsigned char>>{}).empty());
+}
+
+/**
+ * Restores cpu_features() and aes_fallback() when the scope ends, so a failed REQUIRE in a test that switches
+ * hardware paths off doesn't leave them off for the following tests.
+ */
+class CpuFeaturesGuard
+{
+    CpuFeatures features;
+    AesFallback fallback;
+public:
+    CpuFeaturesGuard() : features(cpu_features()), fallback(aes_fallback())
+    {
+
+    }
+
+    CpuFeaturesGuard(const CpuFeaturesGuard &) = delete;
+
+    CpuFeaturesGuard &operator=(const CpuFeaturesGuard &) = delete;
+
+    ~CpuFeaturesGuard()
+    {
+        cpu_features() = features;
+        aes_fallback() = fallback;
+    }
+};
+
 #endif //TLS_PLAYGROUND_UTILS_HPP
@@ -0,0 +1,102 @@
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "file_hashing.hpp"
+
+struct Options
+{
+    HashAlgorithm algorithm = HashAlgorithm::Sha256;
+    size_t threads = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<std::filesystem::path> files;
+    /**
+     * Names as given on the command line, - stays - in the output.
+     */
+    std::vector<std::string> names;
+};
+
+void print_usage()
+{
+    std::cerr << "usage: tls-hash [-a md5|sha1|sha256|sha384|sha512] [-j threads] file..." << std::endl
+              << "  output has the format of sha256sum, - reads standard input" << std::endl;
+}
+
+bool parse_options(int argc, char *argv[], Options &options)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string argument = argv[i];
+        if (argument == "-a" && i + 1 < argc)
+        {
+            options.algorithm = parse_hash_algorithm(argv[++i]);
+        }
+        else if (argument == "-j" && i + 1 < argc)
+        {
+            options.threads = std::max(1, std::atoi(argv[++i]));
+        }
+        else if (argument == "-")
+        {
+            options.files.emplace_back("/dev/stdin");
+            options.names.push_back(argument);
+        }
+        else if (argument.starts_with("-"))
+        {
+            return false;
+        }
+        else
+        {
+            options.files.emplace_back(argument);
+            options.names.push_back(argument);
+        }
+    }
+    return !options.files.empty();
+}
+
+std::string to_hex(const std::vector<unsigned char> &digest)
+{
+    std::ostringstream result;
+    for (const auto byte: digest)
+    {
+        result << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(byte);
+    }
+    return result.str();
+}
+
+int main(int argc, char *argv[])
+{
+    Options options;
+    try
+    {
+        if (!parse_options(argc, argv, options))
+        {
+            print_usage();
+            return 1;
+        }
+    }
+    catch (const std::runtime_error &e)
+    {
+        std::cerr << "tls-hash: " << e.what() << std::endl;
+        print_usage();
+        return 1;
+    }
+    int status = 0;
+    const auto results = hash_files(options.files, options.algorithm, options.threads);
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        if (!results[i].error.empty())
+        {
+            std::cerr << "tls-hash: " << results[i].error << std::endl;
+            status = 1;
+            continue;
+        }
+        std::cout << to_hex(results[i].digest) << "  " << options.names[i] << std::endl;
+    }
+    return status;
+}